@@ -17,6 +17,8 @@
 # 比較:
 #   - Work-Stealing版: 動的負荷分散（3フェーズ修正なし）
 #   - Hybrid版: LocalHeap + Work-Stealing + 3フェーズ修正
+#   - ChaseLev版: Hybrid版のバイナリに --scheduler chaselev
+#       （ワーカーごとのChase-Lev deque、オーナーLIFO・盗む側FIFO、乱数で相手を選ぶ）
 #
 # 3フェーズ修正:
 #   フェーズ1: ルートタスク即座分割 - 初期並列性の確保
@@ -86,16 +88,17 @@ run_load_balance_test() {
     local solver_name="$1"
     local solver_bin="$2"
     local threads="$3"
+    local solver_args="${4:-}"  # 追加オプション（例: --scheduler chaselev）
 
-    log "  $solver_name - $threads スレッド"
+    log "  $solver_name - $threads スレッド ${solver_args}"
 
     local output_file="/tmp/exp5_${solver_name}_${threads}t_$$.txt"
 
     # ソルバー実行（詳細統計モードで、numactl対応）
     if command -v numactl &> /dev/null; then
-        numactl --interleave=all timeout $((TIME_LIMIT + 60)) "./$solver_bin" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v > "$output_file" 2>&1 || true
+        numactl --interleave=all timeout $((TIME_LIMIT + 60)) "./$solver_bin" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v $solver_args > "$output_file" 2>&1 || true
     else
-        timeout $((TIME_LIMIT + 60)) "./$solver_bin" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v > "$output_file" 2>&1 || true
+        timeout $((TIME_LIMIT + 60)) "./$solver_bin" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v $solver_args > "$output_file" 2>&1 || true
     fi
 
     # 全体統計のパース（Total行から抽出）
@@ -105,31 +108,32 @@ run_load_balance_test() {
         total_nodes=$(echo "$total_line" | awk '{print $2}')
     fi
     [ -z "$total_nodes" ] && total_nodes="0"
-    local steal_success=$(grep -i "steal.*success" "$output_file" | grep -oP '\d+' | head -1 || echo "0")
-    local steal_fail=$(grep -i "steal.*fail" "$output_file" | grep -oP '\d+' | head -1 || echo "0")
+    # スティール統計（--scheduler chaselev の "=== Chase-Lev Statistics ==="、hybridでは出力なし → 0）
+    # 行頭のタイムスタンプの数字を拾わないよう、ラベルの直後の数値だけを取る
+    local steal_success=$(grep -oP 'Steal success: \K[0-9]+' "$output_file" | head -1)
+    local steal_fail=$(grep -oP 'Steal fail: \K[0-9]+' "$output_file" | head -1)
+    [ -z "$steal_success" ] && steal_success="0"
+    [ -z "$steal_fail" ] && steal_fail="0"
 
     # スレッド別統計の抽出
-    # 出力フォーマット想定: "Thread X: nodes=Y, steals=Z, ..."
+    # 出力フォーマット: "[時刻] Worker X: N nodes, T tasks, idle I ms"（=== Worker Statistics ===）
+    # LocalHeap/スティールのワーカー別内訳は出力されないので 0 を記録する
     local -a thread_nodes=()
     local thread_id=0
+    local total_idle=0
 
     while IFS= read -r line; do
-        if [[ "$line" =~ Thread\ ([0-9]+):.*nodes=([0-9]+) ]]; then
+        if [[ "$line" =~ Worker\ ([0-9]+):\ ([0-9]+)\ nodes,\ ([0-9]+)\ tasks,\ idle\ ([0-9.]+)\ ms ]]; then
             thread_id="${BASH_REMATCH[1]}"
             local nodes="${BASH_REMATCH[2]}"
+            local tasks_stolen="${BASH_REMATCH[3]}"
+            local idle_time="${BASH_REMATCH[4]}"
             thread_nodes[$thread_id]=$nodes
+            total_idle=$(echo "$total_idle + $idle_time" | bc 2>/dev/null || echo "$total_idle")
 
-            # スレッド別の詳細統計を抽出
-            local local_pushes=$(echo "$line" | grep -oP 'local_push=\K[0-9]+' || echo "0")
-            local local_pops=$(echo "$line" | grep -oP 'local_pop=\K[0-9]+' || echo "0")
-            local steals_attempted=$(echo "$line" | grep -oP 'steal_attempt=\K[0-9]+' || echo "0")
-            local steals_succeeded=$(echo "$line" | grep -oP 'steal_success=\K[0-9]+' || echo "0")
-            local tasks_stolen=$(echo "$line" | grep -oP 'tasks_stolen=\K[0-9]+' || echo "0")
-            local idle_time=$(echo "$line" | grep -oP 'idle_ms=\K[0-9]+' || echo "0")
-
-            echo "$solver_name,$threads,$thread_id,$nodes,$local_pushes,$local_pops,$steals_attempted,$steals_succeeded,$tasks_stolen,$idle_time" >> "$CSV_PERTHREAD"
+            echo "$solver_name,$threads,$thread_id,$nodes,0,0,0,0,$tasks_stolen,$idle_time" >> "$CSV_PERTHREAD"
         fi
-    done < <(grep "^Thread" "$output_file")
+    done < <(grep -E "Worker [0-9]+: [0-9]+ nodes" "$output_file")
 
     # 負荷分散指標の計算
     local avg_nodes=0
@@ -191,18 +195,12 @@ run_load_balance_test() {
         steal_success_rate=$(echo "scale=2; $steal_success * 100 / $total_steals" | bc 2>/dev/null || echo "0")
     fi
 
-    # アイドル時間率（簡易推定）
+    # アイドル時間率（ワーカーがタスクを得られず待っていた時間の合計 / 全スレッドの実行時間）
     local total_time="0"
     if [ -n "$total_line" ]; then
         total_time=$(echo "$total_line" | awk '{print $5}')
     fi
     [ -z "$total_time" ] && total_time="0"
-    local total_idle=0
-    while IFS= read -r line; do
-        if [[ "$line" =~ idle_ms=([0-9]+) ]]; then
-            total_idle=$((total_idle + BASH_REMATCH[1]))
-        fi
-    done < <(grep "^Thread" "$output_file")
 
     local idle_percent=0
     if [ $(echo "$total_time > 0" | bc) -eq 1 ]; then
@@ -213,8 +211,8 @@ run_load_balance_test() {
 
     # 3フェーズ修正の効果測定用メトリクス
     # Worker稼働率
-    local total_workers=$(grep -E "Worker [0-9]+:" "$output_file" 2>/dev/null | wc -l)
-    local active_workers=$(grep -E "Worker [0-9]+: [0-9]+ nodes" "$output_file" 2>/dev/null | awk '{print $3}' | awk '$1 > 0' | wc -l)
+    local total_workers=$(grep -E "Worker [0-9]+: [0-9]+ nodes" "$output_file" 2>/dev/null | wc -l)
+    local active_workers=$(grep -oP "Worker [0-9]+: \K[0-9]+(?= nodes)" "$output_file" 2>/dev/null | awk '$1 > 0' | wc -l)
     local worker_util=0
     if [ "$total_workers" -gt 0 ] 2>/dev/null; then
         worker_util=$(echo "scale=1; $active_workers * 100 / $total_workers" | bc 2>/dev/null || echo "0")
@@ -239,7 +237,7 @@ run_load_balance_test() {
 # メイン実験ループ
 log_header "負荷分散評価実験開始"
 
-TOTAL_TESTS=$((${#THREAD_COUNTS[@]} * 2))
+TOTAL_TESTS=$((${#THREAD_COUNTS[@]} * 3))
 CURRENT_TEST=0
 
 for threads in "${THREAD_COUNTS[@]}"; do
@@ -254,6 +252,11 @@ for threads in "${THREAD_COUNTS[@]}"; do
     CURRENT_TEST=$((CURRENT_TEST + 1))
     log "[$CURRENT_TEST/$TOTAL_TESTS] Hybrid版"
     run_load_balance_test "Hybrid" "othello_endgame_solver_hybrid" "$threads"
+
+    # ChaseLev版（同じバイナリでスケジューラだけ切り替え）
+    CURRENT_TEST=$((CURRENT_TEST + 1))
+    log "[$CURRENT_TEST/$TOTAL_TESTS] ChaseLev版"
+    run_load_balance_test "ChaseLev" "othello_endgame_solver_hybrid" "$threads" "--scheduler chaselev"
 done
 
 # サマリーレポート生成
@@ -330,8 +333,15 @@ for threads in "${THREAD_COUNTS[@]}"; do
     hy_idle=$(awk -F',' -v t="$threads" '$1=="Hybrid" && $2==t {print $11}' "$CSV_OVERALL")
     hy_splits=$(awk -F',' -v t="$threads" '$1=="Hybrid" && $2==t {print $14}' "$CSV_OVERALL")
 
+    cl_cv=$(awk -F',' -v t="$threads" '$1=="ChaseLev" && $2==t {print $6}' "$CSV_OVERALL")
+    cl_ratio=$(awk -F',' -v t="$threads" '$1=="ChaseLev" && $2==t {print $7}' "$CSV_OVERALL")
+    cl_util=$(awk -F',' -v t="$threads" '$1=="ChaseLev" && $2==t {print $12}' "$CSV_OVERALL")
+    cl_idle=$(awk -F',' -v t="$threads" '$1=="ChaseLev" && $2==t {print $11}' "$CSV_OVERALL")
+    cl_splits=$(awk -F',' -v t="$threads" '$1=="ChaseLev" && $2==t {print $14}' "$CSV_OVERALL")
+
     printf "%-15s %-10s %-10s %-12s %-12s %-10s %-12s\n" "WorkStealing" "$threads" "$ws_cv" "$ws_ratio" "$ws_util" "$ws_idle" "$ws_splits" >> "$SUMMARY_FILE"
     printf "%-15s %-10s %-10s %-12s %-12s %-10s %-12s\n" "Hybrid" "$threads" "$hy_cv" "$hy_ratio" "$hy_util" "$hy_idle" "$hy_splits" >> "$SUMMARY_FILE"
+    printf "%-15s %-10s %-10s %-12s %-12s %-10s %-12s\n" "ChaseLev" "$threads" "$cl_cv" "$cl_ratio" "$cl_util" "$cl_idle" "$cl_splits" >> "$SUMMARY_FILE"
 done
 
 # 768コアでの詳細分析
@@ -343,6 +353,11 @@ ws_768_util=$(awk -F',' '$1=="WorkStealing" && $2==768 {print $12}' "$CSV_OVERAL
 hy_768_util=$(awk -F',' '$1=="Hybrid" && $2==768 {print $12}' "$CSV_OVERALL")
 hy_768_splits=$(awk -F',' '$1=="Hybrid" && $2==768 {print $14}' "$CSV_OVERALL")
 hy_768_subtasks=$(awk -F',' '$1=="Hybrid" && $2==768 {print $13}' "$CSV_OVERALL")
+cl_768_cv=$(awk -F',' '$1=="ChaseLev" && $2==768 {print $6}' "$CSV_OVERALL")
+cl_768_idle=$(awk -F',' '$1=="ChaseLev" && $2==768 {print $11}' "$CSV_OVERALL")
+cl_768_util=$(awk -F',' '$1=="ChaseLev" && $2==768 {print $12}' "$CSV_OVERALL")
+cl_768_steal_rate=$(awk -F',' '$1=="ChaseLev" && $2==768 {print $10}' "$CSV_OVERALL")
+cl_768_steals=$(awk -F',' '$1=="ChaseLev" && $2==768 {print $8}' "$CSV_OVERALL")
 
 cat >> "$SUMMARY_FILE" <<EOF
 
@@ -362,6 +377,12 @@ Hybrid版（3フェーズ修正適用）:
   ROOT SPLIT数: $hy_768_splits（フェーズ1）
   サブタスク数: $hy_768_subtasks（フェーズ2）
 
+ChaseLev版（--scheduler chaselev）:
+  変動係数 (CV): $cl_768_cv
+  Worker稼働率: ${cl_768_util}%
+  アイドル時間率: ${cl_768_idle}%
+  スティール成功数: $cl_768_steals（成功率 ${cl_768_steal_rate}%、失敗 = CAS競合負け）
+
 解釈:
   CVが小さく、Worker稼働率が高いほど、負荷分散が効果的。
   3フェーズ修正により、修正前と比較して大幅な稼働率向上を実現。
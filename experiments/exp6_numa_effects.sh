@@ -9,13 +9,15 @@
 #      - デフォルト（OS任せ）
 #      - 単一NUMAノード（384コア以下）
 #      - 全NUMAノード（768コア）
-#   2. リモートメモリアクセス率
+#   2. リモートメモリアクセス率（perf stat の node-loads / node-load-misses）
 #   3. NUMA間のタスクマイグレーション
+#   4. 評価関数の重みのNUMA複製（--eval-numa on）によるリモートアクセスの削減
 #
 # numactl コマンドを使用:
 #   - numactl --cpunodebind=0 : NUMA node 0に固定
 #   - numactl --cpunodebind=1 : NUMA node 1に固定
 #   - numactl --interleave=all : メモリをインターリーブ
+# replica ポリシーはデフォルト（OS任せ）に --eval-numa on を加えたもの
 #
 # 出力:
 #   - results/exp6_numa_effects.csv
@@ -67,6 +69,14 @@ numactl --hardware | tee -a "$LOG_FILE"
 NUMA_NODES=$(numactl --hardware | grep "available:" | awk '{print $2}')
 log "検出されたNUMAノード数: $NUMA_NODES"
 
+# perf の確認（リモートアクセス率の測定に使用、なければ 0 を記録）
+PERF_AVAILABLE=false
+if command -v perf &> /dev/null && perf stat -e node-loads,node-load-misses true > /dev/null 2>&1; then
+    PERF_AVAILABLE=true
+else
+    log "警告: perf の node-loads / node-load-misses が使えません。リモートアクセス率は 0 を記録します"
+fi
+
 # 実験パラメータ
 TIME_LIMIT=300
 EVAL_FILE="eval/eval.dat"
@@ -91,18 +101,24 @@ run_numa_test() {
     local numa_policy="$2"
     local numa_cmd="$3"
     local trial="$4"
+    local solver_args="$5"
 
     log "  試行 $trial: $threads スレッド, ポリシー: $numa_policy"
 
     local output_file="/tmp/exp6_${numa_policy}_${threads}t_${trial}_$$.txt"
+    local perf_file="/tmp/exp6_${numa_policy}_${threads}t_${trial}_$$.perf"
+    local perf_cmd=""
+    if [ "$PERF_AVAILABLE" = true ]; then
+        perf_cmd="perf stat -x , -e node-loads,node-load-misses -o $perf_file --"
+    fi
 
     # NUMA設定でソルバー実行
     local start_time=$(date +%s.%N)
 
     if [ -n "$numa_cmd" ]; then
-        timeout $((TIME_LIMIT + 60)) $numa_cmd "./othello_endgame_solver_hybrid" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v > "$output_file" 2>&1 || true
+        timeout $((TIME_LIMIT + 60)) $perf_cmd $numa_cmd "./othello_endgame_solver_hybrid" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v $solver_args > "$output_file" 2>&1 || true
     else
-        timeout $((TIME_LIMIT + 60)) "./othello_endgame_solver_hybrid" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v > "$output_file" 2>&1 || true
+        timeout $((TIME_LIMIT + 60)) $perf_cmd "./othello_endgame_solver_hybrid" "$TEST_POSITION" "$threads" "$TIME_LIMIT" "$EVAL_FILE" -v $solver_args > "$output_file" 2>&1 || true
     fi
 
     local end_time=$(date +%s.%N)
@@ -125,10 +141,17 @@ run_numa_test() {
     [ -z "$nodes" ] && nodes="0"
     [ -z "$nps" ] && nps="0"
 
-    # NUMA統計（perf stat やプログラム内部統計から取得）
-    # ここでは簡易的にダミー値を設定
-    local local_access=80
-    local remote_access=20
+    # NUMA統計（perf stat の node-loads: メモリへのロード、node-load-misses: そのうちリモートノードへのもの）
+    local local_access=0
+    local remote_access=0
+    if [ -f "$perf_file" ]; then
+        local node_loads=$(awk -F',' '$3 ~ /^node-loads/ {print $1}' "$perf_file")
+        local node_misses=$(awk -F',' '$3 ~ /^node-load-misses/ {print $1}' "$perf_file")
+        if [[ "$node_loads" =~ ^[0-9]+$ ]] && [[ "$node_misses" =~ ^[0-9]+$ ]] && [ "$node_loads" -gt 0 ]; then
+            remote_access=$(echo "scale=2; $node_misses * 100 / $node_loads" | bc)
+            local_access=$(echo "scale=2; 100 - $remote_access" | bc)
+        fi
+    fi
 
     # ベースライン時間の保存
     if [ "$threads" -eq 64 ] && [ "$numa_policy" == "default" ] && [ "$trial" -eq 1 ]; then
@@ -144,15 +167,15 @@ run_numa_test() {
     # CSV に追記
     echo "$threads,$numa_policy,$trial,$time_sec,$nodes,$nps,$local_access,$remote_access,$speedup" >> "$CSV_FILE"
 
-    log "    時間: ${time_sec}s, NPS: $nps, Speedup: ${speedup}x"
+    log "    時間: ${time_sec}s, NPS: $nps, Speedup: ${speedup}x, リモートアクセス: ${remote_access}%"
 
-    rm -f "$output_file"
+    rm -f "$output_file" "$perf_file"
 }
 
 # メイン実験ループ
 log_header "NUMA実験開始"
 
-TOTAL_TESTS=$((${#THREAD_COUNTS[@]} * 4 * TRIALS))  # 4つのNUMAポリシー
+TOTAL_TESTS=$((${#THREAD_COUNTS[@]} * 5 * TRIALS))  # 5つのNUMAポリシー
 CURRENT_TEST=0
 
 for threads in "${THREAD_COUNTS[@]}"; do
@@ -191,6 +214,13 @@ for threads in "${THREAD_COUNTS[@]}"; do
         log "[$CURRENT_TEST/$TOTAL_TESTS] メモリインターリーブ"
         run_numa_test "$threads" "interleave" "numactl --interleave=all" "$trial"
     done
+
+    # 5. 評価関数の重みをNUMAノードごとに複製（OS任せのスケジューリング）
+    for trial in $(seq 1 $TRIALS); do
+        CURRENT_TEST=$((CURRENT_TEST + 1))
+        log "[$CURRENT_TEST/$TOTAL_TESTS] 重みのNUMA複製（--eval-numa on）"
+        run_numa_test "$threads" "replica" "" "$trial" "--eval-numa on"
+    done
 done
 
 # サマリーレポート生成
@@ -223,6 +253,11 @@ NUMAポリシーの説明
    - メリット: メモリ帯域を最大活用
    - デメリット: リモートアクセスが増加
 
+4. replica (評価関数の重みのNUMA複製):
+   デフォルトに --eval-numa on を加え、各ワーカーが自ノードの重みの複製を読む
+   - メリット: 評価のたびの重み表（27 MB）へのリモートアクセスがなくなる
+   - デメリット: ノード数 × 27 MB のメモリ
+
 ----------------------------------------
 NUMA性能比較
 ----------------------------------------
@@ -231,13 +266,14 @@ NUMA性能比較
 
 EOF
 
-printf "%-10s %-15s %-15s %-15s %-15s\n" "Threads" "Default" "Node0" "Interleave" "Best" >> "$SUMMARY_FILE"
+printf "%-10s %-15s %-15s %-15s %-15s %-15s\n" "Threads" "Default" "Node0" "Interleave" "Replica" "Best" >> "$SUMMARY_FILE"
 echo "--------------------------------------------------------------------------------" >> "$SUMMARY_FILE"
 
 for threads in "${THREAD_COUNTS[@]}"; do
     def_time=$(awk -F',' -v t="$threads" '$1==t && $2=="default" {sum+=$4; count++} END {if(count>0) printf "%.3f", sum/count; else print "-"}' "$CSV_FILE")
     n0_time=$(awk -F',' -v t="$threads" '$1==t && $2=="node0" {sum+=$4; count++} END {if(count>0) printf "%.3f", sum/count; else print "-"}' "$CSV_FILE")
     int_time=$(awk -F',' -v t="$threads" '$1==t && $2=="interleave" {sum+=$4; count++} END {if(count>0) printf "%.3f", sum/count; else print "-"}' "$CSV_FILE")
+    rep_time=$(awk -F',' -v t="$threads" '$1==t && $2=="replica" {sum+=$4; count++} END {if(count>0) printf "%.3f", sum/count; else print "-"}' "$CSV_FILE")
 
     # 最良を特定
     best="default"
@@ -253,7 +289,30 @@ for threads in "${THREAD_COUNTS[@]}"; do
         best_time="$int_time"
     fi
 
-    printf "%-10s %-15s %-15s %-15s %-15s\n" "$threads" "${def_time}s" "${n0_time}s" "${int_time}s" "$best" >> "$SUMMARY_FILE"
+    if [ "$rep_time" != "-" ] && [ $(echo "$rep_time < $best_time" | bc 2>/dev/null || echo 0) -eq 1 ]; then
+        best="replica"
+        best_time="$rep_time"
+    fi
+
+    printf "%-10s %-15s %-15s %-15s %-15s %-15s\n" "$threads" "${def_time}s" "${n0_time}s" "${int_time}s" "${rep_time}s" "$best" >> "$SUMMARY_FILE"
+done
+
+cat >> "$SUMMARY_FILE" <<EOF
+
+スレッド数別 平均リモートアクセス率（perf の node-load-misses / node-loads）:
+
+EOF
+
+printf "%-10s %-15s %-15s %-15s %-15s\n" "Threads" "Default" "Node0" "Interleave" "Replica" >> "$SUMMARY_FILE"
+echo "--------------------------------------------------------------------------------" >> "$SUMMARY_FILE"
+
+for threads in "${THREAD_COUNTS[@]}"; do
+    row=""
+    for policy in default node0 interleave replica; do
+        remote=$(awk -F',' -v t="$threads" -v p="$policy" '$1==t && $2==p {sum+=$8; count++} END {if(count>0) printf "%.2f%%", sum/count; else print "-"}' "$CSV_FILE")
+        row="$row$(printf "%-15s " "$remote")"
+    done
+    printf "%-10s %s\n" "$threads" "$row" >> "$SUMMARY_FILE"
 done
 
 # 768コアでの詳細分析
@@ -0,0 +1,143 @@
+#!/bin/bash
+################################################################################
+# expI_engine_compare.sh - 実験I: 木ありdf-pn vs TTのみdf-pn（--engine tree|tt）
+#
+# 目的: 明示的な探索木を保持するエンジンと、木を持たずTTだけで
+#       pn/dnを保持する深さ優先df-pnエンジンの比較
+#
+# 測定項目:
+#   1. NPS（ノード/秒）
+#   2. ワーカーあたりのピーク生存ノード数（tt: 再帰パス上の子ノード数）
+#   3. ピークノードメモリ（peak_live_nodes × node_bytes）
+#   4. 総ノード数・解けた問題数・TTヒット率
+#
+# 出力:
+#   - results/expI_engine_compare.csv
+#   - results/expI_summary.txt
+#
+# 推定実行時間: 1-3時間（空きマス数・スレッド数に依存）
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expI_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expI_engine_compare.csv"
+SUMMARY_FILE="$RESULTS_DIR/expI_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験I: df-pnエンジン比較（tree vs tt）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+ENGINES=(tree tt)
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<EOF
+Engine,Empties,Position,Result,Nodes,Time_Sec,NPS,Peak_Live_Nodes,Node_Bytes,Peak_Node_MB,TT_Hit_Rate
+EOF
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for engine in "${ENGINES[@]}"; do
+            log_file="$LOG_DIR/${engine}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${engine}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --engine "$engine" -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            peak=$(json_value "$json_file" "peak_live_nodes")
+            node_bytes=$(json_value "$json_file" "node_bytes")
+            hit_rate=$(json_value "$json_file" "hit_rate")
+            peak_mb=$(echo "scale=2; $peak * $node_bytes / 1048576" | bc 2>/dev/null || echo "0")
+
+            echo "$engine,$empties,$file_id,$result,$nodes,$time_sec,$nps,$peak,$node_bytes,$peak_mb,$hit_rate" >> "$CSV_FILE"
+            log "  [$engine] e${empties} id${file_id}: $result, NPS=$nps, peak=$peak nodes (${peak_mb} MB)"
+        done
+    done
+done
+
+# サマリー（エンジン・空きマス別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験I: df-pnエンジン比較（tree vs tt）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒"
+    echo ""
+    printf "%-6s %-8s %-8s %-14s %-14s %-12s\n" "Engine" "Empties" "Solved" "Avg_NPS" "Avg_Peak" "Avg_Peak_MB"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nps[k] += $7; peak[k] += $8; mb[k] += $10
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-6s %-8s %-8s %-14.0f %-14.0f %-12.2f\n", a[1], a[2], solved[k] + 0 "/" n[k], nps[k] / n[k], peak[k] / n[k], mb[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,148 @@
+#!/bin/bash
+################################################################################
+# expJ_threshold_epsilon.sh - 実験J: 1+ε しきい値によるスラッシング削減（--epsilon）
+#
+# 目的: 子のしきい値を 2番手の (1+ε) 倍まで広げることで、pn/dnが拮抗する
+#       兄弟間の往復（sibling switch）と再展開がどれだけ減るかを測定
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 兄弟切り替え回数（合計 / ノードあたり最大）
+#   3. 再展開回数（TTに未証明値が残っていた局面の展開）
+#
+# 比較: legacy（ε<0, 従来しきい値）, ε = 0, 0.125, 0.25, 0.5, 1.0
+#       各εを tree / tt 両エンジンで測定
+#
+# 出力:
+#   - results/expJ_threshold_epsilon.csv
+#   - results/expJ_summary.txt
+#
+# 推定実行時間: 4-8時間（18-24空き × 6ε × 2エンジン）
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expJ_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expJ_threshold_epsilon.csv"
+SUMMARY_FILE="$RESULTS_DIR/expJ_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験J: 1+ε しきい値（--epsilon）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-18 20 22 24})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+ENGINES=(${ENGINES:-tree tt})
+EPSILONS=(${EPSILONS:--1 0 0.125 0.25 0.5 1.0})
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<EOF
+Engine,Epsilon,Empties,Position,Result,Nodes,Time_Sec,NPS,Sibling_Switches,Max_Switches_Per_Node,Reexpansions
+EOF
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for engine in "${ENGINES[@]}"; do
+        for eps in "${EPSILONS[@]}"; do
+            log_file="$LOG_DIR/${engine}_eps${eps}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${engine}_eps${eps}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --engine "$engine" --epsilon "$eps" -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            switches=$(json_value "$json_file" "sibling_switches")
+            max_switches=$(json_value "$json_file" "max_switches_per_node")
+            reexp=$(json_value "$json_file" "reexpansions")
+
+            echo "$engine,$eps,$empties,$file_id,$result,$nodes,$time_sec,$nps,$switches,$max_switches,$reexp" >> "$CSV_FILE"
+            log "  [$engine eps=$eps] e${empties} id${file_id}: $result, nodes=$nodes, switches=$switches, reexp=$reexp"
+        done
+        done
+    done
+done
+
+# サマリー（エンジン・空きマス別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験J: 1+ε しきい値（--epsilon）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒"
+    echo "（ε<0 は従来しきい値。ttエンジンでは ε=0 と同じ）"
+    echo ""
+    printf "%-6s %-8s %-8s %-8s %-14s %-14s %-14s\n" "Engine" "Epsilon" "Empties" "Solved" "Avg_Nodes" "Avg_Switches" "Avg_Reexp"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2 "," $3
+        n[k]++
+        if ($5 != "UNKNOWN" && $5 != "0") solved[k]++
+        nodes[k] += $6; sw[k] += $9; re[k] += $11
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-6s %-8s %-8s %-8s %-14.0f %-14.0f %-14.0f\n", a[1], a[2], a[3], solved[k] + 0 "/" n[k], nodes[k] / n[k], sw[k] / n[k], re[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k3,3n -k1,1 -k2,2g
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
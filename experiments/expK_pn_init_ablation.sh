@@ -0,0 +1,154 @@
+#!/bin/bash
+################################################################################
+# expK_pn_init_ablation.sh - 実験K: 葉のpn/dn初期化（df-pn+）のアブレーション
+#
+# 目的: 新しい葉の pn/dn を 1 ではなく合法手数・評価値から初期化した場合に、
+#       空きマス数ごとに総ノード数がどれだけ減るかを測定（--pn-init）
+#
+# 比較: unit（従来: pn = dn = 1）, mobility, eval, mobility+eval
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. unit に対するノード数の削減率（同じ問題・同じエンジン設定で比較）
+#
+# 出力:
+#   - results/expK_pn_init_ablation.csv
+#   - results/expK_summary.txt
+#
+# 推定実行時間: 3-6時間（5空きマス帯 × 4問 × 4方式）
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expK_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expK_pn_init_ablation.csv"
+SUMMARY_FILE="$RESULTS_DIR/expK_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験K: 葉のpn/dn初期化アブレーション（--pn-init）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18 20 22})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+PN_INITS=(${PN_INITS:-unit mobility eval mobility+eval})
+# 全方式に共通の追加オプション（例: "--engine tt --epsilon 0.25"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<EOF
+PN_Init,Empties,Position,Result,Nodes,Time_Sec,NPS
+EOF
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for init in "${PN_INITS[@]}"; do
+            tag=$(echo "$init" | tr '+' '_')
+            log_file="$LOG_DIR/${tag}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${tag}_e${empties}_id${file_id}.json"
+
+            # 評価関数を全域で使う（既定の終盤用の順序付けでは評価関数を呼ばない）
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --pn-init "$init" --endgame-order 0 $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+
+            echo "$init,$empties,$file_id,$result,$nodes,$time_sec,$nps" >> "$CSV_FILE"
+            log "  [$init] e${empties} id${file_id}: $result, nodes=$nodes, time=${time_sec}s"
+        done
+    done
+done
+
+# サマリー（エンジン・空きマス別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験K: 葉のpn/dn初期化アブレーション（--pn-init）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo "（削減率は両方式とも解けた問題のみで unit と比較）"
+    echo ""
+    printf "%-14s %-8s %-8s %-14s %-12s\n" "PN_Init" "Empties" "Solved" "Avg_Nodes" "Reduction_%"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        ok = ($4 != "UNKNOWN" && $4 != "0")
+        if (ok) solved[k]++
+        nodes[k] += $5
+        if (ok) solved_nodes[$1 "," $2 "," $3] = $5
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            base = 0; cur = 0
+            for (p in solved_nodes) {
+                split(p, b, ",")
+                if (b[1] != a[1] || b[2] != a[2]) continue
+                u = "unit," b[2] "," b[3]
+                if (u in solved_nodes) { base += solved_nodes[u]; cur += solved_nodes[p] }
+            }
+            red = (base > 0) ? (1 - cur / base) * 100 : 0
+            printf "%-14s %-8s %-8s %-14.0f %-12.1f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], red
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
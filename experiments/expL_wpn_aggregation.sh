@@ -0,0 +1,147 @@
+#!/bin/bash
+################################################################################
+# expL_wpn_aggregation.sh - 実験L: WPN集約 × ワークスティーリング並列の頑健性
+#
+# 目的: Hybrid版（ワークスティーリング + 共有TT）の update_pn_dn で和の代わりに
+#       Weak Proof Number（max + 未解決数 - 1）を使った場合の解探索時間と
+#       ばらつき（CV）を比較（--aggregate classic|wpn|hybrid）
+#
+# 背景: WPNS単体版は 06_robustness.csv で CV 0.34（Hybrid版 0.62）
+#
+# 測定項目（06_robustness.csv と同じ列）:
+#   Count, Avg_Time, StdDev_Time, CV, Min_Time, Max_Time, MaxMin_Ratio
+#   ＋ 平均ノード数・解けた問題数
+#
+# 出力:
+#   - results/expL_wpn_aggregation.csv（1実行1行）
+#   - results/expL_robustness.csv（集約方式 × 空きマス別の統計）
+#
+# 推定実行時間: 2-5時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expL_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expL_wpn_aggregation.csv"
+SUMMARY_FILE="$RESULTS_DIR/expL_robustness.csv"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験L: WPN集約 × ワークスティーリング（--aggregate）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-12 14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-5}"
+AGGREGATIONS=(${AGGREGATIONS:-classic wpn hybrid})
+# 全方式に共通の追加オプション（例: "--epsilon 0.25 --agg-hybrid-empties 14"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<EOF
+Aggregation,Empties,Position,Result,Nodes,Time_Sec,NPS
+EOF
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for agg in "${AGGREGATIONS[@]}"; do
+            log_file="$LOG_DIR/${agg}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${agg}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --aggregate "$agg" $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+
+            echo "$agg,$empties,$file_id,$result,$nodes,$time_sec,$nps" >> "$CSV_FILE"
+            log "  [$agg] e${empties} id${file_id}: $result, nodes=$nodes, time=${time_sec}s"
+        done
+    done
+done
+
+# 頑健性統計（06_robustness.csv と同じ形式、解けた問題のみ）
+log_header "頑健性統計の作成"
+
+{
+    echo "Solver,Empties,Count,Avg_Time,StdDev_Time,CV,Min_Time,Max_Time,MaxMin_Ratio,Avg_Nodes,Solved"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        total[k]++
+        if ($4 == "UNKNOWN" || $4 == "0") next
+        n[k]++; t[k] += $6; tt[k] += $6 * $6; nodes[k] += $5
+        if (!(k in mn) || $6 < mn[k]) mn[k] = $6
+        if (!(k in mx) || $6 > mx[k]) mx[k] = $6
+    }
+    END {
+        for (k in total) {
+            split(k, a, ",")
+            if (n[k] == 0) { printf "Hybrid-%s,%s,0,0,0,0,0,0,0,0,0/%d\n", a[1], a[2], total[k]; continue }
+            avg = t[k] / n[k]
+            var = tt[k] / n[k] - avg * avg; if (var < 0) var = 0
+            sd = sqrt(var)
+            cv = (avg > 0) ? sd / avg : 0
+            ratio = (mn[k] > 0) ? mx[k] / mn[k] : 0
+            printf "Hybrid-%s,%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.0f,%d/%d\n", a[1], a[2], n[k], avg, sd, cv, mn[k], mx[k], ratio, nodes[k] / n[k], n[k], total[k]
+        }
+    }' "$CSV_FILE" | sort -t',' -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,151 @@
+#!/bin/bash
+################################################################################
+# expM_dpn_selection.sh - 実験M: Deep Proof Number 選択 × ワークスティーリング
+#
+# 目的: 深さに偏った子選択（DPN, --dpn-r R）が、同じTT・同じスケジューラの
+#       並列Hybrid版で探索の往復（sibling switch）と再展開を減らすかを測定
+#       （逐次の Deep_Pns_benchmark.c ではなく、同じ並列エンジン内で比較）
+#
+# 比較: off（従来の選択）, R = 1.0, 0.75, 0.5, 0.25, 0.0
+#       × スレッド数（並列度による往復の増減も見る）
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 兄弟切り替え回数（合計 / ノードあたり最大）
+#   3. 再展開回数
+#
+# 出力:
+#   - results/expM_dpn_selection.csv
+#   - results/expM_summary.txt
+#
+# 推定実行時間: 4-8時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expM_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expM_dpn_selection.csv"
+SUMMARY_FILE="$RESULTS_DIR/expM_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験M: Deep Proof Number 選択（--dpn-r）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS_LIST=(${THREADS_LIST:-4 16 64})
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+DPN_RS=(${DPN_RS:-off 1.0 0.75 0.5 0.25 0.0})
+# 全設定に共通の追加オプション（例: "--epsilon 0.25"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<EOF
+DPN_R,Threads,Empties,Position,Result,Nodes,Time_Sec,NPS,Sibling_Switches,Max_Switches_Per_Node,Reexpansions
+EOF
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for threads in "${THREADS_LIST[@]}"; do
+        for r in "${DPN_RS[@]}"; do
+            log_file="$LOG_DIR/r${r}_t${threads}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/r${r}_t${threads}_e${empties}_id${file_id}.json"
+            dpn_args=""
+            [ "$r" != "off" ] && dpn_args="--dpn-r $r"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$threads" "$TIME_LIMIT" "$EVAL_FILE" \
+                $dpn_args $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            switches=$(json_value "$json_file" "sibling_switches")
+            max_switches=$(json_value "$json_file" "max_switches_per_node")
+            reexp=$(json_value "$json_file" "reexpansions")
+
+            echo "$r,$threads,$empties,$file_id,$result,$nodes,$time_sec,$nps,$switches,$max_switches,$reexp" >> "$CSV_FILE"
+            log "  [R=$r t=$threads] e${empties} id${file_id}: $result, nodes=$nodes, switches=$switches, reexp=$reexp"
+        done
+        done
+    done
+done
+
+# サマリー（R・スレッド数・空きマス別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験M: Deep Proof Number 選択（--dpn-r）"
+    echo "スレッド数: ${THREADS_LIST[*]}, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    printf "%-6s %-8s %-8s %-8s %-14s %-14s %-14s\n" "DPN_R" "Threads" "Empties" "Solved" "Avg_Nodes" "Avg_Switches" "Avg_Reexp"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2 "," $3
+        n[k]++
+        if ($5 != "UNKNOWN" && $5 != "0") solved[k]++
+        nodes[k] += $6; sw[k] += $9; re[k] += $11
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-6s %-8s %-8s %-8s %-14.0f %-14.0f %-14.0f\n", a[1], a[2], a[3], solved[k] + 0 "/" n[k], nodes[k] / n[k], sw[k] / n[k], re[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k3,3n -k1,1 -k2,2g
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,153 @@
+#!/bin/bash
+################################################################################
+# expN_exact_score.sh - 実験N: 石差の完全解析（--exact）のグループ数比較
+#
+# 目的: 最終石差を null-window「石差 >= k」証明の繰り返しで求めるとき、
+#       同時に証明するしきい値の数（ワーカーグループ数, --exact-groups）で
+#       総時間・総ノード数・必要なしきい値の数がどう変わるかを測定
+#       （グループはTTを共有し、スレッドは等分する）
+#
+# 比較: グループ数 1, 2, 3, 4 × スレッド数
+#
+# 測定項目:
+#   1. 求めた石差・最善手（全グループ数で一致するか）
+#   2. 総時間・総ノード数
+#   3. ラウンド数・しきい値（証明）の数
+#
+# 出力:
+#   - results/expN_exact_score.csv
+#   - results/expN_summary.txt
+#   - しきい値ごとの時間・ノード数は各ログディレクトリの JSON（"exact" → "thresholds"）
+#
+# 推定実行時間: 3-6時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expN_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expN_exact_score.csv"
+SUMMARY_FILE="$RESULTS_DIR/expN_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験N: 石差の完全解析（--exact）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS_LIST=(${THREADS_LIST:-4 16 64})
+TIME_LIMIT="${TIME_LIMIT:-300.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+GROUPS_LIST=(${GROUPS_LIST:-1 2 3 4})
+# 全設定に共通の追加オプション（例: "--engine tt"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Groups,Threads,Empties,Position,Score,Lower,Upper,Best_Move,Rounds,Thresholds,Nodes,Time_Sec,NPS,TT_Hit_Rate
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for threads in "${THREADS_LIST[@]}"; do
+        for groups in "${GROUPS_LIST[@]}"; do
+            log_file="$LOG_DIR/g${groups}_t${threads}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/g${groups}_t${threads}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$threads" "$TIME_LIMIT" "$EVAL_FILE" \
+                --exact --exact-groups "$groups" $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            score=$(json_value "$json_file" "score")
+            lower=$(json_value "$json_file" "lower")
+            upper=$(json_value "$json_file" "upper")
+            best_move=$(json_value "$json_file" "best_move")
+            rounds=$(json_value "$json_file" "rounds")
+            thresholds=$(grep -c '"round":' "$json_file" 2>/dev/null || true)
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            hit_rate=$(json_value "$json_file" "hit_rate")
+
+            echo "$groups,$threads,$empties,$file_id,$score,$lower,$upper,$best_move,$rounds,${thresholds:-0},$nodes,$time_sec,$nps,$hit_rate" >> "$CSV_FILE"
+            log "  [groups=$groups t=$threads] e${empties} id${file_id}: score=$score [$lower, $upper], thresholds=${thresholds:-0}, time=${time_sec}s"
+        done
+        done
+    done
+done
+
+# サマリー（グループ数・スレッド数・空きマス別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験N: 石差の完全解析（--exact）"
+    echo "スレッド数: ${THREADS_LIST[*]}, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    printf "%-8s %-8s %-8s %-8s %-12s %-14s %-12s\n" "Groups" "Threads" "Empties" "Solved" "Avg_Time" "Avg_Nodes" "Avg_Queries"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2 "," $3
+        n[k]++
+        if ($6 == $7) solved[k]++
+        t[k] += $12; nodes[k] += $11; q[k] += $10
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-8s %-8s %-8s %-8s %-12.3f %-14.0f %-12.1f\n", a[1], a[2], a[3], solved[k] + 0 "/" n[k], t[k] / n[k], nodes[k] / n[k], q[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k3,3n -k2,2n -k1,1n
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
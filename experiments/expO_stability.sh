@@ -0,0 +1,169 @@
+#!/bin/bash
+################################################################################
+# expO_stability.sh - 実験O: 確定石による早期証明（--stability on|off）
+#
+# 目的: 展開前に確定石の数だけで証明目標が決まる局面を証明済みにすることで、
+#       どれだけのノードが打ち切られ、総ノード数・時間がどう変わるかを測定
+#
+# 比較: --stability on / off
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 確定石の判定対象ノード数と証明数（打ち切り率）
+#   3. ノードの空きマス数ごとの打ち切り率（test_positions 全体の合計）
+#
+# 出力:
+#   - results/expO_stability.csv
+#   - results/expO_stability_by_empties.csv
+#   - results/expO_summary.txt
+#
+# 推定実行時間: 2-4時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expO_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expO_stability.csv"
+SUMMARY_FILE="$RESULTS_DIR/expO_summary.txt"
+BUCKET_CSV_FILE="$RESULTS_DIR/expO_stability_by_empties.csv"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験O: 確定石による早期証明（--stability）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-12 14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-8}"
+MODES=(on off)
+# 全設定に共通の追加オプション（例: "--exact"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Stability,Empties,Position,Result,Nodes,Time_Sec,NPS,Stability_Nodes,Stability_Cutoffs,Cut_Fraction
+CSV
+cat > "$BUCKET_CSV_FILE" <<CSV
+Empties,Position,Node_Empties,Nodes,Cutoffs
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for mode in "${MODES[@]}"; do
+            log_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --stability "$mode" $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            # "stability" オブジェクト内の値（"nodes" は他のオブジェクトにもあるので範囲を限定）
+            stab_block=$(sed -n '/"stability": {/,/"by_empties"/p' "$json_file" 2>/dev/null)
+            stab_nodes=$(echo "$stab_block" | grep -m1 '"nodes":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            stab_cuts=$(echo "$stab_block" | grep -m1 '"cutoffs":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            cut_fraction=$(echo "$stab_block" | grep -m1 '"cut_fraction":' | sed -e 's/.*": *//' -e 's/[",]//g')
+
+            echo "$mode,$empties,$file_id,$result,$nodes,$time_sec,$nps,${stab_nodes:-0},${stab_cuts:-0},${cut_fraction:-0}" >> "$CSV_FILE"
+            log "  [stability=$mode] e${empties} id${file_id}: $result, nodes=$nodes, cutoffs=${stab_cuts:-0}/${stab_nodes:-0}"
+
+            # 空きマス数ごとの判定数・証明数（on のみ）
+            if [ "$mode" = "on" ] && [ -f "$json_file" ]; then
+                grep '{"empties":' "$json_file" | \
+                    sed -e 's/.*"empties": \([0-9]*\), "nodes": \([0-9]*\), "cutoffs": \([0-9]*\).*/\1,\2,\3/' | \
+                    while IFS=',' read -r node_empties b_nodes b_cuts; do
+                        echo "$empties,$file_id,$node_empties,$b_nodes,$b_cuts" >> "$BUCKET_CSV_FILE"
+                    done
+            fi
+        done
+    done
+done
+
+# サマリー
+log_header "サマリー作成"
+
+{
+    echo "実験O: 確定石による早期証明（--stability）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    echo "[問題の空きマス数別: on / off の比較]"
+    printf "%-10s %-8s %-8s %-14s %-12s %-12s\n" "Stability" "Empties" "Solved" "Avg_Nodes" "Avg_Time" "Cut_Frac"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nodes[k] += $5; t[k] += $6; sn[k] += $8; sc[k] += $9
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-10s %-8s %-8s %-14.0f %-12.3f %-12.4f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], t[k] / n[k], (sn[k] > 0 ? sc[k] / sn[k] : 0)
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+    echo ""
+    echo "[ノードの空きマス数別: 確定石で証明された割合（on、全問題の合計）]"
+    printf "%-12s %-14s %-14s %-10s\n" "Node_Empties" "Nodes" "Cutoffs" "Cut_Frac"
+    awk -F',' 'NR > 1 { n[$3] += $4; c[$3] += $5 }
+    END {
+        for (e in n) printf "%-12s %-14.0f %-14.0f %-10.4f\n", e, n[e], c[e], (n[e] > 0 ? c[e] / n[e] : 0)
+    }' "$BUCKET_CSV_FILE" | sort -k1,1n
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $BUCKET_CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,206 @@
+#!/bin/bash
+################################################################################
+# expP_dag.sh - 実験P: 合流（DAG）を考慮したpn/dnの和（--dag on|off）
+#
+# 目的: TTのソースマーカーで合流を検出し、和の二重計上を補正したときの
+#       総ノード数・時間の変化を、合流の多い（TTヒット率の高い）局面で測定
+#
+# 手順:
+#   1. スクリーニング: --dag off で全候補局面を解き、ノードあたりのTTヒット数
+#      （07_tt_hit_rate と同じ hits / nodes）を求める
+#   2. ヒット数の多い上位 TOP_POSITIONS 局面で --dag on / off を比較
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 合流の検出数（transpositions）と、和を補正したpn/dn更新の数
+#
+# 出力:
+#   - results/expP_dag_screen.csv
+#   - results/expP_dag.csv
+#   - results/expP_summary.txt
+#
+# 推定実行時間: 2-4時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expP_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expP_dag.csv"
+SUMMARY_FILE="$RESULTS_DIR/expP_summary.txt"
+SCREEN_CSV_FILE="$RESULTS_DIR/expP_dag_screen.csv"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験P: 合流（DAG）を考慮したpn/dnの和（--dag）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-10}"
+TOP_POSITIONS="${TOP_POSITIONS:-12}"
+MODES=(off on)
+# 全設定に共通の追加オプション
+# 従来しきい値（--epsilon 未指定）の木エンジンは子が証明されるまで戻らず、未証明の共有局面が
+# TTに残らないので、既定では 1+ε しきい値で比較する（ttエンジンなら "--engine tt"）
+EXTRA_ARGS="${EXTRA_ARGS:---epsilon 0.25}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# TTヒット数をノード数で割る（ノード数 0 なら 0）
+hits_per_node() {
+    local hits=$1
+    local nodes=$2
+    if [ "$nodes" = "0" ]; then
+        echo "0"
+    else
+        echo "scale=6; $hits / $nodes" | bc
+    fi
+}
+
+# 1. スクリーニング
+cat > "$SCREEN_CSV_FILE" <<CSV
+Empties,Position,Pos_File,Result,Nodes,TT_Hits,Hits_Per_Node
+CSV
+
+log_header "スクリーニング（--dag off）"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        json_file="$LOG_DIR/screen_e${empties}_id${file_id}.json"
+        timeout $((${TIME_LIMIT%.*} + 60)) \
+            "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+            --dag off $EXTRA_ARGS -j "$json_file" > "$LOG_DIR/screen_e${empties}_id${file_id}.log" 2>&1 || true
+
+        result=$(json_value "$json_file" "result")
+        nodes=$(json_value "$json_file" "total_nodes")
+        hits=$(json_value "$json_file" "hits")
+        hpn=$(hits_per_node "$hits" "$nodes")
+
+        echo "$empties,$file_id,$pos_file,$result,$nodes,$hits,$hpn" >> "$SCREEN_CSV_FILE"
+        log "  e${empties} id${file_id}: $result, nodes=$nodes, hits/node=$hpn"
+    done
+done
+
+# ノードあたりのTTヒット数の多い順に選ぶ（解けなかった局面は除く）
+SELECTED=$(awk -F',' 'NR > 1 && $4 != "UNKNOWN" && $4 != "0" { print $7 "," $1 "," $2 "," $3 }' "$SCREEN_CSV_FILE" | \
+    sort -t',' -k1,1gr | head -n "$TOP_POSITIONS")
+
+log "選択した局面: $(echo "$SELECTED" | grep -c . || true)"
+
+# 2. on / off の比較
+cat > "$CSV_FILE" <<CSV
+DAG,Empties,Position,Hits_Per_Node,Result,Nodes,Time_Sec,NPS,Transpositions,Corrections
+CSV
+
+log_header "比較（--dag on / off）"
+
+echo "$SELECTED" | while IFS=',' read -r hpn empties file_id pos_file; do
+    [ -z "$pos_file" ] && continue
+
+    for mode in "${MODES[@]}"; do
+        log_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.log"
+        json_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.json"
+
+        timeout $((${TIME_LIMIT%.*} + 60)) \
+            "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+            --dag "$mode" $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+        result=$(json_value "$json_file" "result")
+        nodes=$(json_value "$json_file" "total_nodes")
+        time_sec=$(json_value "$json_file" "time_sec")
+        nps=$(json_value "$json_file" "nps")
+        transpositions=$(json_value "$json_file" "transpositions")
+        corrections=$(json_value "$json_file" "corrections")
+
+        echo "$mode,$empties,$file_id,$hpn,$result,$nodes,$time_sec,$nps,$transpositions,$corrections" >> "$CSV_FILE"
+        log "  [dag=$mode] e${empties} id${file_id}: $result, nodes=$nodes, time=${time_sec}s, corrections=$corrections"
+    done
+done
+
+# サマリー
+log_header "サマリー作成"
+
+{
+    echo "実験P: 合流（DAG）を考慮したpn/dnの和（--dag）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo "対象: ノードあたりTTヒット数の上位 $TOP_POSITIONS 局面"
+    echo ""
+    printf "%-6s %-8s %-14s %-12s %-16s %-14s\n" "DAG" "Solved" "Avg_Nodes" "Avg_Time" "Avg_Transpos" "Avg_Corrections"
+    awk -F',' 'NR > 1 {
+        k = $1
+        n[k]++
+        if ($5 != "UNKNOWN" && $5 != "0") solved[k]++
+        nodes[k] += $6; t[k] += $7; tr[k] += $9; c[k] += $10
+    }
+    END {
+        for (k in n) {
+            printf "%-6s %-8s %-14.0f %-12.3f %-16.0f %-14.0f\n", k, solved[k] + 0 "/" n[k], nodes[k] / n[k], t[k] / n[k], tr[k] / n[k], c[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort
+    echo ""
+    echo "[局面別: ノード数の比（on / off）]"
+    printf "%-8s %-8s %-14s %-14s %-14s %-10s\n" "Empties" "Position" "Hits_Per_Node" "Nodes_Off" "Nodes_On" "Ratio"
+    awk -F',' 'NR > 1 {
+        k = $2 "," $3
+        hpn[k] = $4
+        if ($1 == "on") on[k] = $6; else off[k] = $6
+    }
+    END {
+        for (k in hpn) {
+            split(k, a, ",")
+            printf "%-8s %-8s %-14s %-14s %-14s %-10.3f\n", a[1], a[2], hpn[k], off[k], on[k], (off[k] > 0 ? on[k] / off[k] : 0)
+        }
+    }' "$CSV_FILE" | sort -k3,3gr
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $SCREEN_CSV_FILE, $CSV_FILE, $SUMMARY_FILE"
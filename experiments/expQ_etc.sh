@@ -0,0 +1,147 @@
+#!/bin/bash
+################################################################################
+# expQ_etc.sh - 実験Q: 展開時の Enhanced Transposition Cutoff（--etc on|off）
+#
+# 目的: 展開の直後に全ての子をTTで引き、証明済みの子で親を即座に証明したり
+#       保存済みのpn/dnで子を初期化したときの、ノード数・時間の変化を測定
+#
+# 比較: --etc on / off（木エンジン）
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 展開時にTTを引いた子の数・ヒット率・親を証明した展開数（cutoffs）
+#
+# 出力:
+#   - results/expQ_etc.csv
+#   - results/expQ_summary.txt
+#
+# 推定実行時間: 2-4時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expQ_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expQ_etc.csv"
+SUMMARY_FILE="$RESULTS_DIR/expQ_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験Q: Enhanced Transposition Cutoff（--etc）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-8}"
+MODES=(off on)
+# 全設定に共通の追加オプション（例: "--epsilon 0.25"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+ETC,Empties,Position,Result,Nodes,Time_Sec,NPS,ETC_Probes,ETC_Hits,ETC_Hit_Rate,ETC_Cutoffs
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for mode in "${MODES[@]}"; do
+            log_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --etc "$mode" $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            # "etc" オブジェクト内の値（"hits" などはTTの統計にもあるので範囲を限定）
+            etc_block=$(sed -n '/"etc": {/,/}/p' "$json_file" 2>/dev/null)
+            etc_probes=$(echo "$etc_block" | grep -m1 '"probes":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            etc_hits=$(echo "$etc_block" | grep -m1 '"hits":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            etc_hit_rate=$(echo "$etc_block" | grep -m1 '"hit_rate":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            etc_cutoffs=$(echo "$etc_block" | grep -m1 '"cutoffs":' | sed -e 's/.*": *//' -e 's/[",]//g')
+
+            echo "$mode,$empties,$file_id,$result,$nodes,$time_sec,$nps,${etc_probes:-0},${etc_hits:-0},${etc_hit_rate:-0},${etc_cutoffs:-0}" >> "$CSV_FILE"
+            log "  [etc=$mode] e${empties} id${file_id}: $result, nodes=$nodes, time=${time_sec}s, hits=${etc_hits:-0}/${etc_probes:-0}, cutoffs=${etc_cutoffs:-0}"
+        done
+    done
+done
+
+# サマリー（設定・空きマス別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験Q: Enhanced Transposition Cutoff（--etc）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    printf "%-5s %-8s %-8s %-14s %-12s %-12s %-12s\n" "ETC" "Empties" "Solved" "Avg_Nodes" "Avg_Time" "Hit_Rate%" "Avg_Cutoffs"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nodes[k] += $5; t[k] += $6; pr[k] += $8; h[k] += $9; c[k] += $11
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-5s %-8s %-8s %-14.0f %-12.3f %-12.2f %-12.0f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], t[k] / n[k], (pr[k] > 0 ? 100.0 * h[k] / pr[k] : 0), c[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,169 @@
+#!/bin/bash
+################################################################################
+# expR_move_ordering.sh - 実験R: 子の順序付けのアブレーション（--ordering）
+#
+# 目的: ワーカーごとの履歴表・キラー手による順序付けが、評価値のみの順序付け、
+#       順序付けなし（着手生成順）と比べてノード数をどれだけ減らすかを測定
+#
+# 比較: --ordering none / eval / history / eval+history（木エンジン）
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 親を証明した子のうち最初に並べた子だった割合（first_child_rate）
+#   3. eval・none に対するノード数の比（局面ごとの比の幾何平均）
+#
+# 出力:
+#   - results/expR_move_ordering.csv
+#   - results/expR_summary.txt
+#
+# 推定実行時間: 3-6時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expR_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expR_move_ordering.csv"
+SUMMARY_FILE="$RESULTS_DIR/expR_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験R: 子の順序付けのアブレーション（--ordering）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-8}"
+MODES=(none eval history eval+history)
+# 全設定に共通の追加オプション（例: "--epsilon 0.25"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Ordering,Empties,Position,Result,Nodes,Time_Sec,NPS,Cutoffs,First_Child_Rate,History_Updates
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for mode in "${MODES[@]}"; do
+            tag=${mode//+/_}
+            log_file="$LOG_DIR/${tag}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${tag}_e${empties}_id${file_id}.json"
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --ordering "$mode" $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            # "ordering" オブジェクト内の値（"cutoffs" は他のオブジェクトにもあるので範囲を限定）
+            ord_block=$(sed -n '/"ordering": {/,/}/p' "$json_file" 2>/dev/null)
+            cutoffs=$(echo "$ord_block" | grep -m1 '"cutoffs":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            first_rate=$(echo "$ord_block" | grep -m1 '"first_child_rate":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            updates=$(echo "$ord_block" | grep -m1 '"history_updates":' | sed -e 's/.*": *//' -e 's/[",]//g')
+
+            echo "$mode,$empties,$file_id,$result,$nodes,$time_sec,$nps,${cutoffs:-0},${first_rate:-0},${updates:-0}" >> "$CSV_FILE"
+            log "  [$mode] e${empties} id${file_id}: $result, nodes=$nodes, time=${time_sec}s, first_child_rate=${first_rate:-0}"
+        done
+    done
+done
+
+# サマリー
+log_header "サマリー作成"
+
+{
+    echo "実験R: 子の順序付けのアブレーション（--ordering）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    echo "[設定・空きマス別の平均]"
+    printf "%-14s %-8s %-8s %-14s %-12s %-12s\n" "Ordering" "Empties" "Solved" "Avg_Nodes" "Avg_Time" "First_Rate"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nodes[k] += $5; t[k] += $6; fr[k] += $9
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-14s %-8s %-8s %-14.0f %-12.3f %-12.4f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], t[k] / n[k], fr[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+    echo ""
+    echo "[ノード数の比（両方で解けた局面の幾何平均、1 未満なら削減）]"
+    printf "%-14s %-14s %-14s %-10s\n" "Ordering" "vs_eval" "vs_none" "Positions"
+    awk -F',' 'NR > 1 && $4 != "UNKNOWN" && $4 != "0" && $5 > 0 {
+        k = $2 "," $3
+        nodes[$1 "|" k] = $5
+        pos[k] = 1
+        modes[$1] = 1
+    }
+    END {
+        for (m in modes) {
+            le = 0; ce = 0; ln = 0; cn = 0
+            for (k in pos) {
+                if (!((m "|" k) in nodes)) continue
+                if (("eval|" k) in nodes) { le += log(nodes[m "|" k] / nodes["eval|" k]); ce++ }
+                if (("none|" k) in nodes) { ln += log(nodes[m "|" k] / nodes["none|" k]); cn++ }
+            }
+            printf "%-14s %-14.3f %-14.3f %-10d\n", m, (ce > 0 ? exp(le / ce) : 0), (cn > 0 ? exp(ln / cn) : 0), ce
+        }
+    }' "$CSV_FILE" | sort
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
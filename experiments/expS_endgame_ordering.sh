@@ -0,0 +1,176 @@
+#!/bin/bash
+################################################################################
+# expS_endgame_ordering.sh - 実験S: 評価値と終盤用の順序付けの切り替え点（--endgame-order）
+#
+# 目的: 空きマス数が n 以下のノードで評価値の代わりに終盤用の順序付け
+#       （fastest-first・偶数理論・マスの種類）を使うとき、最もノード数が少ない n を探す
+#
+# 比較: --endgame-order 0（評価値のみ）/ 各切り替え点 / 64（終盤用のみ）、
+#       および評価関数なし（eval none、既定の 64 で全域が終盤用の順序付け）
+#
+# 測定項目:
+#   1. 総ノード数・時間・解けた問題数
+#   2. 親を証明した子のうち最初に並べた子だった割合（first_child_rate）
+#   3. 終盤用の順序付けで並べた展開の数（ノードあたり）
+#   4. 評価値のみ（n = 0）に対するノード数の比（局面ごとの比の幾何平均）
+#
+# 出力:
+#   - results/expS_endgame_ordering.csv
+#   - results/expS_summary.txt
+#
+# 推定実行時間: 4-8時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expS_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expS_endgame_ordering.csv"
+SUMMARY_FILE="$RESULTS_DIR/expS_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験S: 評価値と終盤用の順序付けの切り替え点（--endgame-order）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-16}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-8}"
+# 切り替え点（0 = 評価値のみ、64 = 終盤用のみ）。"noeval" は評価関数なし（既定の 64）
+CROSSOVERS=(${CROSSOVERS:-0 6 8 10 12 14 16 64 noeval})
+# 全設定に共通の追加オプション（例: "--ordering eval+history"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Crossover,Empties,Position,Result,Nodes,Time_Sec,NPS,First_Child_Rate,Endgame_Expansions,Endgame_Per_Node
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for cross in "${CROSSOVERS[@]}"; do
+            log_file="$LOG_DIR/x${cross}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/x${cross}_e${empties}_id${file_id}.json"
+
+            if [ "$cross" = "noeval" ]; then
+                eval_arg="none"
+                order_args="--endgame-order 64"
+            else
+                eval_arg="$EVAL_FILE"
+                order_args="--endgame-order $cross"
+            fi
+
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$eval_arg" \
+                $order_args $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            first_rate=$(json_value "$json_file" "first_child_rate")
+            eg_exp=$(json_value "$json_file" "endgame_expansions")
+            share=$(awk -v e="$eg_exp" -v n="$nodes" 'BEGIN { printf "%.4f", (n > 0) ? e / n : 0 }')
+
+            echo "$cross,$empties,$file_id,$result,$nodes,$time_sec,$nps,$first_rate,$eg_exp,$share" >> "$CSV_FILE"
+            log "  [x=$cross] e${empties} id${file_id}: $result, nodes=$nodes, time=${time_sec}s, first_child_rate=$first_rate"
+        done
+    done
+done
+
+# サマリー
+log_header "サマリー作成"
+
+{
+    echo "実験S: 評価値と終盤用の順序付けの切り替え点（--endgame-order）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    echo "[切り替え点・空きマス別の平均]"
+    printf "%-10s %-8s %-8s %-14s %-12s %-12s %-12s\n" "Crossover" "Empties" "Solved" "Avg_Nodes" "Avg_Time" "First_Rate" "EG_Per_Node"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nodes[k] += $5; t[k] += $6; fr[k] += $8; sh[k] += $10
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-10s %-8s %-8s %-14.0f %-12.3f %-12.4f %-12.4f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], t[k] / n[k], fr[k] / n[k], sh[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1n
+    echo ""
+    echo "[評価値のみ（0）に対するノード数の比（両方で解けた局面の幾何平均、1 未満なら削減）]"
+    printf "%-10s %-8s %-14s %-10s\n" "Crossover" "Empties" "vs_eval" "Positions"
+    awk -F',' 'NR > 1 && $4 != "UNKNOWN" && $4 != "0" && $5 > 0 {
+        nodes[$1 "|" $2 "," $3] = $5
+        pos[$2 "," $3] = $2
+        cfg[$1] = 1
+    }
+    END {
+        for (c in cfg) {
+            delete l; delete cnt
+            for (k in pos) {
+                if (!((c "|" k) in nodes) || !(("0|" k) in nodes)) continue
+                e = pos[k]
+                l[e] += log(nodes[c "|" k] / nodes["0|" k]); cnt[e]++
+            }
+            for (e in cnt) printf "%-10s %-8s %-14.3f %-10d\n", c, e, exp(l[e] / cnt[e]), cnt[e]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1n
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
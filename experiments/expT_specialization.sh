@@ -0,0 +1,185 @@
+#!/bin/bash
+################################################################################
+# expT_specialization.sh - 実験T: OR/AND 特殊化と計測なしビルドのNPS比較
+#
+# 目的: 探索本体（dfpn_solve_node / update_pn_dn / select_best_child_with_priority）を
+#       OR/AND で特殊化し、-DENABLE_SEARCH_INSTRUMENTATION=0 でノードごとの計測を
+#       取り除いたときのNPSの変化を測定
+#
+# 比較（同じソースから2つのビルドを作る）:
+#   - instr:   通常ビルド（-t / -s の計測あり、実行時は無効）
+#   - noinst:  -DENABLE_SEARCH_INSTRUMENTATION=0
+#   - baseline: BASELINE_BIN を指定した場合のみ（特殊化前のコミットからビルドしたバイナリ等）
+#
+# 測定項目:
+#   1. NPS（ノード/秒）、時間、総ノード数（REPEATS 回の中央値）
+#   2. instr に対するNPS比（局面ごとの中央値の比の幾何平均）
+#
+# 出力:
+#   - results/expT_specialization.csv
+#   - results/expT_summary.txt
+#
+# 推定実行時間: 1-2時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expT_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expT_specialization.csv"
+SUMMARY_FILE="$RESULTS_DIR/expT_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験T: OR/AND 特殊化と計測なしビルドのNPS比較"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOURCE_FILE="othello_endgame_solver_hybrid_check_tthit_fixed.c"
+CC="${CC:-gcc}"
+BUILD_FLAGS="${BUILD_FLAGS:--O3 -flto -ffast-math -march=native}"
+TT_SIZE_MB="${TT_SIZE_MB:-1024}"
+THREADS="${THREADS:-1}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+REPEATS="${REPEATS:-3}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+BASELINE_BIN="${BASELINE_BIN:-}"
+# 全設定に共通の追加オプション（例: "--epsilon 0.25"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+# ビルド（同じフラグで計測あり/なしの2つ）
+build_variant() {
+    local name=$1
+    shift
+    log "ビルド中: $name ($BUILD_FLAGS $*)"
+    $CC $BUILD_FLAGS -DSTANDALONE_MAIN -DTT_SIZE_MB=$TT_SIZE_MB "$@" \
+        -o "$LOG_DIR/solver_$name" "$SOURCE_FILE" -lm -lpthread > "$LOG_DIR/build_$name.log" 2>&1
+}
+
+build_variant instr
+build_variant noinst -DENABLE_SEARCH_INSTRUMENTATION=0
+
+VARIANTS=(instr noinst)
+declare -A BINS=([instr]="$LOG_DIR/solver_instr" [noinst]="$LOG_DIR/solver_noinst")
+if [ -n "$BASELINE_BIN" ]; then
+    if [ ! -x "$BASELINE_BIN" ]; then
+        log "エラー: BASELINE_BIN=$BASELINE_BIN が実行できません"
+        exit 1
+    fi
+    VARIANTS+=(baseline)
+    BINS[baseline]="$BASELINE_BIN"
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Variant,Empties,Position,Run,Result,Nodes,Time_Sec,NPS
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        # 実行順の偏り（周波数・キャッシュの温まり）を避けるため、回ごとに全ビルドを交互に実行
+        for run in $(seq 1 $REPEATS); do
+            for variant in "${VARIANTS[@]}"; do
+                log_file="$LOG_DIR/${variant}_e${empties}_id${file_id}_r${run}.log"
+                json_file="$LOG_DIR/${variant}_e${empties}_id${file_id}_r${run}.json"
+
+                timeout $((${TIME_LIMIT%.*} + 60)) \
+                    "${BINS[$variant]}" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                    $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+                result=$(json_value "$json_file" "result")
+                nodes=$(json_value "$json_file" "total_nodes")
+                time_sec=$(json_value "$json_file" "time_sec")
+                nps=$(json_value "$json_file" "nps")
+
+                echo "$variant,$empties,$file_id,$run,$result,$nodes,$time_sec,$nps" >> "$CSV_FILE"
+                log "  [$variant] e${empties} id${file_id} run${run}: $result, nodes=$nodes, NPS=$nps"
+            done
+        done
+    done
+done
+
+# サマリー
+log_header "サマリー作成"
+
+{
+    echo "実験T: OR/AND 特殊化と計測なしビルドのNPS比較"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 繰り返し: $REPEATS, ビルド: $BUILD_FLAGS"
+    echo "追加オプション: ${EXTRA_ARGS:-なし}, baseline: ${BASELINE_BIN:-なし}"
+    echo ""
+    echo "[ビルド・空きマス別: 局面ごとのNPS中央値の平均と、instr に対する比（幾何平均）]"
+    printf "%-10s %-8s %-14s %-12s %-10s\n" "Variant" "Empties" "Avg_NPS" "vs_instr" "Positions"
+    awk -F',' 'NR > 1 && $8 > 0 {
+        k = $1 "|" $2 "," $3
+        n[k]++; v[k, n[k]] = $8
+        pos[$2 "," $3] = $2
+        cfg[$1] = 1
+    }
+    function median(k,    i, j, t, m) {
+        m = n[k]
+        for (i = 1; i <= m; i++) a[i] = v[k, i]
+        for (i = 2; i <= m; i++) { t = a[i]; for (j = i - 1; j >= 1 && a[j] > t; j--) a[j + 1] = a[j]; a[j + 1] = t }
+        return (m % 2) ? a[(m + 1) / 2] : (a[m / 2] + a[m / 2 + 1]) / 2
+    }
+    END {
+        for (c in cfg) {
+            delete sum; delete cnt; delete lr; delete lc
+            for (p in pos) {
+                if (!((c "|" p) in n)) continue
+                e = pos[p]
+                m = median(c "|" p)
+                sum[e] += m; cnt[e]++
+                if (("instr|" p) in n) { lr[e] += log(m / median("instr|" p)); lc[e]++ }
+            }
+            for (e in cnt) printf "%-10s %-8s %-14.0f %-12.3f %-10d\n", c, e, sum[e] / cnt[e], (lc[e] > 0 ? exp(lr[e] / lc[e]) : 0), cnt[e]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,154 @@
+#!/bin/bash
+################################################################################
+# expU_eval_incremental.sh - 実験U: 特徴量の増分計算（--eval-incremental on|off）
+#
+# 目的: 子の評価を、親の特徴量を着手・返した石から差分更新して 47 回の表引きで
+#       求めたときの、全特徴量を毎回計算する場合に対するNPSの変化を測定
+#       （探索する木は同じなので、ノード数は両者で一致するはず）
+#
+# 比較: --eval-incremental on / off
+#
+# 測定項目:
+#   1. NPS・時間・総ノード数
+#   2. 差分で評価した子の数と、特徴量を作り直した数（feature_rebuilds）
+#   3. off に対するNPS比（局面ごとの比の幾何平均）
+#
+# 出力:
+#   - results/expU_eval_incremental.csv
+#   - results/expU_summary.txt
+#
+# 推定実行時間: 1-2時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expU_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expU_eval_incremental.csv"
+SUMMARY_FILE="$RESULTS_DIR/expU_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験U: 特徴量の増分計算（--eval-incremental）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-1}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+MODES=(off on)
+# 全設定に共通の追加オプション（例: "--engine tt"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Incremental,Empties,Position,Result,Nodes,Time_Sec,NPS,Incremental_Evals,Feature_Rebuilds
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for mode in "${MODES[@]}"; do
+            log_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${mode}_e${empties}_id${file_id}.json"
+
+            # 評価関数を全域で使う（既定の終盤用の順序付けでは評価関数を呼ばない）
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                --eval-incremental "$mode" --endgame-order 0 $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            # "eval_incremental" オブジェクト内の値
+            inc_block=$(sed -n '/"eval_incremental": {/,/}/p' "$json_file" 2>/dev/null)
+            inc_evals=$(echo "$inc_block" | grep -m1 '"evals":' | sed -e 's/.*": *//' -e 's/[",]//g')
+            rebuilds=$(echo "$inc_block" | grep -m1 '"feature_rebuilds":' | sed -e 's/.*": *//' -e 's/[",]//g')
+
+            echo "$mode,$empties,$file_id,$result,$nodes,$time_sec,$nps,${inc_evals:-0},${rebuilds:-0}" >> "$CSV_FILE"
+            log "  [incremental=$mode] e${empties} id${file_id}: $result, nodes=$nodes, NPS=$nps, rebuilds=${rebuilds:-0}"
+        done
+    done
+done
+
+# サマリー（設定・空きマス別の平均と、off に対するNPS比）
+log_header "サマリー作成"
+
+{
+    echo "実験U: 特徴量の増分計算（--eval-incremental）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    printf "%-12s %-8s %-8s %-14s %-14s %-12s %-10s\n" "Incremental" "Empties" "Solved" "Avg_Nodes" "Avg_NPS" "NPS_vs_off" "Rebuilds"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nodes[k] += $5; nps[k] += $7; rb[k] += $9
+        if ($7 > 0) v[$1 "|" $2 "," $3] = $7
+        pos[$2 "," $3] = $2
+    }
+    END {
+        for (p in pos) {
+            if (("on|" p) in v && ("off|" p) in v) { lr[pos[p]] += log(v["on|" p] / v["off|" p]); lc[pos[p]]++ }
+        }
+        for (k in n) {
+            split(k, a, ",")
+            ratio = (a[1] == "off") ? 1 : (lc[a[2]] > 0 ? exp(lr[a[2]] / lc[a[2]]) : 0)
+            printf "%-12s %-8s %-8s %-14.0f %-14.0f %-12.3f %-10.0f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], nps[k] / n[k], ratio, rb[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
@@ -0,0 +1,160 @@
+#!/bin/bash
+################################################################################
+# expW_eval_startup.sh - 実験W: 評価関数の重みの起動コスト（--eval-cache on|off）
+#
+# 目的: eval.dat を毎回読んで展開する場合と、展開済みの重みのキャッシュを mmap する
+#       場合の起動コストを比較する。短い探索を何度も起動するベンチマーク向けの測定
+#
+# 比較:
+#   off     - 毎回 eval.dat を fread して展開（従来）
+#   create  - キャッシュを消してから起動（初回: 展開 + キャッシュの書き出し）
+#   on      - 作成済みのキャッシュを mmap（2回目以降）
+#
+# 測定項目:
+#   1. 重みの読み込み時間（JSON の eval_load.time_ms）
+#   2. プロセス全体の実行時間（起動から終了まで、探索を含む）
+#   3. 同時に起動した CONCURRENT 個のプロセスの実行時間（ページキャッシュ共有の効果）
+#
+# 出力:
+#   - results/expW_eval_startup.csv
+#   - results/expW_summary.txt
+#
+# 推定実行時間: 数分
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expW_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expW_eval_startup.csv"
+SUMMARY_FILE="$RESULTS_DIR/expW_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON "eval_load" オブジェクト内の値を抽出
+# 使用法: eval_load_value <json_file> <key>
+eval_load_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(sed -n '/"eval_load": {/,/}/p' "$json_file" 2>/dev/null | grep -m1 "\"$key\":" | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験W: 評価関数の重みの起動コスト（--eval-cache）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-1}"
+TIME_LIMIT="${TIME_LIMIT:-10.0}"
+EVAL_FILE="eval/eval.dat"
+# 起動コストが目立つよう、すぐ解ける局面を使う
+POS_FILE="${POS_FILE:-test_positions/empties_08_id_000.pos}"
+RUNS="${RUNS:-20}"
+CONCURRENT="${CONCURRENT:-8}"
+CACHE_FILE="$LOG_DIR/eval.wcache"
+MODES=(off create on)
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# 1回起動して、重みの読み込み元・時間とプロセスの実行時間（ミリ秒）を出力
+# 使用法: run_once <mode> <tag>
+run_once() {
+    local mode=$1
+    local tag=$2
+    local json_file="$LOG_DIR/${tag}.json"
+    local cache_arg="off"
+
+    if [ "$mode" != "off" ]; then
+        cache_arg="$CACHE_FILE"
+        [ "$mode" = "create" ] && rm -f "$CACHE_FILE"
+    fi
+
+    local start=$(date +%s%N)
+    "$SOLVER_BIN" "$POS_FILE" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+        --eval-cache "$cache_arg" -j "$json_file" > "$LOG_DIR/${tag}.log" 2>&1 || true
+    local end=$(date +%s%N)
+
+    echo "$(eval_load_value "$json_file" "source"),$(eval_load_value "$json_file" "time_ms"),$(( (end - start) / 1000000 ))"
+}
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Mode,Run,Concurrent,Source,Load_Ms,Process_Ms
+CSV
+
+log "CSV ファイル作成完了"
+
+# 逐次起動
+for mode in "${MODES[@]}"; do
+    for run in $(seq 1 $RUNS); do
+        row=$(run_once "$mode" "${mode}_run${run}")
+        echo "$mode,$run,1,$row" >> "$CSV_FILE"
+    done
+    log "  [$mode] $RUNS 回の逐次起動が完了"
+done
+
+# 同時起動（off と on のみ。on はキャッシュを作成済みの状態で起動）
+for mode in off on; do
+    [ "$mode" = "on" ] && run_once create "warmup" > /dev/null
+    for run in $(seq 1 $RUNS); do
+        pids=()
+        for k in $(seq 1 $CONCURRENT); do
+            run_once "$mode" "${mode}_conc${run}_${k}" > "$LOG_DIR/${mode}_conc${run}_${k}.row" &
+            pids+=($!)
+        done
+        wait "${pids[@]}"
+        for k in $(seq 1 $CONCURRENT); do
+            echo "$mode,$run,$CONCURRENT,$(cat "$LOG_DIR/${mode}_conc${run}_${k}.row")" >> "$CSV_FILE"
+        done
+    done
+    log "  [$mode] $CONCURRENT 並列 × $RUNS 回の起動が完了"
+done
+
+# サマリー（設定・同時起動数別の平均）
+log_header "サマリー作成"
+
+{
+    echo "実験W: 評価関数の重みの起動コスト（--eval-cache）"
+    echo "局面: $POS_FILE, スレッド数: $THREADS, 起動回数: $RUNS, 同時起動数: $CONCURRENT"
+    echo ""
+    printf "%-8s %-12s %-8s %-14s %-14s\n" "Mode" "Concurrent" "Runs" "Avg_Load_Ms" "Avg_Process_Ms"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $3
+        n[k]++
+        load[k] += $5; proc[k] += $6
+    }
+    END {
+        for (k in n) {
+            split(k, a, ",")
+            printf "%-8s %-12s %-8d %-14.3f %-14.1f\n", a[1], a[2], n[k], load[k] / n[k], proc[k] / n[k]
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
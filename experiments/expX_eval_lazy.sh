@@ -0,0 +1,183 @@
+#!/bin/bash
+################################################################################
+# expX_eval_lazy.sh - 実験X: 子の評価の遅延・省略（--eval-lazy、--eval-min-empties）
+#
+# 目的: 子を終盤用の順序付け（相手の合法手数・偶数理論）で作り、評価関数は
+#       展開済みのノードを2回目に訪れたときだけ呼ぶ（lazy）、または空きマス数が
+#       しきい値未満のノードでは呼ばない（gate）ときの、評価回数・NPS・総ノード数の変化を測定
+#       （並びが変わるので、探索する木も変わる）
+#       木エンジンは --epsilon を指定しないと子を証明まで探索するので2回目の訪問が少ない
+#
+# 比較: eager（従来）/ lazy / gate / lazy+gate
+#
+# 測定項目:
+#   1. NPS・時間・総ノード数
+#   2. 評価した子の数、遅らせた子・2回目の訪問で評価した子・しきい値で省いた子の数
+#   3. 評価を省けた子の数（avoided）と、eager に対する総ノード数・NPSの比（局面ごとの比の幾何平均）
+#
+# 出力:
+#   - results/expX_eval_lazy.csv
+#   - results/expX_summary.txt
+#
+# 推定実行時間: 2-3時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expX_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expX_eval_lazy.csv"
+SUMMARY_FILE="$RESULTS_DIR/expX_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験X: 子の評価の遅延・省略（--eval-lazy、--eval-min-empties）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREADS="${THREADS:-1}"
+TIME_LIMIT="${TIME_LIMIT:-120.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-14 16 18})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-4}"
+# gate / lazy+gate で子を評価しない空きマス数（これ未満のノード）
+GATE_EMPTIES="${GATE_EMPTIES:-12}"
+CONFIGS=(eager lazy gate lazy+gate)
+# 全設定に共通の追加オプション（例: "--epsilon 0.25", "--engine tt"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+# JSONオブジェクトの部分（sed で切り出したもの）から値を抽出
+# 使用法: block_value <block> <key>
+block_value() {
+    echo "$1" | grep -m1 "\"$2\":" | sed -e 's/.*": *//' -e 's/[",]//g'
+}
+
+# 設定名 → ソルバーのオプション
+config_args() {
+    case "$1" in
+        eager)     echo "--eval-lazy off" ;;
+        lazy)      echo "--eval-lazy on" ;;
+        gate)      echo "--eval-lazy off --eval-min-empties $GATE_EMPTIES" ;;
+        lazy+gate) echo "--eval-lazy on --eval-min-empties $GATE_EMPTIES" ;;
+    esac
+}
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Config,Empties,Position,Result,Nodes,Time_Sec,NPS,Evaluated,Deferred,Resolved,Gated,Avoided
+CSV
+
+log "CSV ファイル作成完了"
+
+for empties in "${EMPTIES_LEVELS[@]}"; do
+    empties_padded=$(printf "%02d" $empties)
+
+    for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+        file_id_padded=$(printf "%03d" $file_id)
+        pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+        if [ ! -f "$pos_file" ]; then
+            log "警告: $pos_file が見つかりません。スキップ"
+            continue
+        fi
+
+        for config in "${CONFIGS[@]}"; do
+            log_file="$LOG_DIR/${config}_e${empties}_id${file_id}.log"
+            json_file="$LOG_DIR/${config}_e${empties}_id${file_id}.json"
+
+            # 評価関数を全域で使う（既定の終盤用の順序付けでは評価関数を呼ばない）
+            timeout $((${TIME_LIMIT%.*} + 60)) \
+                "$SOLVER_BIN" "$pos_file" "$THREADS" "$TIME_LIMIT" "$EVAL_FILE" \
+                $(config_args "$config") --endgame-order 0 $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+            result=$(json_value "$json_file" "result")
+            nodes=$(json_value "$json_file" "total_nodes")
+            time_sec=$(json_value "$json_file" "time_sec")
+            nps=$(json_value "$json_file" "nps")
+            # "eval_lazy" オブジェクト内の値
+            lazy_block=$(sed -n '/"eval_lazy": {/,/}/p' "$json_file" 2>/dev/null)
+            evaluated=$(block_value "$lazy_block" evaluated)
+            deferred=$(block_value "$lazy_block" deferred)
+            resolved=$(block_value "$lazy_block" resolved)
+            gated=$(block_value "$lazy_block" gated)
+            avoided=$(block_value "$lazy_block" avoided)
+
+            echo "$config,$empties,$file_id,$result,$nodes,$time_sec,$nps,${evaluated:-0},${deferred:-0},${resolved:-0},${gated:-0},${avoided:-0}" >> "$CSV_FILE"
+            log "  [$config] e${empties} id${file_id}: $result, nodes=$nodes, NPS=$nps, evaluated=${evaluated:-0}, avoided=${avoided:-0}"
+        done
+    done
+done
+
+# サマリー（設定・空きマス別の平均と、eager に対する総ノード数・NPSの比）
+log_header "サマリー作成"
+
+{
+    echo "実験X: 子の評価の遅延・省略（--eval-lazy、--eval-min-empties）"
+    echo "スレッド数: $THREADS, 制限時間: $TIME_LIMIT 秒, gate: < $GATE_EMPTIES 空き, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    printf "%-10s %-8s %-8s %-14s %-14s %-14s %-14s %-12s %-12s\n" "Config" "Empties" "Solved" "Avg_Nodes" "Avg_NPS" "Avg_Evaluated" "Avg_Avoided" "Nodes_vs_eager" "NPS_vs_eager"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($4 != "UNKNOWN" && $4 != "0") solved[k]++
+        nodes[k] += $5; nps[k] += $7; ev[k] += $8; av[k] += $12
+        if ($5 > 0 && $7 > 0) { vn[$1 "|" $2 "," $3] = $5; vp[$1 "|" $2 "," $3] = $7 }
+        pos[$2 "," $3] = $2
+        cfg[$1] = 1
+    }
+    END {
+        for (c in cfg) for (p in pos) {
+            if ((c "|" p) in vn && ("eager|" p) in vn) {
+                ln[c "," pos[p]] += log(vn[c "|" p] / vn["eager|" p])
+                lp[c "," pos[p]] += log(vp[c "|" p] / vp["eager|" p])
+                lc[c "," pos[p]]++
+            }
+        }
+        for (k in n) {
+            rn = (lc[k] > 0) ? exp(ln[k] / lc[k]) : 0
+            rp = (lc[k] > 0) ? exp(lp[k] / lc[k]) : 0
+            split(k, a, ",")
+            printf "%-10s %-8s %-8s %-14.0f %-14.0f %-14.0f %-14.0f %-12.3f %-12.3f\n", a[1], a[2], solved[k] + 0 "/" n[k], nodes[k] / n[k], nps[k] / n[k], ev[k] / n[k], av[k] / n[k], rn, rp
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
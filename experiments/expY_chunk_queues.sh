@@ -0,0 +1,197 @@
+#!/bin/bash
+################################################################################
+# expY_chunk_queues.sh - 実験Y: チャンクキューの構成（--queues flat / hier / multiqueue）
+#
+# 目的: 全ワーカーで1つの GlobalChunkQueue（1つの mutex / 条件変数）と、
+#       L3ドメインごと → ソケットごと → 全体の3段のキュー（hier）を比較し、
+#       チャンクがどの段で受け渡されたか（同じL3ドメイン内で済んだ割合）と
+#       時間・NPSの変化を測定
+#       hier の段はスレッドのアフィニティ（または実行中のCPU）で決まるので、
+#       ワーカーをドメインに固定したいときは PIN_CMD で numactl / taskset を指定する
+#       multiqueue は c×スレッド数 個のサブヒープ（trylock、2つの乱数の先頭の良い方を取る）
+#       キュー単体の競合は -DQUEUE_BENCH_MAIN のベンチマークで測る
+#
+# 比較: flat（従来）/ hier / multiqueue
+#
+# 測定項目:
+#   1. 時間・NPS・総ノード数
+#   2. 段ごとに入れた・取り出したチャンク数（L3 / ソケット / 全体 / 他のL3ドメイン）、
+#      multiqueue の trylock 失敗数
+#   3. L3ドメイン内で取り出したチャンクの割合と、flat に対する時間の比（局面ごとの比の幾何平均）
+#
+# 出力:
+#   - results/expY_chunk_queues.csv
+#   - results/expY_summary.txt
+#
+# 推定実行時間: 3-5時間
+################################################################################
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+cd "$SCRIPT_DIR/.."
+
+# 設定
+RESULTS_DIR="experiments/results"
+LOG_DIR="$RESULTS_DIR/logs/expY_$(date +%Y%m%d_%H%M%S)"
+CSV_FILE="$RESULTS_DIR/expY_chunk_queues.csv"
+SUMMARY_FILE="$RESULTS_DIR/expY_summary.txt"
+
+mkdir -p "$LOG_DIR"
+mkdir -p "$RESULTS_DIR"
+
+# ログ関数
+log() {
+    echo "[$(date '+%Y-%m-%d %H:%M:%S')] $*" | tee -a "$LOG_DIR/master.log"
+}
+
+log_header() {
+    echo "" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+    echo "$*" | tee -a "$LOG_DIR/master.log"
+    echo "========================================" | tee -a "$LOG_DIR/master.log"
+}
+
+# JSON結果ファイルから値を抽出（ソルバーの -j 出力は1行1キーの固定書式）
+# 使用法: json_value <json_file> <key>
+json_value() {
+    local json_file=$1
+    local key=$2
+
+    local value=$(grep -m1 "\"$key\":" "$json_file" 2>/dev/null | sed -e 's/.*": *//' -e 's/[",]//g' -e 's/ *$//')
+    [ -z "$value" ] && value="0"
+    echo "$value"
+}
+
+log_header "実験Y: チャンクキューの構成（--queues flat / hier / multiqueue）"
+log "開始時刻: $(date)"
+
+# 実験パラメータ（環境変数で上書き可）
+SOLVER_BIN="${SOLVER_BIN:-./othello_endgame_solver_hybrid}"
+THREAD_COUNTS=(${THREAD_COUNTS:-64 192 384 768})
+TIME_LIMIT="${TIME_LIMIT:-300.0}"
+EVAL_FILE="eval/eval.dat"
+POS_DIR="test_positions"
+EMPTIES_LEVELS=(${EMPTIES_LEVELS:-18 20})
+FILES_PER_LEVEL="${FILES_PER_LEVEL:-3}"
+CONFIGS=(${CONFIGS:-flat hier multiqueue})
+# multiqueue のサブヒープ数 = MQ_C × スレッド数
+MQ_C="${MQ_C:-2}"
+# ソルバーの前に付けるコマンド（例: "numactl --interleave=all"）
+PIN_CMD="${PIN_CMD:-}"
+# 全設定に共通の追加オプション（例: "-G 5 -D 4 -S 6", "--engine tt"）
+EXTRA_ARGS="${EXTRA_ARGS:-}"
+
+# 設定名 → ソルバーのオプション
+config_args() {
+    case "$1" in
+        multiqueue) echo "--queues multiqueue --mq-c $MQ_C" ;;
+        *)          echo "--queues $1" ;;
+    esac
+}
+
+# JSONオブジェクトの部分（sed で切り出したもの）から値を抽出
+# 使用法: block_value <block> <key>
+block_value() {
+    echo "$1" | grep -m1 "\"$2\":" | sed -e 's/.*": *//' -e 's/[",]//g'
+}
+
+if [ ! -x "$SOLVER_BIN" ]; then
+    log "エラー: $SOLVER_BIN が見つかりません（experiments/build_solvers.sh を実行してください）"
+    exit 1
+fi
+
+# CSV ヘッダー
+cat > "$CSV_FILE" <<CSV
+Config,Threads,Empties,Position,Result,Nodes,Time_Sec,NPS,L3_Domains,Sockets,L3_Pushed,Socket_Pushed,Global_Pushed,L3_Popped,Socket_Popped,Global_Popped,Remote_L3_Popped,MQ_Lock_Fails
+CSV
+
+log "CSV ファイル作成完了"
+
+for threads in "${THREAD_COUNTS[@]}"; do
+    log_header "スレッド数: $threads"
+
+    for empties in "${EMPTIES_LEVELS[@]}"; do
+        empties_padded=$(printf "%02d" $empties)
+
+        for file_id in $(seq 0 $((FILES_PER_LEVEL - 1))); do
+            file_id_padded=$(printf "%03d" $file_id)
+            pos_file="$POS_DIR/empties_${empties_padded}_id_${file_id_padded}.pos"
+
+            if [ ! -f "$pos_file" ]; then
+                log "警告: $pos_file が見つかりません。スキップ"
+                continue
+            fi
+
+            for config in "${CONFIGS[@]}"; do
+                log_file="$LOG_DIR/${config}_t${threads}_e${empties}_id${file_id}.log"
+                json_file="$LOG_DIR/${config}_t${threads}_e${empties}_id${file_id}.json"
+
+                timeout $((${TIME_LIMIT%.*} + 60)) \
+                    $PIN_CMD "$SOLVER_BIN" "$pos_file" "$threads" "$TIME_LIMIT" "$EVAL_FILE" \
+                    $(config_args "$config") $EXTRA_ARGS -j "$json_file" > "$log_file" 2>&1 || true
+
+                result=$(json_value "$json_file" "result")
+                nodes=$(json_value "$json_file" "total_nodes")
+                time_sec=$(json_value "$json_file" "time_sec")
+                nps=$(json_value "$json_file" "nps")
+                # "chunk_queues" オブジェクト内の値
+                queue_block=$(sed -n '/"chunk_queues": {/,/}/p' "$json_file" 2>/dev/null)
+                l3_domains=$(block_value "$queue_block" l3_domains)
+                sockets=$(block_value "$queue_block" sockets)
+                l3_pushed=$(block_value "$queue_block" l3_pushed)
+                socket_pushed=$(block_value "$queue_block" socket_pushed)
+                global_pushed=$(block_value "$queue_block" global_pushed)
+                l3_popped=$(block_value "$queue_block" l3_popped)
+                socket_popped=$(block_value "$queue_block" socket_popped)
+                global_popped=$(block_value "$queue_block" global_popped)
+                remote_popped=$(block_value "$queue_block" remote_l3_popped)
+                mq_lock_fails=$(block_value "$queue_block" mq_lock_fails)
+
+                echo "$config,$threads,$empties,$file_id,$result,$nodes,$time_sec,$nps,${l3_domains:-0},${sockets:-0},${l3_pushed:-0},${socket_pushed:-0},${global_pushed:-0},${l3_popped:-0},${socket_popped:-0},${global_popped:-0},${remote_popped:-0},${mq_lock_fails:-0}" >> "$CSV_FILE"
+                log "  [$config] ${threads}t e${empties} id${file_id}: $result, ${time_sec}s, NPS=$nps, popped L3/socket/global/other=${l3_popped:-0}/${socket_popped:-0}/${global_popped:-0}/${remote_popped:-0}"
+            done
+        done
+    done
+done
+
+# サマリー（設定・スレッド数別の平均と、L3ドメイン内で取り出した割合、flat に対する時間の比）
+log_header "サマリー作成"
+
+{
+    echo "実験Y: チャンクキューの構成（--queues flat / hier / multiqueue）"
+    echo "制限時間: $TIME_LIMIT 秒, 空きマス: ${EMPTIES_LEVELS[*]}, MultiQueue c: $MQ_C, 固定: ${PIN_CMD:-なし}, 追加オプション: ${EXTRA_ARGS:-なし}"
+    echo ""
+    printf "%-11s %-8s %-8s %-12s %-14s %-10s %-10s %-12s %-12s\n" "Config" "Threads" "Solved" "Avg_Time" "Avg_NPS" "Chunks" "L3_Local%" "Lock_Fails" "Time_vs_flat"
+    awk -F',' 'NR > 1 {
+        k = $1 "," $2
+        n[k]++
+        if ($5 != "UNKNOWN" && $5 != "0") solved[k]++
+        t[k] += $7; nps[k] += $8
+        popped = $14 + $15 + $16 + $17
+        chunks[k] += popped; local_pops[k] += $14; lock_fails[k] += $18
+        if ($7 > 0) vt[$1 "|" $2 "," $3 "," $4] = $7
+        pos[$2 "," $3 "," $4] = $2
+        cfg[$1] = 1
+    }
+    END {
+        for (c in cfg) for (p in pos) {
+            if ((c "|" p) in vt && ("flat|" p) in vt) {
+                lt[c "," pos[p]] += log(vt[c "|" p] / vt["flat|" p])
+                lc[c "," pos[p]]++
+            }
+        }
+        for (k in n) {
+            rt = (lc[k] > 0) ? exp(lt[k] / lc[k]) : 0
+            # hier 以外は段がないので L3_Local% は "-"
+            split(k, a, ",")
+            lp = (a[1] == "hier" && chunks[k] > 0) ? sprintf("%.1f", 100.0 * local_pops[k] / chunks[k]) : "-"
+            printf "%-11s %-8s %-8s %-12.3f %-14.0f %-10.0f %-10s %-12.0f %-12.3f\n", a[1], a[2], solved[k] + 0 "/" n[k], t[k] / n[k], nps[k] / n[k], chunks[k] / n[k], lp, lock_fails[k] / n[k], rt
+        }
+    }' "$CSV_FILE" | sort -k2,2n -k1,1
+} > "$SUMMARY_FILE"
+
+cat "$SUMMARY_FILE" | tee -a "$LOG_DIR/master.log"
+
+log "完了時刻: $(date)"
+log "結果: $CSV_FILE, $SUMMARY_FILE"
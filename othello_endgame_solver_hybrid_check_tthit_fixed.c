@@ -26,6 +26,10 @@
 #include <math.h>
 #include <stdarg.h>
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sched.h>
 #include <limits.h>
 #include <stdatomic.h>
 
@@ -143,11 +147,38 @@ static DebugConfig DEBUG_CONFIG = {0};
 #define GLOBAL_QUEUE_CAPACITY 4096      // GlobalQueueの最大チャンク数（ヒープ配列サイズ）
 #endif
 
+// --- 階層キュー関連（--queues hier） ---
+#ifndef QUEUE_HIER_MAX_L3
+#define QUEUE_HIER_MAX_L3 64            // 扱うL3ドメイン数の上限（超えた分は最後のドメインにまとめる）
+#endif
+#ifndef QUEUE_HIER_MAX_SOCKETS
+#define QUEUE_HIER_MAX_SOCKETS 16       // 扱うソケット数の上限
+#endif
+
+// --- MultiQueue関連（--queues multiqueue） ---
+#ifndef MQ_HEAP_CAPACITY
+#define MQ_HEAP_CAPACITY 64             // サブヒープ1つの最大チャンク数（サブヒープは c×スレッド数 個）
+#endif
+#ifndef MQ_ATTEMPTS
+#define MQ_ATTEMPTS 8                   // 乱数でサブヒープを選び直す回数（超えたら順に見てロックを待つ）
+#endif
+
 // --- SharedTaskArray関連 ---
 #ifndef SHARED_ARRAY_SIZE
 #define SHARED_ARRAY_SIZE 65536         // SharedTaskArrayのサイズ（768コア用に拡大: 64K）
 #endif
 
+// --- キャッシュライン ---
+#define CACHE_LINE_SIZE 64              // false sharing回避のパディング単位（TTのストライプロック、Chase-Lev deque）
+
+// --- Chase-Lev deque関連（--scheduler chaselev） ---
+#ifndef CHASELEV_CAPACITY
+#define CHASELEV_CAPACITY 4096          // 各ワーカーのdequeの容量（2のべき乗、ワーカーごとの配列サイズ）
+#endif
+#ifndef CHASELEV_IDLE_MAX_US
+#define CHASELEV_IDLE_MAX_US 1000       // 盗めなかったときのバックオフ待機の上限（マイクロ秒）
+#endif
+
 // --- トランスポジションテーブル関連 ---
 #ifndef TT_SIZE_MB
 #define TT_SIZE_MB 10240                 // TTサイズ（MB）
@@ -165,6 +196,22 @@ static DebugConfig DEBUG_CONFIG = {0};
 #define LOCAL_EXPORT_THRESHOLD (CHUNK_SIZE + 4)  // チャンク数+4 (16+4=20)
 #endif
 
+// --- 階層キューのあふれ閾値（--queues hier） ---
+// エクスポートしたチャンクは自分のL3ドメインのキューに入れ、そのキューがこのチャンク数に
+// 達していたら1つ上（ソケット → 全体）のキューに入れる
+#ifndef QUEUE_HIER_L3_SPILL
+#define QUEUE_HIER_L3_SPILL 4
+#endif
+#ifndef QUEUE_HIER_SOCKET_SPILL
+#define QUEUE_HIER_SOCKET_SPILL 16
+#endif
+
+// --- MultiQueueのサブヒープ数（--queues multiqueue） ---
+// サブヒープ数 = c × スレッド数。実行時に --mq-c で変更可能
+#ifndef DEFAULT_MQ_C
+#define DEFAULT_MQ_C 2
+#endif
+
 // --- タスクスポーン関連 ---
 // 実行時に -G, -D, -S オプションで変更可能
 // 40コアチューニング結果: G=4, D=5, S=5 が最短実行時間（235.5秒）
@@ -180,6 +227,191 @@ static DebugConfig DEBUG_CONFIG = {0};
 #define DEFAULT_SPAWN_LIMIT_PER_NODE 9999  // ノードあたりの最大スポーン数（-S で変更）
 #endif
 
+// --- ノードメモリ予算関連 ---
+// 実行時に --node-budget オプションで変更可能
+// ワーカーあたりの生存DFPNNode数の上限。超えそうになると部分木をTTに畳み込んで回収する
+#ifndef DEFAULT_NODE_BUDGET
+#define DEFAULT_NODE_BUDGET 0           // 0 = 無制限（従来動作）
+#endif
+
+#ifndef NODE_GC_LOW_WATERMARK
+#define NODE_GC_LOW_WATERMARK 75        // GC後の目標生存ノード数（予算に対する%）
+#endif
+
+// --- df-pnしきい値関連 ---
+// 実行時に --epsilon オプションで変更可能
+// 1+ε しきい値: 最良子のしきい値を max(2番手+1, ⌈2番手×(1+ε)⌉) に広げ、兄弟間の往復を減らす
+#ifndef DEFAULT_DFPN_EPSILON
+#define DEFAULT_DFPN_EPSILON -1.0       // 負 = 木エンジンは従来のしきい値（ttエンジンは ε=0）
+#endif
+
+// --- 葉ノードのpn/dn初期化関連 ---
+// 実行時に --pn-init オプションで初期化方式を選択（unit / mobility / eval / mobility+eval）
+#ifndef PNDN_EVAL_SCALE
+#define PNDN_EVAL_SCALE 8               // 評価値（石差）何石ごとにpn/dnを1増やすか
+#endif
+
+#ifndef PNDN_INIT_MAX
+#define PNDN_INIT_MAX 32                // ヒューリスティック初期値の上限
+#endif
+
+// --- pn/dn集約関連 ---
+// 実行時に --aggregate classic|wpn|hybrid, --agg-hybrid-empties で変更可能
+#ifndef DEFAULT_AGG_HYBRID_MIN_EMPTIES
+#define DEFAULT_AGG_HYBRID_MIN_EMPTIES 16   // hybrid: この空きマス数以上のノードでWPNを使う
+#endif
+
+// 実行時に --dag on|off で変更可能
+#ifndef DEFAULT_DAG_PNDN
+#define DEFAULT_DAG_PNDN 0              // TTのソースマーカーで合流を検出し、和の二重計上を補正する
+#endif
+
+// --- Deep Proof Number 選択関連 ---
+// 実行時に --dpn-r オプションで変更可能（Deep_Pns_benchmark.c の R と同じ意味）
+//   R = 1: 純粋な証明数選択、R = 0: 深さ優先、0 < R < 1: 両者の混合
+#ifndef DEFAULT_DPN_R
+#define DEFAULT_DPN_R -1.0              // 負 = DPN選択を使わない（従来の選択）
+#endif
+
+// --- 石差の完全解析関連 ---
+// 実行時に --exact で有効化、--exact-groups で同時に証明するしきい値の数を変更可能
+#ifndef DEFAULT_EXACT_GROUPS
+#define DEFAULT_EXACT_GROUPS 3          // 1ラウンドで同時に証明する「石差 >= k」の数
+#endif
+
+#ifndef MAX_EXACT_GROUPS
+#define MAX_EXACT_GROUPS 16
+#endif
+
+#ifndef EXACT_ASPIRATION
+#define EXACT_ASPIRATION 4              // 初回ラウンドの窓の半幅（石差、グループあたり）
+#endif
+
+#ifndef MAX_EXACT_QUERIES
+#define MAX_EXACT_QUERIES 128           // 記録するしきい値証明の最大数（BenchmarkResultのサイズに影響）
+#endif
+
+// --- 手の順序付け関連 ---
+// 実行時に --ordering none|eval|history|eval+history で変更可能
+#ifndef HISTORY_SCALE
+#define HISTORY_SCALE 16                // 履歴スコアが最大の手に加える優先度（評価値の石差と同じ単位）
+#endif
+
+#ifndef KILLER_BONUS
+#define KILLER_BONUS 8                  // キラー手（1番目）に加える優先度、2番目はその半分
+#endif
+
+#ifndef HISTORY_BUCKETS
+#define HISTORY_BUCKETS 16              // 履歴表の空きマス数の区分（空きマス数 / 4）
+#endif
+
+// 実行時に --endgame-order <n> で変更可能
+#ifndef DEFAULT_ENDGAME_ORDER_EMPTIES
+#define DEFAULT_ENDGAME_ORDER_EMPTIES 64 // 評価値の代わりに終盤用の順序付けを使う空きマス数の上限（64: 全域、評価値を使う指定がなければ）
+#endif
+
+#ifndef ENDGAME_MOBILITY_WEIGHT
+#define ENDGAME_MOBILITY_WEIGHT 4       // 終盤用の順序付け: 相手の合法手1つあたりの減点（隅は2つ分）
+#endif
+
+#ifndef ENDGAME_PARITY_BONUS
+#define ENDGAME_PARITY_BONUS 3          // 終盤用の順序付け: 空きマスが奇数の象限に打つ手への加点
+#endif
+
+// --- 評価関数の増分計算関連 ---
+// 実行時に --eval-incremental on|off で変更可能
+#ifndef DEFAULT_EVAL_INCREMENTAL
+#define DEFAULT_EVAL_INCREMENTAL 1      // 特徴量を着手・返した石から差分更新し、子の評価を表引きだけにする
+#endif
+
+#ifndef EVAL_PATH_MAX
+#define EVAL_PATH_MAX 128               // ワーカーごとの特徴量スタックの深さ（超えた分は毎回作り直す）
+#endif
+
+// --- 評価関数の重みキャッシュ関連 ---
+// 実行時に --eval-cache on|off|<path> で変更可能
+#ifndef DEFAULT_EVAL_CACHE
+#define DEFAULT_EVAL_CACHE 0            // 1: 展開済みの重みをファイルに保存し、次回から mmap で読む
+#endif
+
+#ifndef EVAL_CACHE_SUFFIX
+#define EVAL_CACHE_SUFFIX ".wcache"     // キャッシュファイル名（既定: <eval.dat> + この接尾辞）
+#endif
+
+// --- 評価関数の重みのNUMA複製関連 ---
+// 実行時に --eval-numa on|off で変更可能
+#ifndef DEFAULT_EVAL_NUMA
+#define DEFAULT_EVAL_NUMA 0             // 重みをNUMAノードごとに複製し、ワーカーは自分のノードの複製を読む
+#endif
+
+#ifndef EVAL_NUMA_MAX_NODES
+#define EVAL_NUMA_MAX_NODES 16          // 扱うNUMAノード数の上限
+#endif
+
+#ifndef EVAL_NUMA_MIN_NODES
+#define EVAL_NUMA_MIN_NODES 2           // CPUを持つノードがこれ未満なら複製しない
+#endif
+
+// --- 評価関数のまとめ評価関連 ---
+// 実行時に --eval-batch on|off で変更可能
+#ifndef DEFAULT_EVAL_BATCH
+#define DEFAULT_EVAL_BATCH 1            // 展開時に兄弟の子をまとめて評価し、gather を兄弟間で重ねる
+#endif
+
+#ifndef EVAL_BATCH_WIDTH
+#define EVAL_BATCH_WIDTH 4              // gather を交互に発行する兄弟の数
+#endif
+
+// --- 評価値キャッシュ関連 ---
+// 実行時に --eval-hash <MB>|off で変更可能
+#ifndef DEFAULT_EVAL_HASH_MB
+#define DEFAULT_EVAL_HASH_MB 16         // 局面 → 評価値の表（全ワーカーで共有、0: 使わない）
+#endif
+
+// --- 子の評価の遅延・省略関連 ---
+// 実行時に --eval-lazy on|off、--eval-min-empties <n> で変更可能
+#ifndef DEFAULT_EVAL_LAZY
+#define DEFAULT_EVAL_LAZY 0             // 子は安い順序付けで作り、評価関数は親を2回目に訪れたときに呼ぶ
+#endif
+
+#ifndef DEFAULT_EVAL_MIN_EMPTIES
+#define DEFAULT_EVAL_MIN_EMPTIES 0      // 空きマス数がこれ未満のノードでは子を評価しない（0: 常に評価）
+#endif
+
+// --- Enhanced Transposition Cutoff関連 ---
+// 実行時に --etc on|off で変更可能
+#ifndef DEFAULT_ETC
+#define DEFAULT_ETC 1                   // 展開時に全ての子をTTで引き、証明済みの子で親を即座に証明する
+#endif
+
+// --- 確定石による早期証明関連 ---
+// 実行時に --stability on|off で変更可能
+#ifndef DEFAULT_STABILITY_CUTOFF
+#define DEFAULT_STABILITY_CUTOFF 1      // 展開前に確定石数で証明目標を判定する
+#endif
+
+#ifndef STABILITY_MIN_EMPTIES
+#define STABILITY_MIN_EMPTIES 4         // これ未満の空きマスでは判定しない（終局まで探索した方が安い）
+#endif
+
+// --- 読み筋・証明木関連 ---
+// 結果が確定したら共有TTから読み筋（PV）を取り出す。--proof-dump <file> で証明木をバイナリ出力
+#ifndef MAX_PV_LENGTH
+#define MAX_PV_LENGTH 80                // 読み筋の最大長（パスを含む）
+#endif
+
+#ifndef PV_LOCAL_NODE_LIMIT
+#define PV_LOCAL_NODE_LIMIT 2000000     // 読み筋: TTに無い局面を逐次探索で証明するときのノード上限
+#endif
+
+#ifndef PROOF_DUMP_MAX_RECORDS
+#define PROOF_DUMP_MAX_RECORDS 20000000 // 証明木: 出力する最大レコード数（超えた部分は未証明として打ち切り）
+#endif
+
+#ifndef PROOF_DUMP_LOCAL_NODE_LIMIT
+#define PROOF_DUMP_LOCAL_NODE_LIMIT 100000000  // 証明木: 逐次探索の合計ノード上限
+#endif
+
 // --- デバッグ・統計関連 ---
 // 実行時に -v, -w, -t, -s, -m 等のオプションで有効化
 //
@@ -201,6 +433,21 @@ static DebugConfig DEBUG_CONFIG = {0};
 #define ENABLE_HYBRID_STATS 1           // ハイブリッド統計を有効化 (0/1)
 #endif
 
+// --- 探索の計測コード ---
+// コンパイル時に -DENABLE_SEARCH_INSTRUMENTATION=0 で、ノードごとの -t / -s の計測
+// （スレッド活動・探索木統計）をホットパスから取り除く（本番用ビルド）
+#ifndef ENABLE_SEARCH_INSTRUMENTATION
+#define ENABLE_SEARCH_INSTRUMENTATION 1 // ノードごとの計測を有効化 (0/1)
+#endif
+
+#if ENABLE_SEARCH_INSTRUMENTATION
+#define TRACK_TREE_STATS(w) (DEBUG_CONFIG.track_tree_stats && (w)->tree_stats)
+#define TRACK_THREADS(w)    (DEBUG_CONFIG.track_threads && (w)->stats)
+#else
+#define TRACK_TREE_STATS(w) 0
+#define TRACK_THREADS(w)    0
+#endif
+
 #ifndef VERBOSE_EXPORT_IMPORT
 #define VERBOSE_EXPORT_IMPORT 0         // エクスポート/インポート詳細ログ (0/1)
 #endif
@@ -240,6 +487,18 @@ static DebugConfig DEBUG_CONFIG = {0};
 #define ENABLE_EVAL_IMPACT 1             // 評価関数影響分析 (0=無効, 1=有効)
 #endif
 
+// --exact: しきい値1つ（「石差 >= target」の証明1回）の結果とコスト
+typedef struct {
+    int target;
+    int round;
+    char result[8];         // "ge" = 石差 >= target, "lt" = 石差 < target, "unknown"
+    bool cancelled;         // 他のしきい値の結果で答えが決まり打ち切った
+    int best_move;
+    int threads;
+    uint64_t nodes;
+    double time_sec;
+} ExactQueryStat;
+
 // Benchmark result structure for output
 typedef struct {
     char filename[256];
@@ -254,19 +513,130 @@ typedef struct {
     uint64_t tt_stores;
     uint64_t tt_collisions;
     double tt_hit_rate;
+    // Evaluation cache (--eval-hash): 表の大きさ、引いた子の数とヒット数
+    int eval_hash_mb;
+    uint64_t eval_hash_entries;
+    uint64_t eval_hash_probes;
+    uint64_t eval_hash_hits;
     int spawn_max_gen;
     int spawn_min_depth;
     int spawn_limit;
     uint64_t subtasks_spawned;
     uint64_t subtasks_completed;
+    // Task scheduler (--scheduler): dequeへのpush/pop数と、盗みの試行・成功・競合負けの数
+    char scheduler[16];
+    uint64_t deque_pushes;
+    uint64_t deque_pops;
+    uint64_t steal_attempts;
+    uint64_t steals;
+    uint64_t steal_aborts;
+    // Chunk queue layout (--queues): 段ごとのチャンクのpush/pop数
+    char queue_layout[16];
+    int queue_l3_domains;
+    int queue_sockets;
+    uint64_t queue_l3_pushed;
+    uint64_t queue_socket_pushed;
+    uint64_t queue_global_pushed;
+    uint64_t queue_l3_popped;
+    uint64_t queue_socket_popped;
+    uint64_t queue_global_popped;
+    uint64_t queue_remote_l3_popped;
+    int queue_mq_heaps;
+    uint64_t queue_mq_lock_fails;
     int num_threads;
     int win_count;
     int lose_count;
     int draw_count;
     int unknown_count;
+    // Node memory (--node-budget)
+    char engine[8];
+    uint64_t node_bytes;
+    uint64_t node_budget;
+    uint64_t peak_live_nodes;
+    uint64_t gc_runs;
+    uint64_t gc_nodes_freed;
+    // Threshold control (--epsilon)
+    double epsilon;
+    uint64_t sibling_switches;
+    uint64_t max_node_switches;
+    uint64_t reexpansions;
+    char pn_init[16];
+    char eval_kernel[16];
+    // 重みの読み込み（--eval-cache）: 読み込み元と所要時間
+    char eval_load_source[16];
+    double eval_load_ms;
+    char aggregation[8];
+    int agg_hybrid_min_empties;
+    // DAG-aware sums (--dag): 合流の検出数と、和を補正したpn/dn更新の数
+    bool dag;
+    uint64_t dag_transpositions;
+    uint64_t dag_corrections;
+    // Child ordering (--ordering): 親を証明した子の数と、そのうち最初に並べた子だった数
+    char ordering[16];
+    uint64_t ordering_cutoffs;
+    uint64_t ordering_first_cutoffs;
+    uint64_t history_updates;
+    int endgame_order_empties;
+    uint64_t endgame_order_expansions;
+    // Enhanced transposition cutoff (--etc): 展開時にTTを引いた子の数、ヒット数、親を証明した展開数
+    bool etc;
+    uint64_t etc_probes;
+    uint64_t etc_hits;
+    uint64_t etc_cutoffs;
+    // Incremental evaluation (--eval-incremental): 差分で評価した子の数と、特徴量を作り直した数
+    bool eval_incremental;
+    uint64_t eval_incremental_evals;
+    uint64_t eval_feature_rebuilds;
+    // Batched evaluation (--eval-batch): まとめて評価した回数と子の数
+    bool eval_batch;
+    uint64_t eval_batches;
+    uint64_t eval_batched_children;
+    // Lazy / gated evaluation (--eval-lazy, --eval-min-empties): 評価した子、遅らせた子、
+    // 2回目の訪問で評価した子、しきい値で省いた子の数
+    bool eval_lazy;
+    int eval_min_empties;
+    uint64_t eval_child_evals;
+    uint64_t eval_lazy_deferred;
+    uint64_t eval_lazy_resolved;
+    uint64_t eval_gated;
+    // NUMA replicas (--eval-numa): 複製したノード数、ノードごとのワーカー数、ワーカーが複製を替えた回数
+    bool eval_numa;
+    int eval_numa_nodes;
+    int eval_numa_workers[EVAL_NUMA_MAX_NODES];
+    uint64_t eval_numa_switches;
+    // Stable-disc cutoffs (--stability): 空きマス数ごとの判定対象ノード数と証明数
+    bool stability;
+    uint64_t stability_nodes[65];
+    uint64_t stability_cuts[65];
+    double dpn_r;
+    // Exact score (--exact)
+    bool exact;
+    int exact_lower;            // 証明済みの石差の範囲（lower == upper で確定）
+    int exact_upper;
+    int exact_groups;
+    int exact_rounds;
+    int n_exact_queries;        // --exact のしきい値、または勝敗判定・--at-least/--at-most の問い
+    ExactQueryStat exact_queries[MAX_EXACT_QUERIES];
+    // Score-threshold query (--at-least / --at-most)
+    bool query;
+    char query_op[4];           // "ge" / "le"
+    int query_k;
+    char query_answer[8];       // "yes" / "no" / "unknown"
+    // Principal variation / proof tree (--proof-dump)
+    int pv_len;
+    int pv[MAX_PV_LENGTH];      // 手（0-63）、パス = PV_PASS
+    bool pv_complete;           // 終局まで届いた
+    int pv_final_score;         // 終局の石差（手番側視点、pv_complete のとき）
+    int pv_target;              // 読み筋が示す証明（石差 >= pv_target か < pv_target か）
+    bool pv_goal;
+    double pv_time_sec;
+    char proof_file[256];
+    uint64_t proof_records;
+    uint64_t proof_unproven;
     // Per-worker stats
     uint64_t worker_nodes[MAX_THREADS];
     uint64_t worker_tasks[MAX_THREADS];
+    double worker_idle_ms[MAX_THREADS];     // タスクを得られず待っていた時間
 } BenchmarkResult;
 
 static BenchmarkResult g_benchmark_result = {0};
@@ -281,6 +651,153 @@ static int SPAWN_MAX_GENERATION = DEFAULT_SPAWN_MAX_GENERATION;
 static int SPAWN_MIN_DEPTH = DEFAULT_SPAWN_MIN_DEPTH;
 static int SPAWN_LIMIT_PER_NODE = DEFAULT_SPAWN_LIMIT_PER_NODE;
 
+// Per-worker live node budget (--node-budget, 0 = unlimited)
+static uint64_t NODE_BUDGET = DEFAULT_NODE_BUDGET;
+
+// df-pn engine selection (--engine)
+typedef enum {
+    ENGINE_TREE,    // DFPNNode木を保持する従来エンジン（dfpn_solve_node）
+    ENGINE_TT       // 現在のパスのみ保持し、子のpn/dnをTT経由で扱う深さ優先エンジン
+} SearchEngine;
+
+static SearchEngine SEARCH_ENGINE = ENGINE_TREE;
+
+// 1+ε threshold (--epsilon, negative = legacy tree thresholds)
+static double DFPN_EPSILON = DEFAULT_DFPN_EPSILON;
+
+// pn/dn aggregation of the summed side (--aggregate)
+typedef enum {
+    AGG_CLASSIC,    // 和（ORのdn / ANDのpn = 子の総和）
+    AGG_WPN,        // Weak Proof Number: max + (未解決の子の数 - 1)
+    AGG_HYBRID      // 空きマス数 >= AGG_HYBRID_MIN_EMPTIES ならWPN、それ未満は和
+} PnAggregation;
+
+static PnAggregation PN_AGGREGATION = AGG_CLASSIC;
+static int AGG_HYBRID_MIN_EMPTIES = DEFAULT_AGG_HYBRID_MIN_EMPTIES;
+
+// Transposition (DAG) aware sums (--dag)
+static bool DAG_PNDN = DEFAULT_DAG_PNDN;
+
+// Deep proof number selection (--dpn-r, negative = off)
+static double DPN_R = DEFAULT_DPN_R;
+
+// Enhanced transposition cutoff at expansion (--etc)
+static bool ETC_ENABLED = DEFAULT_ETC;
+
+// Incremental pattern features (--eval-incremental)
+static bool EVAL_INCREMENTAL = DEFAULT_EVAL_INCREMENTAL;
+
+// Batched sibling evaluation (--eval-batch)
+static bool EVAL_BATCH = DEFAULT_EVAL_BATCH;
+
+// Shared evaluation result cache (--eval-hash)
+static int EVAL_HASH_MB = DEFAULT_EVAL_HASH_MB;
+
+// Lazy / gated child evaluation (--eval-lazy, --eval-min-empties)
+static bool EVAL_LAZY = DEFAULT_EVAL_LAZY;
+static int EVAL_MIN_EMPTIES = DEFAULT_EVAL_MIN_EMPTIES;
+
+// Pre-unpacked weight cache (--eval-cache)
+static bool EVAL_CACHE = DEFAULT_EVAL_CACHE;
+
+// NUMA-replicated evaluation weights (--eval-numa)
+static bool EVAL_NUMA = DEFAULT_EVAL_NUMA;
+static const char *EVAL_CACHE_FILE = NULL;     // NULL: <eval.dat> + EVAL_CACHE_SUFFIX
+
+// Child ordering (--ordering)
+typedef enum {
+    ORDER_NONE,         // 着手生成順（評価関数を呼ばない）
+    ORDER_EVAL,         // 評価値のみ（従来）
+    ORDER_HISTORY,      // ワーカーごとの履歴表・キラー手のみ（評価関数を呼ばない）
+    ORDER_EVAL_HISTORY  // 評価値 + 履歴表・キラー手
+} OrderingMode;
+
+static OrderingMode MOVE_ORDERING = ORDER_EVAL;
+
+// 空きマス数がこれ以下のノードでは評価値の代わりに終盤用の順序付けを使う（--endgame-order）
+// -1: 未指定。main で評価値を使う指定の有無を見て 0 か DEFAULT_ENDGAME_ORDER_EMPTIES に決める
+static int ENDGAME_ORDER_EMPTIES = -1;
+
+static const char *ordering_name(OrderingMode mode) {
+    switch (mode) {
+        case ORDER_NONE:         return "none";
+        case ORDER_EVAL:         return "eval";
+        case ORDER_HISTORY:      return "history";
+        case ORDER_EVAL_HISTORY: return "eval+history";
+    }
+    return "?";
+}
+
+static inline bool ordering_uses_eval(void) {
+    return MOVE_ORDERING == ORDER_EVAL || MOVE_ORDERING == ORDER_EVAL_HISTORY;
+}
+
+static inline bool ordering_uses_history(void) {
+    return MOVE_ORDERING == ORDER_HISTORY || MOVE_ORDERING == ORDER_EVAL_HISTORY;
+}
+
+// Stable-disc cutoffs (--stability)
+static bool STABILITY_CUTOFF = DEFAULT_STABILITY_CUTOFF;
+
+// Exact score (--exact, --exact-groups)
+#ifdef STANDALONE_MAIN
+static bool EXACT_MODE = false;
+static int EXACT_GROUPS = DEFAULT_EXACT_GROUPS;
+#endif
+
+// Score-threshold query (--at-least k, --at-most k)
+typedef enum {
+    QUERY_NONE,
+    QUERY_AT_LEAST,     // 手番側の最終石差 >= k か
+    QUERY_AT_MOST       // 手番側の最終石差 <= k か
+} QueryOp;
+
+#ifdef STANDALONE_MAIN
+static QueryOp QUERY_OP = QUERY_NONE;
+static int QUERY_K = 0;
+#endif
+
+// Proof tree dump (--proof-dump <file>, NULL = off)
+static const char *PROOF_DUMP_FILE = NULL;
+
+// Task scheduler backend (--scheduler)
+typedef enum {
+    SCHED_HYBRID,       // LocalHeap + GlobalChunkQueue + SharedTaskArray（従来）
+    SCHED_CHASELEV      // ワーカーごとのChase-Lev deque（オーナーはLIFO、盗む側はFIFO）
+} TaskScheduler;
+
+static TaskScheduler TASK_SCHEDULER = SCHED_HYBRID;
+
+static const char *scheduler_name(TaskScheduler s) {
+    return (s == SCHED_CHASELEV) ? "chaselev" : "hybrid";
+}
+
+// GlobalChunkQueue layout (--queues)
+typedef enum {
+    QUEUES_FLAT,        // 全ワーカーで1つのGlobalChunkQueue（従来）
+    QUEUES_HIER,        // L3ドメイン → ソケット → 全体の3段
+    QUEUES_MULTIQUEUE   // c×スレッド数 個のサブヒープ（緩和優先度キュー）
+} QueueLayout;
+
+static QueueLayout QUEUE_LAYOUT = QUEUES_FLAT;
+static int MQ_C = DEFAULT_MQ_C;
+
+static const char *queue_layout_name(QueueLayout q) {
+    switch (q) {
+        case QUEUES_HIER:       return "hier";
+        case QUEUES_MULTIQUEUE: return "multiqueue";
+        default:                return "flat";
+    }
+}
+
+static const char *aggregation_name(PnAggregation agg) {
+    switch (agg) {
+        case AGG_WPN:    return "wpn";
+        case AGG_HYBRID: return "hybrid";
+        default:         return "classic";
+    }
+}
+
 // Work stealing statistics
 typedef struct {
     uint64_t tasks_stolen;
@@ -461,6 +978,45 @@ static void output_csv_result(const BenchmarkResult *r) {
 }
 
 // Output benchmark result to JSON file
+#define PV_PASS 64
+
+// 読み筋を "f5 d6 pass c3" 形式の文字列にする
+static void format_pv(char *buf, size_t size, const int *pv, int len) {
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < len && pos + 6 < size; i++) {
+        if (pv[i] == PV_PASS) {
+            pos += snprintf(buf + pos, size - pos, "%spass", i ? " " : "");
+        } else {
+            pos += snprintf(buf + pos, size - pos, "%s%c%d", i ? " " : "",
+                            'a' + (pv[i] % 8), 8 - (pv[i] / 8));
+        }
+    }
+}
+
+// 評価関数を呼ばずに済んだ子の数（遅らせたまま2回目の訪問がなかった子 + しきい値で省いた子）。
+// tt エンジンは子を訪問ごとに作り直すので、遅らせた子がTTから消えて再び評価されると resolved が上回りうる
+static uint64_t eval_evals_avoided(const BenchmarkResult *r) {
+    uint64_t pending = (r->eval_lazy_deferred > r->eval_lazy_resolved) ? r->eval_lazy_deferred - r->eval_lazy_resolved : 0;
+    return pending + r->eval_gated;
+}
+
+// 「石差 >= target」の問いごとの統計（--exact のしきい値 / 勝敗判定の問い）
+static void output_json_threshold_list(FILE *f, const BenchmarkResult *r) {
+    for (int i = 0; i < r->n_exact_queries; i++) {
+        const ExactQueryStat *q = &r->exact_queries[i];
+        char move_str[4] = "N/A";
+        if (q->best_move >= 0 && q->best_move < 64) {
+            snprintf(move_str, sizeof(move_str), "%c%d", 'a' + (q->best_move % 8), 8 - (q->best_move / 8));
+        }
+        fprintf(f, "      {\"round\": %d, \"target\": %d, \"result\": \"%s\", \"cancelled\": %s, "
+                   "\"best_move\": \"%s\", \"threads\": %d, \"nodes\": %llu, \"time_sec\": %.6f}%s\n",
+                q->round, q->target, q->result, q->cancelled ? "true" : "false", move_str, q->threads,
+                (unsigned long long)q->nodes, q->time_sec,
+                i < r->n_exact_queries - 1 ? "," : "");
+    }
+}
+
 static void output_json_result(const BenchmarkResult *r) {
     if (!DEBUG_CONFIG.output_json) return;
 
@@ -486,6 +1042,14 @@ static void output_json_result(const BenchmarkResult *r) {
     fprintf(f, "    \"collisions\": %llu,\n", (unsigned long long)r->tt_collisions);
     fprintf(f, "    \"hit_rate\": %.2f\n", r->tt_hit_rate);
     fprintf(f, "  },\n");
+    fprintf(f, "  \"eval_hash\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->eval_hash_entries ? "true" : "false");
+    fprintf(f, "    \"size_mb\": %d,\n", r->eval_hash_mb);
+    fprintf(f, "    \"entries\": %llu,\n", (unsigned long long)r->eval_hash_entries);
+    fprintf(f, "    \"probes\": %llu,\n", (unsigned long long)r->eval_hash_probes);
+    fprintf(f, "    \"hits\": %llu,\n", (unsigned long long)r->eval_hash_hits);
+    fprintf(f, "    \"hit_rate\": %.2f\n", r->eval_hash_probes ? 100.0 * r->eval_hash_hits / r->eval_hash_probes : 0.0);
+    fprintf(f, "  },\n");
     fprintf(f, "  \"spawn_settings\": {\n");
     fprintf(f, "    \"max_generation\": %d,\n", r->spawn_max_gen);
     fprintf(f, "    \"min_depth\": %d,\n", r->spawn_min_depth);
@@ -495,7 +1059,182 @@ static void output_json_result(const BenchmarkResult *r) {
     fprintf(f, "    \"spawned\": %llu,\n", (unsigned long long)r->subtasks_spawned);
     fprintf(f, "    \"completed\": %llu\n", (unsigned long long)r->subtasks_completed);
     fprintf(f, "  },\n");
+    fprintf(f, "  \"scheduler\": \"%s\",\n", r->scheduler);
+    fprintf(f, "  \"deque_stealing\": {\n");
+    fprintf(f, "    \"deque_pushes\": %llu,\n", (unsigned long long)r->deque_pushes);
+    fprintf(f, "    \"deque_pops\": %llu,\n", (unsigned long long)r->deque_pops);
+    fprintf(f, "    \"steal_attempts\": %llu,\n", (unsigned long long)r->steal_attempts);
+    fprintf(f, "    \"steals\": %llu,\n", (unsigned long long)r->steals);
+    fprintf(f, "    \"steal_aborts\": %llu,\n", (unsigned long long)r->steal_aborts);
+    fprintf(f, "    \"steal_success_rate\": %.2f\n", r->steal_attempts ? 100.0 * r->steals / r->steal_attempts : 0.0);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"chunk_queues\": {\n");
+    fprintf(f, "    \"layout\": \"%s\",\n", r->queue_layout);
+    fprintf(f, "    \"l3_domains\": %d,\n", r->queue_l3_domains);
+    fprintf(f, "    \"sockets\": %d,\n", r->queue_sockets);
+    fprintf(f, "    \"l3_pushed\": %llu,\n", (unsigned long long)r->queue_l3_pushed);
+    fprintf(f, "    \"socket_pushed\": %llu,\n", (unsigned long long)r->queue_socket_pushed);
+    fprintf(f, "    \"global_pushed\": %llu,\n", (unsigned long long)r->queue_global_pushed);
+    fprintf(f, "    \"l3_popped\": %llu,\n", (unsigned long long)r->queue_l3_popped);
+    fprintf(f, "    \"socket_popped\": %llu,\n", (unsigned long long)r->queue_socket_popped);
+    fprintf(f, "    \"global_popped\": %llu,\n", (unsigned long long)r->queue_global_popped);
+    fprintf(f, "    \"remote_l3_popped\": %llu,\n", (unsigned long long)r->queue_remote_l3_popped);
+    fprintf(f, "    \"mq_heaps\": %d,\n", r->queue_mq_heaps);
+    fprintf(f, "    \"mq_lock_fails\": %llu\n", (unsigned long long)r->queue_mq_lock_fails);
+    fprintf(f, "  },\n");
     fprintf(f, "  \"num_threads\": %d,\n", r->num_threads);
+    fprintf(f, "  \"pn_init\": \"%s\",\n", r->pn_init);
+    fprintf(f, "  \"eval_kernel\": \"%s\",\n", r->eval_kernel);
+    fprintf(f, "  \"eval_load\": {\n");
+    fprintf(f, "    \"source\": \"%s\",\n", r->eval_load_source);
+    fprintf(f, "    \"time_ms\": %.3f\n", r->eval_load_ms);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"aggregation\": \"%s\",\n", r->aggregation);
+    fprintf(f, "  \"agg_hybrid_min_empties\": %d,\n", r->agg_hybrid_min_empties);
+    fprintf(f, "  \"ordering\": {\n");
+    fprintf(f, "    \"mode\": \"%s\",\n", r->ordering);
+    fprintf(f, "    \"cutoffs\": %llu,\n", (unsigned long long)r->ordering_cutoffs);
+    fprintf(f, "    \"first_child_cutoffs\": %llu,\n", (unsigned long long)r->ordering_first_cutoffs);
+    fprintf(f, "    \"first_child_rate\": %.6f,\n",
+            r->ordering_cutoffs ? (double)r->ordering_first_cutoffs / r->ordering_cutoffs : 0.0);
+    fprintf(f, "    \"history_updates\": %llu,\n", (unsigned long long)r->history_updates);
+    fprintf(f, "    \"endgame_empties\": %d,\n", r->endgame_order_empties);
+    fprintf(f, "    \"endgame_expansions\": %llu\n", (unsigned long long)r->endgame_order_expansions);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"etc\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->etc ? "true" : "false");
+    fprintf(f, "    \"probes\": %llu,\n", (unsigned long long)r->etc_probes);
+    fprintf(f, "    \"hits\": %llu,\n", (unsigned long long)r->etc_hits);
+    fprintf(f, "    \"hit_rate\": %.2f,\n", r->etc_probes ? 100.0 * r->etc_hits / r->etc_probes : 0.0);
+    fprintf(f, "    \"cutoffs\": %llu\n", (unsigned long long)r->etc_cutoffs);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"eval_incremental\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->eval_incremental ? "true" : "false");
+    fprintf(f, "    \"evals\": %llu,\n", (unsigned long long)r->eval_incremental_evals);
+    fprintf(f, "    \"feature_rebuilds\": %llu\n", (unsigned long long)r->eval_feature_rebuilds);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"eval_batch\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->eval_batch ? "true" : "false");
+    fprintf(f, "    \"width\": %d,\n", EVAL_BATCH_WIDTH);
+    fprintf(f, "    \"batches\": %llu,\n", (unsigned long long)r->eval_batches);
+    fprintf(f, "    \"children\": %llu,\n", (unsigned long long)r->eval_batched_children);
+    fprintf(f, "    \"avg_children\": %.3f\n", r->eval_batches ? (double)r->eval_batched_children / r->eval_batches : 0.0);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"eval_lazy\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->eval_lazy ? "true" : "false");
+    fprintf(f, "    \"min_empties\": %d,\n", r->eval_min_empties);
+    fprintf(f, "    \"evaluated\": %llu,\n", (unsigned long long)r->eval_child_evals);
+    fprintf(f, "    \"deferred\": %llu,\n", (unsigned long long)r->eval_lazy_deferred);
+    fprintf(f, "    \"resolved\": %llu,\n", (unsigned long long)r->eval_lazy_resolved);
+    fprintf(f, "    \"gated\": %llu,\n", (unsigned long long)r->eval_gated);
+    fprintf(f, "    \"avoided\": %llu\n", (unsigned long long)eval_evals_avoided(r));
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"eval_numa\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->eval_numa ? "true" : "false");
+    fprintf(f, "    \"replica_nodes\": %d,\n", r->eval_numa_nodes);
+    fprintf(f, "    \"workers_per_node\": [");
+    for (int n = 0; n < r->eval_numa_nodes; n++) {
+        fprintf(f, "%s%d", n ? ", " : "", r->eval_numa_workers[n]);
+    }
+    fprintf(f, "],\n");
+    fprintf(f, "    \"switches\": %llu\n", (unsigned long long)r->eval_numa_switches);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"dag\": {\n");
+    fprintf(f, "    \"enabled\": %s,\n", r->dag ? "true" : "false");
+    fprintf(f, "    \"transpositions\": %llu,\n", (unsigned long long)r->dag_transpositions);
+    fprintf(f, "    \"corrections\": %llu,\n", (unsigned long long)r->dag_corrections);
+    fprintf(f, "    \"corrections_per_node\": %.6f\n",
+            r->total_nodes ? (double)r->dag_corrections / r->total_nodes : 0.0);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"dpn_r\": %.3f,\n", r->dpn_r);
+    fprintf(f, "  \"node_memory\": {\n");
+    fprintf(f, "    \"engine\": \"%s\",\n", r->engine);
+    fprintf(f, "    \"node_bytes\": %llu,\n", (unsigned long long)r->node_bytes);
+    fprintf(f, "    \"budget_per_worker\": %llu,\n", (unsigned long long)r->node_budget);
+    fprintf(f, "    \"peak_live_nodes\": %llu,\n", (unsigned long long)r->peak_live_nodes);
+    fprintf(f, "    \"gc_runs\": %llu,\n", (unsigned long long)r->gc_runs);
+    fprintf(f, "    \"gc_nodes_freed\": %llu\n", (unsigned long long)r->gc_nodes_freed);
+    fprintf(f, "  },\n");
+    fprintf(f, "  \"threshold\": {\n");
+    fprintf(f, "    \"epsilon\": %.3f,\n", r->epsilon);
+    fprintf(f, "    \"sibling_switches\": %llu,\n", (unsigned long long)r->sibling_switches);
+    fprintf(f, "    \"max_switches_per_node\": %llu,\n", (unsigned long long)r->max_node_switches);
+    fprintf(f, "    \"reexpansions\": %llu\n", (unsigned long long)r->reexpansions);
+    fprintf(f, "  },\n");
+    if (r->exact) {
+        fprintf(f, "  \"exact\": {\n");
+        if (r->exact_lower == r->exact_upper) {
+            fprintf(f, "    \"score\": %d,\n", r->exact_lower);
+        } else {
+            fprintf(f, "    \"score\": null,\n");
+        }
+        fprintf(f, "    \"lower\": %d,\n", r->exact_lower);
+        fprintf(f, "    \"upper\": %d,\n", r->exact_upper);
+        fprintf(f, "    \"groups\": %d,\n", r->exact_groups);
+        fprintf(f, "    \"rounds\": %d,\n", r->exact_rounds);
+        fprintf(f, "    \"thresholds\": [\n");
+        output_json_threshold_list(f, r);
+        fprintf(f, "    ]\n");
+        fprintf(f, "  },\n");
+    } else {
+        if (r->query) {
+            fprintf(f, "  \"query\": {\n");
+            fprintf(f, "    \"op\": \"%s\",\n", r->query_op);
+            fprintf(f, "    \"k\": %d,\n", r->query_k);
+            fprintf(f, "    \"answer\": \"%s\"\n", r->query_answer);
+            fprintf(f, "  },\n");
+        }
+        fprintf(f, "  \"thresholds\": [\n");
+        output_json_threshold_list(f, r);
+        fprintf(f, "  ],\n");
+    }
+    {
+        uint64_t nodes = 0, cuts = 0;
+        for (int e = 0; e <= 64; e++) {
+            nodes += r->stability_nodes[e];
+            cuts += r->stability_cuts[e];
+        }
+        fprintf(f, "  \"stability\": {\n");
+        fprintf(f, "    \"enabled\": %s,\n", r->stability ? "true" : "false");
+        fprintf(f, "    \"nodes\": %llu,\n", (unsigned long long)nodes);
+        fprintf(f, "    \"cutoffs\": %llu,\n", (unsigned long long)cuts);
+        fprintf(f, "    \"cut_fraction\": %.6f,\n", nodes ? (double)cuts / nodes : 0.0);
+        fprintf(f, "    \"by_empties\": [");
+        bool first = true;
+        for (int e = 0; e <= 64; e++) {
+            if (!r->stability_nodes[e]) continue;
+            fprintf(f, "%s\n      {\"empties\": %d, \"nodes\": %llu, \"cutoffs\": %llu, \"cut_fraction\": %.6f}",
+                    first ? "" : ",", e, (unsigned long long)r->stability_nodes[e],
+                    (unsigned long long)r->stability_cuts[e],
+                    (double)r->stability_cuts[e] / r->stability_nodes[e]);
+            first = false;
+        }
+        fprintf(f, "%s]\n", first ? "" : "\n    ");
+        fprintf(f, "  },\n");
+    }
+    if (r->pv_len > 0) {
+        char pv_str[MAX_PV_LENGTH * 5 + 1];
+        format_pv(pv_str, sizeof(pv_str), r->pv, r->pv_len);
+        fprintf(f, "  \"pv\": {\n");
+        fprintf(f, "    \"moves\": \"%s\",\n", pv_str);
+        fprintf(f, "    \"length\": %d,\n", r->pv_len);
+        fprintf(f, "    \"proves\": \"score %s %d\",\n", r->pv_goal ? ">=" : "<", r->pv_target);
+        fprintf(f, "    \"complete\": %s,\n", r->pv_complete ? "true" : "false");
+        if (r->pv_complete) {
+            fprintf(f, "    \"final_score\": %d,\n", r->pv_final_score);
+        } else {
+            fprintf(f, "    \"final_score\": null,\n");
+        }
+        fprintf(f, "    \"time_sec\": %.6f\n", r->pv_time_sec);
+        fprintf(f, "  },\n");
+    }
+    if (r->proof_file[0]) {
+        fprintf(f, "  \"proof_tree\": {\n");
+        fprintf(f, "    \"file\": \"%s\",\n", r->proof_file);
+        fprintf(f, "    \"records\": %llu,\n", (unsigned long long)r->proof_records);
+        fprintf(f, "    \"unproven\": %llu\n", (unsigned long long)r->proof_unproven);
+        fprintf(f, "  },\n");
+    }
     fprintf(f, "  \"result_counts\": {\n");
     fprintf(f, "    \"win\": %d,\n", r->win_count);
     fprintf(f, "    \"lose\": %d,\n", r->lose_count);
@@ -504,9 +1243,9 @@ static void output_json_result(const BenchmarkResult *r) {
     fprintf(f, "  },\n");
     fprintf(f, "  \"worker_stats\": [\n");
     for (int i = 0; i < r->num_threads; i++) {
-        fprintf(f, "    {\"id\": %d, \"nodes\": %llu, \"tasks\": %llu}%s\n",
+        fprintf(f, "    {\"id\": %d, \"nodes\": %llu, \"tasks\": %llu, \"idle_ms\": %.1f}%s\n",
                 i, (unsigned long long)r->worker_nodes[i],
-                (unsigned long long)r->worker_tasks[i],
+                (unsigned long long)r->worker_tasks[i], r->worker_idle_ms[i],
                 i < r->num_threads - 1 ? "," : "");
     }
     fprintf(f, "  ]\n");
@@ -521,6 +1260,14 @@ static void output_json_result(const BenchmarkResult *r) {
 #define PN_INF 100000000
 #define DN_INF 100000000
 
+// 証明目標（target）: 「ルートムーブを打ったプレイヤーの最終石差 >= target」を
+// pn = 0（WIN）、「石差 < target」を dn = 0（LOSE）とする二値の問い。
+// 勝ち/負け/引き分けは target = 1（勝ちか）と target = 0（負けでないか）の2つの問いで決める
+#define SCORE_MIN (-64)
+#define SCORE_MAX 64
+#define SCORE_TARGET_WIN 1      // 石差 >= +1: 勝ち
+#define SCORE_TARGET_NOT_LOSE 0 // 石差 >= 0: 引き分け以上
+
 typedef enum {
     RESULT_UNKNOWN = 0,
     RESULT_EXACT_WIN = 1,
@@ -549,6 +1296,7 @@ typedef struct {
     int depth;              // Remaining empty squares
     NodeType node_type;     // OR or AND node
     int generation;         // Task generation (0=root, 1=child, 2=grandchild, ...)
+    int target;             // 証明目標（ルートムーブを打ったプレイヤーの石差 >= target）
 } Task;
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -599,6 +1347,47 @@ typedef struct {
     _Atomic uint32_t tail;       // push位置
 } SharedTaskArray;
 
+// ChaseLevDeque: ワーカーごとの作業盗み用deque（--scheduler chaselev）
+// オーナーは bottom 側でpush/pop（LIFO）、他のワーカーは top 側から盗む（FIFO）。
+// top（盗む側がCASする）と bottom（オーナーが書く）は別のキャッシュラインに置く
+typedef struct {
+    _Atomic int64_t top;         // 次に盗まれる位置
+    char pad_top[CACHE_LINE_SIZE - sizeof(int64_t)];
+    _Atomic int64_t bottom;      // 次にpushする位置
+    char pad_bottom[CACHE_LINE_SIZE - sizeof(int64_t)];
+    Task *tasks;                 // 環状配列 (CHASELEV_CAPACITY)
+
+    // 統計（オーナーのみ更新）
+    uint64_t pushes;
+    uint64_t pops;
+} __attribute__((aligned(CACHE_LINE_SIZE))) ChaseLevDeque;
+
+typedef enum {
+    STEAL_EMPTY,                 // 盗めるタスクがない
+    STEAL_ABORT,                 // 他のワーカー（オーナーか別の盗む側）とのCASに負けた
+    STEAL_OK
+} StealResult;
+
+// MultiQueueHeap: MultiQueue のサブヒープ（--queues multiqueue）
+// ロックは trylock で取る。隣のサブヒープとキャッシュラインを共有しないように揃える
+typedef struct {
+    pthread_mutex_t lock;
+    _Atomic int top_priority;    // 空の時は INT_MIN（ロックなしで参照）
+    int size;
+    Chunk *heap;                 // Binary max-heap (MQ_HEAP_CAPACITY)
+
+    // 統計
+    uint64_t chunks_pushed;
+    uint64_t chunks_popped;
+} __attribute__((aligned(CACHE_LINE_SIZE))) MultiQueueHeap;
+
+// ChunkMultiQueue: 緩和優先度キュー（GlobalChunkQueue の代わり）
+typedef struct {
+    MultiQueueHeap *heaps;       // [n_heaps]
+    int n_heaps;
+    _Atomic int size;            // 全サブヒープのチャンク数（空の判定用）
+} ChunkMultiQueue;
+
 // WorkerState: ワーカー起動状態追跡（ビットマップ方式 - 1024スレッド対応）
 //
 // 従来方式: _Atomic int busy_workers
@@ -778,6 +1567,49 @@ static void global_chunk_queue_destroy(GlobalChunkQueue *gq) {
     }
 }
 
+// チャンクのヒープ（top_priority の max-heap）への挿入と先頭の取り出し
+// 呼び出し側がロックを持ち、挿入前に空きを確かめる（GlobalChunkQueue と MultiQueue のサブヒープで共用）
+static void chunk_heap_insert(Chunk *heap, int *size, const Chunk *chunk) {
+    // Sift up
+    int i = *size;
+    (*size)++;
+
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (chunk->top_priority <= heap[parent].top_priority) {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = *chunk;
+}
+
+static void chunk_heap_remove_top(Chunk *heap, int *size, Chunk *out_chunk) {
+    *out_chunk = heap[0];
+    (*size)--;
+
+    int n = *size;
+    if (n > 0) {
+        Chunk last = heap[n];
+        int i = 0;
+
+        // Sift down
+        while (i * 2 + 1 < n) {
+            int child = i * 2 + 1;
+            if (child + 1 < n && heap[child + 1].top_priority > heap[child].top_priority) {
+                child++;
+            }
+            if (last.top_priority >= heap[child].top_priority) {
+                break;
+            }
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = last;
+    }
+}
+
 // Push chunk to GlobalChunkQueue
 static bool global_chunk_queue_push(GlobalChunkQueue *gq, const Chunk *chunk) {
     pthread_mutex_lock(&gq->mutex);
@@ -787,21 +1619,9 @@ static bool global_chunk_queue_push(GlobalChunkQueue *gq, const Chunk *chunk) {
         return false;
     }
 
-    // Sift up
-    int i = gq->size;
-    gq->size++;
+    chunk_heap_insert(gq->heap, &gq->size, chunk);
     gq->chunks_pushed++;
 
-    while (i > 0) {
-        int parent = (i - 1) / 2;
-        if (chunk->top_priority <= gq->heap[parent].top_priority) {
-            break;
-        }
-        gq->heap[i] = gq->heap[parent];
-        i = parent;
-    }
-    gq->heap[i] = *chunk;
-
     // Update atomic top_priority
     atomic_store(&gq->top_priority, gq->heap[0].top_priority);
 
@@ -821,28 +1641,10 @@ static bool global_chunk_queue_pop(GlobalChunkQueue *gq, Chunk *out_chunk) {
         return false;
     }
 
-    *out_chunk = gq->heap[0];
-    gq->size--;
+    chunk_heap_remove_top(gq->heap, &gq->size, out_chunk);
     gq->chunks_popped++;
 
     if (gq->size > 0) {
-        Chunk last = gq->heap[gq->size];
-        int i = 0;
-
-        // Sift down
-        while (i * 2 + 1 < gq->size) {
-            int child = i * 2 + 1;
-            if (child + 1 < gq->size && gq->heap[child + 1].top_priority > gq->heap[child].top_priority) {
-                child++;
-            }
-            if (last.top_priority >= gq->heap[child].top_priority) {
-                break;
-            }
-            gq->heap[i] = gq->heap[child];
-            i = child;
-        }
-        gq->heap[i] = last;
-
         // Update atomic top_priority
         atomic_store(&gq->top_priority, gq->heap[0].top_priority);
     } else {
@@ -927,20 +1729,302 @@ static bool shared_array_pop(SharedTaskArray *sa, Task *out_task) {
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// Evaluation Function Structures
+// Chase-Lev Deque Operations (--scheduler chaselev)
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// Lê, Pop, Cohen, Zappa Nardelli "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (PPoPP 2013) のC11版。配列は固定長（満杯ならpushが失敗し、
+// 呼び出し側はタスクを捨てずに自分で処理する）。
+
+#define CHASELEV_MASK (CHASELEV_CAPACITY - 1)
+
+// ワーカー数分のdequeを確保（ワーカーIDで添字）
+static ChaseLevDeque* chaselev_array_create(int n) {
+    ChaseLevDeque *dqs = aligned_alloc(CACHE_LINE_SIZE, n * sizeof(ChaseLevDeque));
+    memset(dqs, 0, n * sizeof(ChaseLevDeque));
+    for (int i = 0; i < n; i++) {
+        dqs[i].tasks = calloc(CHASELEV_CAPACITY, sizeof(Task));
+        atomic_store(&dqs[i].top, 0);
+        atomic_store(&dqs[i].bottom, 0);
+    }
+    return dqs;
+}
 
-typedef struct {
-    uint32_t n_square;
-    uint8_t x[12];
-} FeatureToCoordinate;
+static void chaselev_array_destroy(ChaseLevDeque *dqs, int n) {
+    if (dqs) {
+        for (int i = 0; i < n; i++) {
+            free(dqs[i].tasks);
+        }
+        free(dqs);
+    }
+}
 
-static int16_t ***EVAL_WEIGHT = NULL;
+// 残りタスク数（他スレッドから見ると概算）
+static inline int chaselev_size(ChaseLevDeque *dq) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+    return (b > t) ? (int)(b - t) : 0;
+}
 
-static const FeatureToCoordinate EVAL_F2X[] = {
-    { 9, {0, 1, 8, 9, 2, 16, 10, 17, 18}},
-    { 9, {7, 6, 15, 14, 5, 23, 13, 22, 21}},
-    { 9, {56, 48, 57, 49, 40, 58, 41, 50, 42}},
+// 次に盗まれるタスク（最も古いタスク）の優先度。盗む相手を選ぶための目安で、
+// 読んだ直後に盗まれていてもよい（空なら INT_MIN）
+static inline int chaselev_top_priority(ChaseLevDeque *dq) {
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    if (t >= b) {
+        return INT_MIN;
+    }
+    return dq->tasks[t & CHASELEV_MASK].priority;
+}
+
+// Push (NO LOCK - owner only)
+static bool chaselev_push(ChaseLevDeque *dq, const Task *task) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+
+    // Check if full（t は古い値でもよい: 実際の空きはこれ以上）
+    if (b - t >= CHASELEV_CAPACITY) {
+        return false;
+    }
+
+    dq->tasks[b & CHASELEV_MASK] = *task;
+    // タスクの書き込みを bottom の更新より先に他スレッドへ見せる
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    dq->pushes++;
+    return true;
+}
+
+// Pop (NO LOCK - owner only, LIFO)
+// 最後の1つだけは盗む側と取り合いになるので top をCASする
+static bool chaselev_pop(ChaseLevDeque *dq, Task *out_task) {
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+
+    if (t > b) {
+        // Empty
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+
+    *out_task = dq->tasks[b & CHASELEV_MASK];
+    if (t == b) {
+        // Last task: race against thieves
+        bool won = atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                           memory_order_seq_cst,
+                                                           memory_order_relaxed);
+        atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+        if (!won) {
+            return false;
+        }
+    }
+    dq->pops++;
+    return true;
+}
+
+// Steal (any thread, FIFO)
+// スロットを先に読み、top のCASに勝ったときだけ採用する（負けたら読んだ値は捨てる）
+static StealResult chaselev_steal(ChaseLevDeque *dq, Task *out_task) {
+    int64_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+
+    if (t >= b) {
+        return STEAL_EMPTY;
+    }
+
+    *out_task = dq->tasks[t & CHASELEV_MASK];
+    if (!atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return STEAL_ABORT;
+    }
+    return STEAL_OK;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// MultiQueue Operations (--queues multiqueue)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// Rihani, Sanders, Dementiev "MultiQueues: Simple Relaxed Concurrent Priority Queues"
+// (SPAA 2015)。チャンクを c×スレッド数 個のサブヒープに散らし、pushは乱数で選んだサブヒープへ、
+// popは乱数で選んだ2つのうち先頭の優先度が高い方から取る。ロックは trylock で取り、
+// 取れなければ待たずに選び直す。取り出す順は厳密な最良優先ではない（タスクの優先度は探索順の目安）。
+// 全体で共有する書き込みはチャンク数のカウンタ（チャンク1つに1回の atomic 加減算）だけ。
+
+// 乱数（xorshift64、状態は呼び出し側のスレッドが持つ）
+static inline uint64_t mq_random(uint64_t *rng) {
+    uint64_t x = *rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *rng = x;
+    return x;
+}
+
+static ChunkMultiQueue* chunk_mq_create(int n_heaps) {
+    ChunkMultiQueue *mq = calloc(1, sizeof(ChunkMultiQueue));
+    mq->heaps = aligned_alloc(CACHE_LINE_SIZE, n_heaps * sizeof(MultiQueueHeap));
+    memset(mq->heaps, 0, n_heaps * sizeof(MultiQueueHeap));
+    mq->n_heaps = n_heaps;
+    for (int i = 0; i < n_heaps; i++) {
+        pthread_mutex_init(&mq->heaps[i].lock, NULL);
+        mq->heaps[i].heap = calloc(MQ_HEAP_CAPACITY, sizeof(Chunk));
+        atomic_store(&mq->heaps[i].top_priority, INT_MIN);
+    }
+    atomic_store(&mq->size, 0);
+    return mq;
+}
+
+static void chunk_mq_destroy(ChunkMultiQueue *mq) {
+    if (mq) {
+        for (int i = 0; i < mq->n_heaps; i++) {
+            pthread_mutex_destroy(&mq->heaps[i].lock);
+            free(mq->heaps[i].heap);
+        }
+        free(mq->heaps);
+        free(mq);
+    }
+}
+
+// サブヒープへの挿入・取り出し（ロックを持って呼ぶ）
+static bool mq_heap_push_locked(MultiQueueHeap *h, const Chunk *chunk) {
+    if (h->size >= MQ_HEAP_CAPACITY) {
+        return false;
+    }
+    chunk_heap_insert(h->heap, &h->size, chunk);
+    h->chunks_pushed++;
+    atomic_store_explicit(&h->top_priority, h->heap[0].top_priority, memory_order_relaxed);
+    return true;
+}
+
+static bool mq_heap_pop_locked(MultiQueueHeap *h, Chunk *out_chunk) {
+    if (h->size == 0) {
+        return false;
+    }
+    chunk_heap_remove_top(h->heap, &h->size, out_chunk);
+    h->chunks_popped++;
+    atomic_store_explicit(&h->top_priority, (h->size > 0) ? h->heap[0].top_priority : INT_MIN,
+                          memory_order_relaxed);
+    return true;
+}
+
+// 乱数で選んだ2つのサブヒープの先頭の優先度の高い方（空なら INT_MIN）
+// 全サブヒープの最大ではなく、popが次に取る候補の目安
+static inline int chunk_mq_top_priority(ChunkMultiQueue *mq, uint64_t *rng) {
+    if (atomic_load_explicit(&mq->size, memory_order_relaxed) == 0) {
+        return INT_MIN;
+    }
+    uint64_t r = mq_random(rng);
+    uint64_t n = (uint64_t)mq->n_heaps;
+    int a = atomic_load_explicit(&mq->heaps[(r & 0xFFFFFFFFULL) % n].top_priority, memory_order_relaxed);
+    int b = atomic_load_explicit(&mq->heaps[(r >> 32) % n].top_priority, memory_order_relaxed);
+    return (a > b) ? a : b;
+}
+
+// Push: 乱数で選んだサブヒープに trylock で入れる（lock_fails: trylock に失敗した回数）
+static bool chunk_mq_push(ChunkMultiQueue *mq, const Chunk *chunk, uint64_t *rng, uint64_t *lock_fails) {
+    uint64_t n = (uint64_t)mq->n_heaps;
+    for (int attempt = 0; attempt < MQ_ATTEMPTS; attempt++) {
+        MultiQueueHeap *h = &mq->heaps[mq_random(rng) % n];
+        if (pthread_mutex_trylock(&h->lock) != 0) {
+            (*lock_fails)++;
+            continue;
+        }
+        bool ok = mq_heap_push_locked(h, chunk);
+        pthread_mutex_unlock(&h->lock);
+        if (ok) {
+            atomic_fetch_add_explicit(&mq->size, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 選び直しても入らない（競合か満杯）: 空きのあるサブヒープを順に探してロックを待つ
+    uint64_t start = mq_random(rng) % n;
+    for (uint64_t k = 0; k < n; k++) {
+        MultiQueueHeap *h = &mq->heaps[(start + k) % n];
+        if (h->size >= MQ_HEAP_CAPACITY) continue;
+        pthread_mutex_lock(&h->lock);
+        bool ok = mq_heap_push_locked(h, chunk);
+        pthread_mutex_unlock(&h->lock);
+        if (ok) {
+            atomic_fetch_add_explicit(&mq->size, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pop: 乱数で2つのサブヒープを選び、先頭の優先度が高い方から trylock で取る
+static bool chunk_mq_pop(ChunkMultiQueue *mq, Chunk *out_chunk, uint64_t *rng, uint64_t *lock_fails) {
+    if (atomic_load_explicit(&mq->size, memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    uint64_t n = (uint64_t)mq->n_heaps;
+    for (int attempt = 0; attempt < MQ_ATTEMPTS; attempt++) {
+        uint64_t r = mq_random(rng);
+        MultiQueueHeap *h = &mq->heaps[(r & 0xFFFFFFFFULL) % n];
+        MultiQueueHeap *other = &mq->heaps[(r >> 32) % n];
+        int top = atomic_load_explicit(&h->top_priority, memory_order_relaxed);
+        int other_top = atomic_load_explicit(&other->top_priority, memory_order_relaxed);
+        if (other_top > top) {
+            h = other;
+            top = other_top;
+        }
+        if (top == INT_MIN) continue;  // 両方空
+        if (pthread_mutex_trylock(&h->lock) != 0) {
+            (*lock_fails)++;
+            continue;
+        }
+        bool ok = mq_heap_pop_locked(h, out_chunk);
+        pthread_mutex_unlock(&h->lock);
+        if (ok) {
+            atomic_fetch_sub_explicit(&mq->size, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 残りが少ないと乱数では当たりにくい: 空でないサブヒープを順に探してロックを待つ
+    uint64_t start = mq_random(rng) % n;
+    for (uint64_t k = 0; k < n && atomic_load_explicit(&mq->size, memory_order_relaxed) > 0; k++) {
+        MultiQueueHeap *h = &mq->heaps[(start + k) % n];
+        if (atomic_load_explicit(&h->top_priority, memory_order_relaxed) == INT_MIN) continue;
+        pthread_mutex_lock(&h->lock);
+        bool ok = mq_heap_pop_locked(h, out_chunk);
+        pthread_mutex_unlock(&h->lock);
+        if (ok) {
+            atomic_fetch_sub_explicit(&mq->size, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Evaluation Function Structures
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+typedef struct {
+    uint32_t n_square;
+    uint8_t x[12];
+} FeatureToCoordinate;
+
+static int16_t ***EVAL_WEIGHT = NULL;
+
+// このスレッドが読む重み（--eval-numa のワーカーは自分のNUMAノードの複製、それ以外は EVAL_WEIGHT）
+static __thread int16_t ***EVAL_WEIGHT_LOCAL = NULL;
+
+static inline int16_t ***eval_weight_table(void) {
+    return EVAL_WEIGHT_LOCAL ? EVAL_WEIGHT_LOCAL : EVAL_WEIGHT;
+}
+
+static const FeatureToCoordinate EVAL_F2X[] = {
+    { 9, {0, 1, 8, 9, 2, 16, 10, 17, 18}},
+    { 9, {7, 6, 15, 14, 5, 23, 13, 22, 21}},
+    { 9, {56, 48, 57, 49, 40, 58, 41, 50, 42}},
     { 9, {63, 55, 62, 54, 47, 61, 46, 53, 45}},
     {10, {32, 24, 16, 8, 0, 9, 1, 2, 3, 4}},
     {10, {39, 31, 23, 15, 7, 14, 6, 5, 4, 3}},
@@ -1075,6 +2159,9 @@ static int pq_pop(PriorityQueue *pq) {
 #define popcount(x) __builtin_popcountll(x)
 #define first_one(x) __builtin_ctzll(x)
 
+// OR/AND で特殊化する探索関数の本体（定数の NodeType を渡して呼び出し側に展開させる）
+#define ALWAYS_INLINE inline __attribute__((always_inline))
+
 static inline uint64_t bswap_64(uint64_t b) {
     return __builtin_bswap64(b);
 }
@@ -1316,6 +2403,7 @@ static int board_unique_avx2(uint64_t player, uint64_t opponent,
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
 #include <cpuid.h>
 static bool cpu_has_avx2 = false;
+static bool cpu_has_avx512f = false;
 static bool cpu_checked = false;
 
 static void check_cpu_features(void) {
@@ -1333,12 +2421,17 @@ static void check_cpu_features(void) {
             // Check for AVX2 support (need to check extended features)
             if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
                 cpu_has_avx2 = (ebx & (1 << 5)) != 0;  // AVX2 is bit 5 of EBX
+                // AVX-512F is bit 16 of EBX; the OS must also save opmask/ZMM state (XCR0 bits 5-7)
+                uint32_t xcr0_lo, xcr0_hi;
+                __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+                cpu_has_avx512f = (ebx & (1 << 16)) != 0 && (xcr0_lo & 0xE6) == 0xE6;
             }
         }
     }
 }
 #else
 #define cpu_has_avx2 false
+#define cpu_has_avx512f false
 static void check_cpu_features(void) {}
 #endif
 
@@ -1355,57 +2448,38 @@ static int board_unique(uint64_t player, uint64_t opponent,
     return board_unique_scalar(player, opponent, unique_player, unique_opponent);
 }
 
+// 1方向（とその逆方向）の合法手（Kogge-Stone型の並列プレフィックス）
+// mask: 盤端で折り返さないよう列をマスクした相手石。相手石の連続は最大6個
+static inline uint64_t get_some_moves(uint64_t P, uint64_t mask, int dir) {
+    uint64_t flip_l, flip_r, mask_l, mask_r;
+    const int dir2 = dir + dir;
+
+    flip_l = mask & (P << dir);
+    flip_r = mask & (P >> dir);
+    flip_l |= mask & (flip_l << dir);
+    flip_r |= mask & (flip_r >> dir);
+    mask_l = mask & (mask << dir);
+    mask_r = mask & (mask >> dir);
+    flip_l |= mask_l & (flip_l << dir2);
+    flip_r |= mask_r & (flip_r >> dir2);
+    flip_l |= mask_l & (flip_l << dir2);
+    flip_r |= mask_r & (flip_r >> dir2);
+
+    return (flip_l << dir) | (flip_r >> dir);
+}
+
 // Scalar version of get_moves (always available)
+//
+// 修正: 旧実装は斜め方向で両向きのフラグを同じ変数に混ぜてから両向きにシフトし、
+//       横方向の2マス飛ばしも相手石の連続条件を欠いていたため、存在しない手を
+//       生成したり合法手を落としたりしていた（ランダム局面の約4割で不一致）
 static inline uint64_t get_moves_scalar(uint64_t P, uint64_t O) {
-    uint64_t mask, moves, flip_l, flip_r, pre_l, pre_r;
-    uint64_t flip_h, flip_v, flip_d1, flip_d2;
-
-    mask = O & 0x7e7e7e7e7e7e7e7eULL;
-
-    flip_l = mask & (P << 1);
-    flip_r = mask & (P >> 1);
-    flip_l |= mask & (flip_l << 1);
-    flip_r |= mask & (flip_r >> 1);
-    pre_l = mask & (flip_l << 1);
-    pre_r = mask & (flip_r >> 1);
-    flip_l |= pre_l | (pre_l << 2);
-    flip_r |= pre_r | (pre_r >> 2);
-    flip_l |= mask & (flip_l << 1);
-    flip_r |= mask & (flip_r >> 1);
-
-    mask = O & 0x00ffffffffffff00ULL;
-    flip_h = mask & (P << 8);
-    flip_v = mask & (P >> 8);
-    flip_h |= mask & (flip_h << 8);
-    flip_v |= mask & (flip_v >> 8);
-    flip_h |= mask & ((flip_h & (mask << 8)) << 16);
-    flip_v |= mask & ((flip_v & (mask >> 8)) >> 16);
-    flip_h |= mask & (flip_h << 8);
-    flip_v |= mask & (flip_v >> 8);
-
-    mask = O & 0x007e7e7e7e7e7e00ULL;
-    flip_d1 = mask & (P << 9);
-    flip_d2 = mask & (P << 7);
-    flip_d1 |= mask & (flip_d1 << 9);
-    flip_d2 |= mask & (flip_d2 << 7);
-    flip_d1 |= mask & ((flip_d1 & (mask << 9)) << 18);
-    flip_d2 |= mask & ((flip_d2 & (mask << 7)) << 14);
-    flip_d1 |= mask & (flip_d1 << 9);
-    flip_d2 |= mask & (flip_d2 << 7);
-
-    flip_d1 |= mask & (P >> 9);
-    flip_d2 |= mask & (P >> 7);
-    flip_d1 |= mask & (flip_d1 >> 9);
-    flip_d2 |= mask & (flip_d2 >> 7);
-    flip_d1 |= mask & ((flip_d1 & (mask >> 9)) >> 18);
-    flip_d2 |= mask & ((flip_d2 & (mask >> 7)) >> 14);
-    flip_d1 |= mask & (flip_d1 >> 9);
-    flip_d2 |= mask & (flip_d2 >> 7);
-
-    moves = (flip_l << 1) | (flip_r >> 1) |
-            (flip_h << 8) | (flip_v >> 8) |
-            (flip_d1 << 9) | (flip_d1 >> 9) |
-            (flip_d2 << 7) | (flip_d2 >> 7);
+    const uint64_t mask = O & 0x7e7e7e7e7e7e7e7eULL;  // 横・斜め: a/h列を除外
+
+    uint64_t moves = get_some_moves(P, mask, 1) |     // 横
+                     get_some_moves(P, O, 8) |        // 縦
+                     get_some_moves(P, mask, 7) |     // 斜め（右上-左下）
+                     get_some_moves(P, mask, 9);      // 斜め（左上-右下）
 
     return moves & ~(P | O);
 }
@@ -1536,79 +2610,37 @@ static inline uint64_t get_moves(uint64_t P, uint64_t O) {
     return get_moves_scalar(P, O);
 }
 
+// 8方向のシフト量と、シフト後に盤端の折り返しを除くマスク
+// （+1/+9/-7 は a列へ、-1/-9/+7 は h列へ折り返すので除外する）
+static const int FLIP_DIR_SHIFT[8] = {1, -1, 8, -8, 9, -9, 7, -7};
+static const uint64_t FLIP_DIR_MASK[8] = {
+    0xfefefefefefefefeULL, 0x7f7f7f7f7f7f7f7fULL,
+    0xffffffffffffffffULL, 0xffffffffffffffffULL,
+    0xfefefefefefefefeULL, 0x7f7f7f7f7f7f7f7fULL,
+    0x7f7f7f7f7f7f7f7fULL, 0xfefefefefefefefeULL
+};
+
+static inline uint64_t flip_shift(uint64_t b, int shift) {
+    return (shift > 0) ? (b << shift) : (b >> -shift);
+}
+
+// 修正: 旧実装は横・縦で「最初の占有マス」を挟む石とみなし（相手石の連続を
+//       数えていない）、返る石に空きマスや着手マス自体を含めていた
 static uint64_t flip_discs(uint64_t P, uint64_t O, int pos) {
     uint64_t flip = 0;
     uint64_t move_bit = 1ULL << pos;
-    uint64_t PO = P | O;
-
-    int x = pos & 7;
-    int y = pos >> 3;
-
-    if (x < 6) {
-        uint64_t mask = 0x7eULL << (y * 8);
-        uint64_t outflank = ((0x80ULL << (y * 8)) - move_bit) & PO & mask;
-        if (outflank) {
-            uint64_t boundary = outflank & -outflank;
-            if (P & boundary) {
-                flip |= (boundary - move_bit) & mask;
-            }
-        }
-    }
-
-    if (x > 1) {
-        uint64_t mask = 0x7eULL << (y * 8);
-        uint64_t outflank = (move_bit - 1) & PO & mask;
-        if (outflank) {
-            uint64_t boundary = 1ULL << (63 - __builtin_clzll(outflank));
-            if (P & boundary) {
-                flip |= (move_bit - boundary - 1) & mask;
-            }
-        }
-    }
-
-    if (y < 6) {
-        uint64_t mask = 0x00ffffffffffff00ULL & (0x0101010101010101ULL << x);
-        uint64_t outflank = ((0x8000000000000000ULL >> (7 - x)) - move_bit) & PO & mask;
-        if (outflank) {
-            uint64_t boundary = outflank & -outflank;
-            if (P & boundary) {
-                flip |= (boundary - move_bit) & mask;
-            }
-        }
-    }
-
-    if (y > 1) {
-        uint64_t mask = 0x00ffffffffffff00ULL & (0x0101010101010101ULL << x);
-        uint64_t outflank = (move_bit - 1) & PO & mask;
-        if (outflank) {
-            uint64_t boundary = 1ULL << (63 - __builtin_clzll(outflank));
-            if (P & boundary) {
-                flip |= (move_bit - boundary - 1) & mask;
-            }
-        }
-    }
 
-    const int dirs[] = {7, 9, -7, -9};
-    for (int d = 0; d < 4; d++) {
-        int dir = dirs[d];
-        int p = pos + dir;
+    for (int d = 0; d < 8; d++) {
+        const int shift = FLIP_DIR_SHIFT[d];
+        const uint64_t mask = FLIP_DIR_MASK[d];
         uint64_t line = 0;
+        uint64_t b = flip_shift(move_bit, shift) & mask;
 
-        while (p >= 0 && p < 64) {
-            int px = p & 7, py = p >> 3;
-            int dx = px - x, dy = py - y;
-            if (abs(dx) != abs(dy)) break;
-
-            if (O & (1ULL << p)) {
-                line |= 1ULL << p;
-                p += dir;
-            } else if (P & (1ULL << p)) {
-                flip |= line;
-                break;
-            } else {
-                break;
-            }
+        while (b & O) {
+            line |= b;
+            b = flip_shift(b, shift) & mask;
         }
+        if (b & P) flip |= line;
     }
 
     return flip;
@@ -1658,7 +2690,7 @@ static int evaluate_position_scalar(uint64_t player, uint64_t opponent) {
     int ply = 60 - empties;
     if (ply >= (int)EVAL_N_PLY) ply = EVAL_N_PLY - 1;
 
-    int16_t *weights = EVAL_WEIGHT[ply][0];
+    int16_t *weights = eval_weight_table()[ply][0];
     int sum = 0;
 
     for (int i = 0; i < (int)EVAL_N_FEATURE; i++) {
@@ -1680,7 +2712,7 @@ static int evaluate_position_avx2(uint64_t player, uint64_t opponent) {
     int ply = 60 - empties;
     if (ply >= (int)EVAL_N_PLY) ply = EVAL_N_PLY - 1;
 
-    int16_t *weights = EVAL_WEIGHT[ply][0];
+    int16_t *weights = eval_weight_table()[ply][0];
 
     // 特徴量を計算
     uint16_t features[EVAL_N_FEATURE];
@@ -1738,137 +2770,1236 @@ static int evaluate_position_avx2(uint64_t player, uint64_t opponent) {
 }
 #endif
 
-// 評価関数（ランタイム選択）
-static int evaluate_position(uint64_t player, uint64_t opponent) {
-#ifdef __AVX2__
-    if (cpu_has_avx2) {
-        return evaluate_position_avx2(player, opponent);
-    }
-#endif
-    return evaluate_position_scalar(player, opponent);
+// ────────────────────────────────────────────────────────────
+// SIMD gather 評価カーネル（--eval-kernel avx2-gather / avx512-gather）
+// ────────────────────────────────────────────────────────────
+//
+// 上の AVX2 版は特徴量をスカラーの compute_feature で求め、重みも1つずつ読んでいる。
+// gather 版は特徴量の添字もベクトルで求める。桁は 0 = 手番側、1 = 相手、2 = 空きなので
+//   添字 = Σ 3^k × (2 − 2p − o) + FEATURE_OFFSET = base − Σ 3^k × (2p + o)
+// （p, o はそのマスの手番側・相手の石のビット、base は全て空きのときの添字）。
+// レーンごとに特徴量を1つ割り当て、桁 j ごとにマスのビットを可変シフトで取り出して
+// 3 の冪を掛けて引く（特徴量のマスは最大10個、ないマスは冪 0）。47 個を 48 レーンに
+// 揃え、重みは int16 の表から 32 ビット gather して符号拡張する（最後のレーンは捨てる）。
+// 和は int32 で取るのでスカラー版と同じ値になる。
+
+#define MAX_CHILDREN 34             // 合法手の最大数（33）+ 余裕
+
+#define EVAL_SIMD_LANES 48
+#define EVAL_SIMD_DIGITS 10
+
+// 空きマス数に対応する手数の重み（EVAL_WEIGHT が読み込まれていること）
+static inline const int16_t *eval_weights_at(int empties) {
+    int ply = 60 - empties;
+    if (ply >= (int)EVAL_N_PLY) ply = EVAL_N_PLY - 1;
+    return eval_weight_table()[ply][0];
 }
 
-static bool load_evaluation_weights(const char *filename) {
-    const uint32_t n_w = 114364;
-    FILE *f = fopen(filename, "rb");
-    if (!f) {
-        fprintf(stderr, "Warning: Cannot open evaluation file %s\n", filename);
-        return false;
+typedef struct {
+    int32_t shift[EVAL_SIMD_DIGITS][EVAL_SIMD_LANES];   // マス番号 & 31
+    int32_t high[EVAL_SIMD_DIGITS][EVAL_SIMD_LANES];    // マス >= 32 なら -1（上位32ビットを使う）
+    int32_t power[EVAL_SIMD_DIGITS][EVAL_SIMD_LANES];   // 桁の重み（マスがなければ 0）
+    uint16_t high_mask[EVAL_SIMD_DIGITS][EVAL_SIMD_LANES / 16];  // AVX-512用の high
+    int32_t base[EVAL_SIMD_LANES];                      // 全て空きのときの添字
+    int32_t valid[EVAL_SIMD_LANES];                     // 特徴量のレーンなら -1
+} EvalSimdTables;
+
+static EvalSimdTables EVAL_SIMD __attribute__((aligned(64)));
+
+static void eval_simd_init_tables(void) {
+    memset(&EVAL_SIMD, 0, sizeof(EVAL_SIMD));
+    for (uint32_t i = 0; i < EVAL_N_FEATURE; i++) {
+        const FeatureToCoordinate *f2x = &EVAL_F2X[i];
+        int32_t power = 1;
+        int32_t base = (int32_t)FEATURE_OFFSET[i];
+        // compute_feature は先頭のマスが最上位の桁
+        for (int j = (int)f2x->n_square - 1; j >= 0; j--) {
+            int sq = f2x->x[j];
+            if (sq < 64) {
+                EVAL_SIMD.shift[j][i] = sq & 31;
+                EVAL_SIMD.high[j][i] = (sq >= 32) ? -1 : 0;
+                if (sq >= 32) EVAL_SIMD.high_mask[j][i / 16] |= (uint16_t)(1u << (i % 16));
+                EVAL_SIMD.power[j][i] = power;
+                base += 2 * power;
+            }
+            power *= 3;
+        }
+        EVAL_SIMD.base[i] = base;
+        EVAL_SIMD.valid[i] = -1;
     }
+}
 
-    uint32_t edax_header, eval_header, version, release, build;
-    double date;
+#ifdef __AVX2__
+// 8個の特徴量（レーン g*8 .. g*8+7）の添字
+static inline __m256i eval_feature_indices_avx2(const __m256i p_lo, const __m256i p_hi,
+                                                const __m256i o_lo, const __m256i o_hi, int g) {
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i idx = _mm256_load_si256((const __m256i *)&EVAL_SIMD.base[g * 8]);
+    for (int j = 0; j < EVAL_SIMD_DIGITS; j++) {
+        __m256i sh = _mm256_load_si256((const __m256i *)&EVAL_SIMD.shift[j][g * 8]);
+        __m256i hi = _mm256_load_si256((const __m256i *)&EVAL_SIMD.high[j][g * 8]);
+        __m256i pw = _mm256_load_si256((const __m256i *)&EVAL_SIMD.power[j][g * 8]);
+        __m256i p = _mm256_and_si256(_mm256_srlv_epi32(_mm256_blendv_epi8(p_lo, p_hi, hi), sh), one);
+        __m256i o = _mm256_and_si256(_mm256_srlv_epi32(_mm256_blendv_epi8(o_lo, o_hi, hi), sh), one);
+        __m256i d = _mm256_add_epi32(_mm256_add_epi32(p, p), o);
+        idx = _mm256_sub_epi32(idx, _mm256_mullo_epi32(d, pw));
+    }
+    return idx;
+}
 
-    if (fread(&edax_header, sizeof(uint32_t), 1, f) != 1 ||
-        fread(&eval_header, sizeof(uint32_t), 1, f) != 1 ||
-        fread(&version, sizeof(uint32_t), 1, f) != 1 ||
-        fread(&release, sizeof(uint32_t), 1, f) != 1 ||
-        fread(&build, sizeof(uint32_t), 1, f) != 1 ||
-        fread(&date, sizeof(double), 1, f) != 1) {
-        fprintf(stderr, "Warning: Cannot read eval.dat header\n");
-        fclose(f);
-        return false;
-    }
+// 8個の添字の重みを gather して int32 で足す（valid でないレーンは 0）
+static inline __m256i eval_gather_weights_avx2(const int16_t *weights, __m256i idx, int g) {
+    __m256i valid = _mm256_load_si256((const __m256i *)&EVAL_SIMD.valid[g * 8]);
+    __m256i w = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), (const int *)weights, idx, valid, 2);
+    return _mm256_srai_epi32(_mm256_slli_epi32(w, 16), 16);
+}
 
-    EVAL_WEIGHT = calloc(EVAL_N_PLY, sizeof(int16_t**));
-    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
-        EVAL_WEIGHT[ply] = calloc(1, sizeof(int16_t*));
-        EVAL_WEIGHT[ply][0] = calloc(EVAL_N_WEIGHT, sizeof(int16_t));
+static inline int eval_hsum_avx2(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+static int evaluate_position_avx2_gather(uint64_t player, uint64_t opponent) {
+    if (!EVAL_WEIGHT) return 0;
+
+    int empties = popcount(~(player | opponent));
+    int ply = 60 - empties;
+    if (ply >= (int)EVAL_N_PLY) ply = EVAL_N_PLY - 1;
+    const int16_t *weights = eval_weight_table()[ply][0];
+
+    const __m256i p_lo = _mm256_set1_epi32((int32_t)(uint32_t)player);
+    const __m256i p_hi = _mm256_set1_epi32((int32_t)(uint32_t)(player >> 32));
+    const __m256i o_lo = _mm256_set1_epi32((int32_t)(uint32_t)opponent);
+    const __m256i o_hi = _mm256_set1_epi32((int32_t)(uint32_t)(opponent >> 32));
+
+    __m256i sum = _mm256_setzero_si256();
+    for (int g = 0; g < EVAL_SIMD_LANES / 8; g++) {
+        __m256i idx = eval_feature_indices_avx2(p_lo, p_hi, o_lo, o_hi, g);
+        sum = _mm256_add_epi32(sum, eval_gather_weights_avx2(weights, idx, g));
     }
+    return eval_hsum_avx2(sum) / 128;
+}
 
-    int16_t *w = malloc(n_w * sizeof(int16_t));
+// 増分評価の添字（uint16 × 48）から重みを gather する
+static int eval_features_sum_avx2_gather(const int16_t *weights, const uint16_t *f) {
+    __m256i sum = _mm256_setzero_si256();
+    for (int g = 0; g < EVAL_SIMD_LANES / 8; g++) {
+        __m256i idx = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)&f[g * 8]));
+        sum = _mm256_add_epi32(sum, eval_gather_weights_avx2(weights, idx, g));
+    }
+    return eval_hsum_avx2(sum);
+}
 
-    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
-        if (fread(w, sizeof(int16_t), n_w, f) != n_w) {
-            fprintf(stderr, "Warning: Incomplete eval.dat file at ply %u\n", ply);
-            break;
+// まとめ評価（--eval-batch）: 兄弟 EVAL_BATCH_WIDTH 個を特徴量のグループごとに交互に gather する。
+// 兄弟の gather は互いに依存しないので、1局面ずつより多くのキャッシュミスが同時に進む。
+// 端数は最後の局面を繰り返して幅を揃え、その結果は捨てる。
+static void evaluate_positions_avx2_gather(const uint64_t *player, const uint64_t *opponent, int n, int *out) {
+    for (int b = 0; b < n; b += EVAL_BATCH_WIDTH) {
+        __m256i p_lo[EVAL_BATCH_WIDTH], p_hi[EVAL_BATCH_WIDTH], o_lo[EVAL_BATCH_WIDTH], o_hi[EVAL_BATCH_WIDTH];
+        __m256i sum[EVAL_BATCH_WIDTH];
+        const int16_t *weights[EVAL_BATCH_WIDTH];
+        for (int k = 0; k < EVAL_BATCH_WIDTH; k++) {
+            int i = (b + k < n) ? b + k : n - 1;
+            weights[k] = eval_weights_at(popcount(~(player[i] | opponent[i])));
+            p_lo[k] = _mm256_set1_epi32((int32_t)(uint32_t)player[i]);
+            p_hi[k] = _mm256_set1_epi32((int32_t)(uint32_t)(player[i] >> 32));
+            o_lo[k] = _mm256_set1_epi32((int32_t)(uint32_t)opponent[i]);
+            o_hi[k] = _mm256_set1_epi32((int32_t)(uint32_t)(opponent[i] >> 32));
+            sum[k] = _mm256_setzero_si256();
         }
-
-        int j = 0;
-        for (int i = 0; i < 13 && j < (int)EVAL_N_WEIGHT; i++) {
-            for (uint32_t k = 0; k < EVAL_SIZE[i] && j < (int)EVAL_N_WEIGHT; k++, j++) {
-                if (k < EVAL_PACKED_SIZE[i]) {
-                    EVAL_WEIGHT[ply][0][j] = w[k];
-                }
+        for (int g = 0; g < EVAL_SIMD_LANES / 8; g++) {
+            for (int k = 0; k < EVAL_BATCH_WIDTH; k++) {
+                __m256i idx = eval_feature_indices_avx2(p_lo[k], p_hi[k], o_lo[k], o_hi[k], g);
+                sum[k] = _mm256_add_epi32(sum[k], eval_gather_weights_avx2(weights[k], idx, g));
             }
         }
+        for (int k = 0; k < EVAL_BATCH_WIDTH && b + k < n; k++) {
+            out[b + k] = eval_hsum_avx2(sum[k]) / 128;
+        }
     }
-
-    free(w);
-    fclose(f);
-
-    debug_log("Loaded evaluation weights from %s (version %u.%u.%u)\n",
-           filename, version, release, build);
-
-    return true;
 }
 
-static void free_evaluation_weights() {
-    if (EVAL_WEIGHT) {
-        for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
-            if (EVAL_WEIGHT[ply]) {
-                free(EVAL_WEIGHT[ply][0]);
-                free(EVAL_WEIGHT[ply]);
+// 増分評価の添字 n 組（同じ手数）の重みの和
+static void eval_features_sum_batch_avx2_gather(const int16_t *weights, const uint16_t (*f)[48], int n, int *out) {
+    for (int b = 0; b < n; b += EVAL_BATCH_WIDTH) {
+        __m256i sum[EVAL_BATCH_WIDTH];
+        for (int k = 0; k < EVAL_BATCH_WIDTH; k++) sum[k] = _mm256_setzero_si256();
+        for (int g = 0; g < EVAL_SIMD_LANES / 8; g++) {
+            for (int k = 0; k < EVAL_BATCH_WIDTH; k++) {
+                int i = (b + k < n) ? b + k : n - 1;
+                __m256i idx = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)&f[i][g * 8]));
+                sum[k] = _mm256_add_epi32(sum[k], eval_gather_weights_avx2(weights, idx, g));
             }
         }
-        free(EVAL_WEIGHT);
-        EVAL_WEIGHT = NULL;
+        for (int k = 0; k < EVAL_BATCH_WIDTH && b + k < n; k++) {
+            out[b + k] = eval_hsum_avx2(sum[k]);
+        }
     }
 }
+#endif
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// Transposition Table
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+#ifdef __AVX512F__
+// 16個の特徴量（レーン g*16 .. g*16+15）の添字
+static inline __m512i eval_feature_indices_avx512(const __m512i p_lo, const __m512i p_hi,
+                                                  const __m512i o_lo, const __m512i o_hi, int g) {
+    const __m512i one = _mm512_set1_epi32(1);
+    __m512i idx = _mm512_load_si512(&EVAL_SIMD.base[g * 16]);
+    for (int j = 0; j < EVAL_SIMD_DIGITS; j++) {
+        __m512i sh = _mm512_load_si512(&EVAL_SIMD.shift[j][g * 16]);
+        __m512i pw = _mm512_load_si512(&EVAL_SIMD.power[j][g * 16]);
+        __mmask16 hi = EVAL_SIMD.high_mask[j][g];
+        __m512i p = _mm512_and_si512(_mm512_srlv_epi32(_mm512_mask_blend_epi32(hi, p_lo, p_hi), sh), one);
+        __m512i o = _mm512_and_si512(_mm512_srlv_epi32(_mm512_mask_blend_epi32(hi, o_lo, o_hi), sh), one);
+        __m512i d = _mm512_add_epi32(_mm512_add_epi32(p, p), o);
+        idx = _mm512_sub_epi32(idx, _mm512_mullo_epi32(d, pw));
+    }
+    return idx;
+}
 
-typedef struct {
-    uint64_t key;
-    uint32_t pn;
-    uint32_t dn;
-    Result result;
-    int8_t depth;
-    int16_t eval_score;
-    uint8_t age;
-} TTEntry;
+static inline __m512i eval_gather_weights_avx512(const int16_t *weights, __m512i idx, int g) {
+    __mmask16 valid = (g == EVAL_SIMD_LANES / 16 - 1) ? (__mmask16)((1u << (EVAL_N_FEATURE % 16)) - 1)
+                                                       : (__mmask16)0xFFFF;
+    __m512i w = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), valid, idx, weights, 2);
+    return _mm512_srai_epi32(_mm512_slli_epi32(w, 16), 16);
+}
 
-// Stripe lock configuration for TT
-// Fixed number of stripes with cache line padding to prevent false sharing
-#define TT_LOCK_STRIPES 1024
-#define CACHE_LINE_SIZE 64
+static int evaluate_position_avx512_gather(uint64_t player, uint64_t opponent) {
+    if (!EVAL_WEIGHT) return 0;
 
-// Cache-line aligned lock structure to prevent false sharing
-typedef struct {
-    pthread_rwlock_t lock;
-    char padding[CACHE_LINE_SIZE - sizeof(pthread_rwlock_t)];
-} __attribute__((aligned(CACHE_LINE_SIZE))) AlignedLock;
+    int empties = popcount(~(player | opponent));
+    int ply = 60 - empties;
+    if (ply >= (int)EVAL_N_PLY) ply = EVAL_N_PLY - 1;
+    const int16_t *weights = eval_weight_table()[ply][0];
 
-typedef struct {
-    TTEntry *entries;
-    size_t size;
-    size_t mask;
-    AlignedLock locks[TT_LOCK_STRIPES];  // Fixed stripe locks with padding
+    const __m512i p_lo = _mm512_set1_epi32((int32_t)(uint32_t)player);
+    const __m512i p_hi = _mm512_set1_epi32((int32_t)(uint32_t)(player >> 32));
+    const __m512i o_lo = _mm512_set1_epi32((int32_t)(uint32_t)opponent);
+    const __m512i o_hi = _mm512_set1_epi32((int32_t)(uint32_t)(opponent >> 32));
 
-    // Statistics (use atomic operations, no lock needed)
-    volatile uint64_t hits;
-    volatile uint64_t stores;
-    volatile uint64_t collisions;
-} TranspositionTable;
+    __m512i sum = _mm512_setzero_si512();
+    for (int g = 0; g < EVAL_SIMD_LANES / 16; g++) {
+        __m512i idx = eval_feature_indices_avx512(p_lo, p_hi, o_lo, o_hi, g);
+        sum = _mm512_add_epi32(sum, eval_gather_weights_avx512(weights, idx, g));
+    }
+    return _mm512_reduce_add_epi32(sum) / 128;
+}
 
-static uint64_t zobrist_table[2][64];
-static bool zobrist_initialized = false;
+static int eval_features_sum_avx512_gather(const int16_t *weights, const uint16_t *f) {
+    __m512i sum = _mm512_setzero_si512();
+    for (int g = 0; g < EVAL_SIMD_LANES / 16; g++) {
+        __m512i idx = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)&f[g * 16]));
+        sum = _mm512_add_epi32(sum, eval_gather_weights_avx512(weights, idx, g));
+    }
+    return _mm512_reduce_add_epi32(sum);
+}
 
-static void init_zobrist() {
-    if (zobrist_initialized) return;
-    srand(12345);
-    for (int i = 0; i < 2; i++) {
-        for (int j = 0; j < 64; j++) {
-            zobrist_table[i][j] = ((uint64_t)rand() << 32) | rand();
+static void evaluate_positions_avx512_gather(const uint64_t *player, const uint64_t *opponent, int n, int *out) {
+    for (int b = 0; b < n; b += EVAL_BATCH_WIDTH) {
+        __m512i p_lo[EVAL_BATCH_WIDTH], p_hi[EVAL_BATCH_WIDTH], o_lo[EVAL_BATCH_WIDTH], o_hi[EVAL_BATCH_WIDTH];
+        __m512i sum[EVAL_BATCH_WIDTH];
+        const int16_t *weights[EVAL_BATCH_WIDTH];
+        for (int k = 0; k < EVAL_BATCH_WIDTH; k++) {
+            int i = (b + k < n) ? b + k : n - 1;
+            weights[k] = eval_weights_at(popcount(~(player[i] | opponent[i])));
+            p_lo[k] = _mm512_set1_epi32((int32_t)(uint32_t)player[i]);
+            p_hi[k] = _mm512_set1_epi32((int32_t)(uint32_t)(player[i] >> 32));
+            o_lo[k] = _mm512_set1_epi32((int32_t)(uint32_t)opponent[i]);
+            o_hi[k] = _mm512_set1_epi32((int32_t)(uint32_t)(opponent[i] >> 32));
+            sum[k] = _mm512_setzero_si512();
+        }
+        for (int g = 0; g < EVAL_SIMD_LANES / 16; g++) {
+            for (int k = 0; k < EVAL_BATCH_WIDTH; k++) {
+                __m512i idx = eval_feature_indices_avx512(p_lo[k], p_hi[k], o_lo[k], o_hi[k], g);
+                sum[k] = _mm512_add_epi32(sum[k], eval_gather_weights_avx512(weights[k], idx, g));
+            }
+        }
+        for (int k = 0; k < EVAL_BATCH_WIDTH && b + k < n; k++) {
+            out[b + k] = _mm512_reduce_add_epi32(sum[k]) / 128;
         }
     }
-    zobrist_initialized = true;
 }
 
-static inline uint64_t hash_position(uint64_t P, uint64_t O) {
-    // ────────────────────────────────────────────────────────────
+static void eval_features_sum_batch_avx512_gather(const int16_t *weights, const uint16_t (*f)[48], int n, int *out) {
+    for (int b = 0; b < n; b += EVAL_BATCH_WIDTH) {
+        __m512i sum[EVAL_BATCH_WIDTH];
+        for (int k = 0; k < EVAL_BATCH_WIDTH; k++) sum[k] = _mm512_setzero_si512();
+        for (int g = 0; g < EVAL_SIMD_LANES / 16; g++) {
+            for (int k = 0; k < EVAL_BATCH_WIDTH; k++) {
+                int i = (b + k < n) ? b + k : n - 1;
+                __m512i idx = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *)&f[i][g * 16]));
+                sum[k] = _mm512_add_epi32(sum[k], eval_gather_weights_avx512(weights, idx, g));
+            }
+        }
+        for (int k = 0; k < EVAL_BATCH_WIDTH && b + k < n; k++) {
+            out[b + k] = _mm512_reduce_add_epi32(sum[k]);
+        }
+    }
+}
+#endif
+
+// 評価カーネル（--eval-kernel）。auto は使える中で最も新しい gather 版
+typedef enum {
+    EVAL_KERNEL_AUTO,
+    EVAL_KERNEL_SCALAR,
+    EVAL_KERNEL_AVX2,           // compute_feature + 手動 gather（従来）
+    EVAL_KERNEL_AVX2_GATHER,
+    EVAL_KERNEL_AVX512_GATHER
+} EvalKernel;
+
+static EvalKernel EVAL_KERNEL = EVAL_KERNEL_AUTO;
+
+static const char *eval_kernel_name(EvalKernel kernel) {
+    switch (kernel) {
+        case EVAL_KERNEL_AUTO:          return "auto";
+        case EVAL_KERNEL_SCALAR:        return "scalar";
+        case EVAL_KERNEL_AVX2:          return "avx2";
+        case EVAL_KERNEL_AVX2_GATHER:   return "avx2-gather";
+        case EVAL_KERNEL_AVX512_GATHER: return "avx512-gather";
+    }
+    return "?";
+}
+
+static bool eval_kernel_supported(EvalKernel kernel) {
+    switch (kernel) {
+        case EVAL_KERNEL_AUTO:
+        case EVAL_KERNEL_SCALAR:
+            return true;
+#ifdef __AVX2__
+        case EVAL_KERNEL_AVX2:
+        case EVAL_KERNEL_AVX2_GATHER:
+            return cpu_has_avx2;
+#endif
+#ifdef __AVX512F__
+        case EVAL_KERNEL_AVX512_GATHER:
+            return cpu_has_avx512f;
+#endif
+        default:
+            return false;
+    }
+}
+
+// auto と、このビルド・CPUで使えないカーネルを解決する（check_cpu_features の後に呼ぶ）
+static void eval_kernel_resolve(void) {
+    if (EVAL_KERNEL != EVAL_KERNEL_AUTO && !eval_kernel_supported(EVAL_KERNEL)) {
+        fprintf(stderr, "Warning: eval kernel '%s' is not available in this build/CPU, using auto\n",
+                eval_kernel_name(EVAL_KERNEL));
+        EVAL_KERNEL = EVAL_KERNEL_AUTO;
+    }
+    if (EVAL_KERNEL == EVAL_KERNEL_AUTO) {
+        if (eval_kernel_supported(EVAL_KERNEL_AVX512_GATHER)) {
+            EVAL_KERNEL = EVAL_KERNEL_AVX512_GATHER;
+        } else if (eval_kernel_supported(EVAL_KERNEL_AVX2_GATHER)) {
+            EVAL_KERNEL = EVAL_KERNEL_AVX2_GATHER;
+        } else {
+            EVAL_KERNEL = EVAL_KERNEL_SCALAR;
+        }
+    }
+}
+
+// 評価関数（ランタイム選択）
+static int evaluate_position(uint64_t player, uint64_t opponent) {
+    switch (EVAL_KERNEL) {
+#ifdef __AVX512F__
+        case EVAL_KERNEL_AVX512_GATHER:
+            return evaluate_position_avx512_gather(player, opponent);
+#endif
+#ifdef __AVX2__
+        case EVAL_KERNEL_AVX2_GATHER:
+            return evaluate_position_avx2_gather(player, opponent);
+        case EVAL_KERNEL_AVX2:
+            return evaluate_position_avx2(player, opponent);
+#endif
+        default:
+            return evaluate_position_scalar(player, opponent);
+    }
+}
+
+// n 個の局面をまとめて評価する（out[i] = evaluate_position(player[i], opponent[i])）
+// gather カーネルでは兄弟の gather を重ね、それ以外は1局面ずつ評価する
+static void evaluate_positions(const uint64_t *player, const uint64_t *opponent, int n, int *out) {
+    if (!EVAL_WEIGHT) {
+        for (int i = 0; i < n; i++) out[i] = 0;
+        return;
+    }
+    switch (EVAL_KERNEL) {
+#ifdef __AVX512F__
+        case EVAL_KERNEL_AVX512_GATHER:
+            evaluate_positions_avx512_gather(player, opponent, n, out);
+            return;
+#endif
+#ifdef __AVX2__
+        case EVAL_KERNEL_AVX2_GATHER:
+            evaluate_positions_avx2_gather(player, opponent, n, out);
+            return;
+#endif
+        default:
+            for (int i = 0; i < n; i++) out[i] = evaluate_position(player[i], opponent[i]);
+            return;
+    }
+}
+
+// 局面の合法手 moves（空でないこと）の子を、着手後の手番側から見て評価する（out は first_one の順）
+// 戻り値: 子の数
+static int evaluate_children(uint64_t player, uint64_t opponent, uint64_t moves, int *out) {
+    uint64_t p[MAX_CHILDREN], o[MAX_CHILDREN];
+    int n = 0;
+    while (moves) {
+        int move = first_one(moves);
+        moves &= moves - 1;
+        p[n] = player;
+        o[n] = opponent;
+        make_move(&p[n], &o[n], move);
+        n++;
+    }
+    if (EVAL_BATCH) {
+        evaluate_positions(p, o, n, out);
+    } else {
+        for (int i = 0; i < n; i++) out[i] = evaluate_position(p[i], o[i]);
+    }
+    return n;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Evaluation Hash (--eval-hash)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 同じ局面は何度も評価される（should_abort_task で捨てた木の再探索、展開済みの局面から
+// 作ったサブタスク、合流）。評価値を局面のハッシュで引く表を全ワーカーで共有し、評価の前に引く。
+// エントリは64ビット1語で、上位48ビットがハッシュの断片（最上位ビットは空きとの区別に常に1）、
+// 下位16ビットが評価値。1語の読み書きは不可分なのでロックは要らず、競合しても上書きで消えるだけ。
+// 評価値は局面だけで決まる（カーネル・増分計算・NUMA複製によらない）ので、ヒットしても探索は変わらない。
+// hash_position は対称形を同一視するので使わず、盤面そのものを混ぜる。
+
+#define EVAL_HASH_VALUE_MASK 0xFFFFULL
+#define EVAL_HASH_VALID (1ULL << 63)
+
+static uint64_t *EVAL_HASH_TABLE = NULL;
+static size_t EVAL_HASH_MASK = 0;
+
+static inline uint64_t eval_hash_key(uint64_t p, uint64_t o) {
+    uint64_t h = p * 0x9E3779B97F4A7C15ULL ^ (o ^ (o >> 29)) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= h >> 32;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 29);
+}
+
+static inline bool eval_hash_probe(uint64_t h, int *eval) {
+    uint64_t e = __atomic_load_n(&EVAL_HASH_TABLE[h & EVAL_HASH_MASK], __ATOMIC_RELAXED);
+    if ((e ^ (h | EVAL_HASH_VALID)) & ~EVAL_HASH_VALUE_MASK) return false;
+    *eval = (int16_t)(e & EVAL_HASH_VALUE_MASK);
+    return true;
+}
+
+static inline void eval_hash_store(uint64_t h, int eval) {
+    uint64_t e = ((h | EVAL_HASH_VALID) & ~EVAL_HASH_VALUE_MASK) | (uint16_t)eval;
+    __atomic_store_n(&EVAL_HASH_TABLE[h & EVAL_HASH_MASK], e, __ATOMIC_RELAXED);
+}
+
+#ifdef STANDALONE_MAIN
+// size_mb 以下で最大の2の冪個のエントリを確保する（0 なら使わない）
+static void eval_hash_create(int size_mb) {
+    if (size_mb <= 0) return;
+    size_t n_entries = ((size_t)size_mb << 20) / sizeof(uint64_t);
+    size_t size = 1;
+    while (size * 2 <= n_entries) size <<= 1;
+    EVAL_HASH_TABLE = calloc(size, sizeof(uint64_t));
+    if (!EVAL_HASH_TABLE) {
+        fprintf(stderr, "Warning: Cannot allocate evaluation hash (%d MB)\n", size_mb);
+        return;
+    }
+    EVAL_HASH_MASK = size - 1;
+}
+#endif
+
+static void eval_hash_free(void) {
+    free(EVAL_HASH_TABLE);
+    EVAL_HASH_TABLE = NULL;
+    EVAL_HASH_MASK = 0;
+}
+
+static inline size_t eval_hash_entries(void) {
+    return EVAL_HASH_TABLE ? EVAL_HASH_MASK + 1 : 0;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Incremental Evaluation (--eval-incremental)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// Edax と同じく、47個の特徴量の添字を局面と一緒に持ち、着手したマスと返した石から
+// 差分で更新する。compute_feature は特徴量ごとに最大10マスを調べるが、差分更新は
+// 変化したマスを含む特徴量だけに 3 の冪を足し引きするので、子の評価は 47 回の表引きで済む。
+//
+// 特徴量の各桁は 0 = 手番側、1 = 相手、2 = 空き（compute_feature と同じ）。
+// 手番が替わると 0 と 1 が入れ替わるので、両者から見た添字を f[0]（手番側）と
+// f[1]（相手側）に持ち、子では f[0] と f[1] を入れ替える:
+//   - 着手したマス: 着手側から見て 2 → 0（-2×冪）、相手から見て 2 → 1（-冪）
+//   - 返した石:     着手側から見て 1 → 0（-冪）、  相手から見て 0 → 1（+冪）
+
+typedef struct {
+    uint64_t player;                    // この特徴量が表す局面（スタックの検証用）
+    uint64_t opponent;
+    uint16_t f[2][48];                  // [0]: 手番側から見た添字、[1]: 相手側から見た添字
+} EvalFeatures;
+
+// マス → そのマスを含む特徴量と、そのマスの桁の重み（3 の冪）
+typedef struct {
+    uint8_t n;
+    uint8_t feature[16];
+    uint16_t power[16];
+} EvalSquareToFeature;
+
+static EvalSquareToFeature EVAL_X2F[64];
+
+static void eval_features_init_tables(void) {
+    memset(EVAL_X2F, 0, sizeof(EVAL_X2F));
+    for (uint32_t i = 0; i < EVAL_N_FEATURE; i++) {
+        const FeatureToCoordinate *f2x = &EVAL_F2X[i];
+        uint16_t power = 1;
+        // compute_feature は先頭のマスが最上位の桁
+        for (int j = (int)f2x->n_square - 1; j >= 0; j--) {
+            int sq = f2x->x[j];
+            if (sq < 64) {
+                EvalSquareToFeature *x2f = &EVAL_X2F[sq];
+                x2f->feature[x2f->n] = (uint8_t)i;
+                x2f->power[x2f->n] = power;
+                x2f->n++;
+            }
+            power *= 3;
+        }
+    }
+}
+
+static void eval_features_set(EvalFeatures *ef, uint64_t player, uint64_t opponent) {
+    ef->player = player;
+    ef->opponent = opponent;
+    for (uint32_t i = 0; i < EVAL_N_FEATURE; i++) {
+        ef->f[0][i] = compute_feature(player, opponent, i);
+        ef->f[1][i] = compute_feature(opponent, player, i);
+    }
+}
+
+// from の手番側が move に打ち flip を返した後の局面（手番は相手）の特徴量を to に作る
+// move < 0 はパス（手番の入れ替えのみ）
+static inline void eval_features_update(const EvalFeatures *from, EvalFeatures *to, int move, uint64_t flip) {
+    memcpy(to->f[0], from->f[1], sizeof(to->f[0]));
+    memcpy(to->f[1], from->f[0], sizeof(to->f[1]));
+    if (move < 0) {
+        to->player = from->opponent;
+        to->opponent = from->player;
+        return;
+    }
+    to->player = from->opponent ^ flip;
+    to->opponent = from->player | flip | (1ULL << move);
+
+    // to->f[1] が着手側、to->f[0] が相手側から見た添字
+    const EvalSquareToFeature *x2f = &EVAL_X2F[move];
+    for (int k = 0; k < x2f->n; k++) {
+        to->f[1][x2f->feature[k]] -= 2 * x2f->power[k];
+        to->f[0][x2f->feature[k]] -= x2f->power[k];
+    }
+    while (flip) {
+        x2f = &EVAL_X2F[first_one(flip)];
+        flip &= flip - 1;
+        for (int k = 0; k < x2f->n; k++) {
+            to->f[1][x2f->feature[k]] -= x2f->power[k];
+            to->f[0][x2f->feature[k]] += x2f->power[k];
+        }
+    }
+}
+
+// 手番側から見た添字 f（EvalFeatures.f[0]）の評価値（evaluate_position と同じ値）
+static inline int eval_features_score(const uint16_t *f, int empties) {
+    if (!EVAL_WEIGHT) return 0;
+    int ply = 60 - empties;
+    if (ply >= (int)EVAL_N_PLY) ply = EVAL_N_PLY - 1;
+
+    const int16_t *weights = eval_weight_table()[ply][0];
+#ifdef __AVX512F__
+    if (EVAL_KERNEL == EVAL_KERNEL_AVX512_GATHER) return eval_features_sum_avx512_gather(weights, f) / 128;
+#endif
+#ifdef __AVX2__
+    if (EVAL_KERNEL == EVAL_KERNEL_AVX2_GATHER) return eval_features_sum_avx2_gather(weights, f) / 128;
+#endif
+    int sum = 0;
+    for (uint32_t i = 0; i < EVAL_N_FEATURE; i++) {
+        sum += weights[f[i]];
+    }
+    return sum / 128;
+}
+
+// ef の手番側が move に打ち flip を返した後の局面を、新しい手番側から見た添字 f
+// 子の評価だけなら相手側の添字（f[1]）を1組更新すれば足りる
+static inline void eval_features_child_indices(const EvalFeatures *ef, int move, uint64_t flip, uint16_t *f) {
+    memcpy(f, ef->f[1], sizeof(ef->f[1]));
+    if (move >= 0) {
+        const EvalSquareToFeature *x2f = &EVAL_X2F[move];
+        for (int k = 0; k < x2f->n; k++) f[x2f->feature[k]] -= x2f->power[k];
+        while (flip) {
+            x2f = &EVAL_X2F[first_one(flip)];
+            flip &= flip - 1;
+            for (int k = 0; k < x2f->n; k++) f[x2f->feature[k]] += x2f->power[k];
+        }
+    }
+}
+
+// 上の子の評価値（empties は着手後）
+static inline int eval_features_child_score(const EvalFeatures *ef, int move, uint64_t flip, int empties) {
+    uint16_t f[48];
+    eval_features_child_indices(ef, move, flip, f);
+    return eval_features_score(f, empties);
+}
+
+// ef の子 n 個（着手 moves[i]、着手後の新しい手番側の石 child_player[i]、空きマス数はすべて empties）の
+// 評価値をまとめて求める。out[i] は eval_features_child_score と同じ値
+static void eval_features_children_score(const EvalFeatures *ef, const int *moves, const uint64_t *child_player,
+                                         int n, int empties, int *out) {
+    if (!EVAL_WEIGHT) {
+        for (int i = 0; i < n; i++) out[i] = 0;
+        return;
+    }
+    const int16_t *weights = eval_weights_at(empties);
+    uint16_t f[EVAL_BATCH_WIDTH][48] __attribute__((aligned(32)));
+    int sums[EVAL_BATCH_WIDTH];
+
+    for (int b = 0; b < n; b += EVAL_BATCH_WIDTH) {
+        int m = (n - b < EVAL_BATCH_WIDTH) ? n - b : EVAL_BATCH_WIDTH;
+        for (int k = 0; k < m; k++) {
+            int move = moves[b + k];
+            uint64_t flip = (move < 0) ? 0 : (ef->opponent & ~child_player[b + k]);
+            eval_features_child_indices(ef, move, flip, f[k]);
+        }
+        switch (EVAL_KERNEL) {
+#ifdef __AVX512F__
+            case EVAL_KERNEL_AVX512_GATHER:
+                eval_features_sum_batch_avx512_gather(weights, (const uint16_t (*)[48])f, m, sums);
+                break;
+#endif
+#ifdef __AVX2__
+            case EVAL_KERNEL_AVX2_GATHER:
+                eval_features_sum_batch_avx2_gather(weights, (const uint16_t (*)[48])f, m, sums);
+                break;
+#endif
+            default:
+                for (int k = 0; k < m; k++) {
+                    sums[k] = 0;
+                    for (uint32_t i = 0; i < EVAL_N_FEATURE; i++) sums[k] += weights[f[k][i]];
+                }
+                break;
+        }
+        for (int k = 0; k < m; k++) out[b + k] = sums[k] / 128;
+    }
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Evaluation Weight Loading (--eval-cache)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// eval.dat は対称な特徴量をまとめた圧縮形式（手数あたり 114364 個）なので、起動のたびに
+// 61 手数 × 226315 個へ展開し直している。展開済みの重みを一度ファイル（キャッシュ）に書き出し、
+// 次回からは読み取り専用で mmap する。ページキャッシュ経由なので、同時に動く複数のソルバーの
+// プロセスが同じ物理メモリを共有する。
+//
+// キャッシュの検証:
+//   - ヘッダ: マジック、版、手数・重みの数・手数ごとの間隔、元の eval.dat のサイズと更新時刻
+//   - 本体: 64 ビットのチェックサム
+// 一致しなければ eval.dat から読み直してキャッシュを作り直す。書き出しは一時ファイルに書いてから
+// rename するので、同時に起動したプロセスが書きかけのキャッシュを読むことはない。
+
+#define EVAL_CACHE_MAGIC "OTHWGT\0\0"
+#define EVAL_CACHE_VERSION 1
+#define EVAL_CACHE_PAYLOAD_OFFSET 4096                  // 重みの先頭（ページ境界）
+#define EVAL_CACHE_STRIDE ((EVAL_N_WEIGHT + 1 + 31) & ~31u)  // 手数ごとの重みの間隔（+1 は gather 用、64 バイト境界）
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_ply;
+    uint32_t n_weight;
+    uint32_t stride;
+    uint32_t eval_version[3];       // eval.dat の version, release, build
+    uint32_t reserved;
+    uint64_t source_size;           // 元の eval.dat
+    int64_t source_mtime_sec;
+    int64_t source_mtime_nsec;
+    uint64_t payload_bytes;
+    uint64_t checksum;              // 本体のチェックサム
+} EvalCacheHeader;
+
+static void *EVAL_WEIGHT_MAP = NULL;           // mmap したキャッシュ（NULL: calloc した重み）
+static size_t EVAL_WEIGHT_MAP_BYTES = 0;
+static const char *EVAL_LOAD_SOURCE = "none";  // eval.dat / cache / cache-created
+static double EVAL_LOAD_MS = 0.0;
+
+// 本体のチェックサム（4 系列の乗算ハッシュを最後に混ぜる）
+static uint64_t eval_cache_checksum(const void *data, size_t bytes) {
+    const uint64_t *w = data;
+    size_t n = bytes / sizeof(uint64_t);
+    uint64_t h[4] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0x27D4EB2F165667C5ULL};
+    for (size_t i = 0; i < n; i++) {
+        h[i & 3] = (h[i & 3] ^ w[i]) * 0x100000001B3ULL;
+    }
+    return h[0] ^ (h[1] << 1 | h[1] >> 63) ^ (h[2] << 2 | h[2] >> 62) ^ (h[3] << 3 | h[3] >> 61);
+}
+
+static void eval_cache_path(const char *eval_file, char *path, size_t size) {
+    if (EVAL_CACHE_FILE) {
+        snprintf(path, size, "%s", EVAL_CACHE_FILE);
+    } else {
+        snprintf(path, size, "%s%s", eval_file, EVAL_CACHE_SUFFIX);
+    }
+}
+
+// 重みのポインタ表（EVAL_WEIGHT[ply][0]）を base から stride 間隔で作る
+static void eval_weight_set_pointers(int16_t *base, size_t stride) {
+    EVAL_WEIGHT = calloc(EVAL_N_PLY, sizeof(int16_t**));
+    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+        EVAL_WEIGHT[ply] = calloc(1, sizeof(int16_t*));
+        EVAL_WEIGHT[ply][0] = base + ply * stride;
+    }
+}
+
+// キャッシュを mmap する。無い・古い・壊れているときは false
+static bool eval_cache_map(const char *path, const struct stat *source, uint32_t *eval_version) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    size_t expected = EVAL_CACHE_PAYLOAD_OFFSET + (size_t)EVAL_N_PLY * EVAL_CACHE_STRIDE * sizeof(int16_t);
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != expected) {
+        close(fd);
+        return false;
+    }
+    void *map = mmap(NULL, expected, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const EvalCacheHeader *h = map;
+    const char *payload = (const char *)map + EVAL_CACHE_PAYLOAD_OFFSET;
+    size_t payload_bytes = expected - EVAL_CACHE_PAYLOAD_OFFSET;
+    bool valid = memcmp(h->magic, EVAL_CACHE_MAGIC, sizeof(h->magic)) == 0 &&
+                 h->version == EVAL_CACHE_VERSION &&
+                 h->n_ply == EVAL_N_PLY && h->n_weight == EVAL_N_WEIGHT && h->stride == EVAL_CACHE_STRIDE &&
+                 h->source_size == (uint64_t)source->st_size &&
+                 h->source_mtime_sec == (int64_t)source->st_mtim.tv_sec &&
+                 h->source_mtime_nsec == (int64_t)source->st_mtim.tv_nsec &&
+                 h->payload_bytes == payload_bytes &&
+                 h->checksum == eval_cache_checksum(payload, payload_bytes);
+    if (!valid) {
+        debug_log("Evaluation cache %s is stale or corrupt, rebuilding\n", path);
+        munmap(map, expected);
+        return false;
+    }
+
+    memcpy(eval_version, h->eval_version, sizeof(h->eval_version));
+    EVAL_WEIGHT_MAP = map;
+    EVAL_WEIGHT_MAP_BYTES = expected;
+    eval_weight_set_pointers((int16_t *)payload, EVAL_CACHE_STRIDE);
+    return true;
+}
+
+// 展開済みの重み（EVAL_WEIGHT）をキャッシュに書き出す
+static bool eval_cache_write(const char *path, const struct stat *source, const uint32_t *eval_version) {
+    size_t payload_bytes = (size_t)EVAL_N_PLY * EVAL_CACHE_STRIDE * sizeof(int16_t);
+    int16_t *payload = calloc((size_t)EVAL_N_PLY * EVAL_CACHE_STRIDE, sizeof(int16_t));
+    if (!payload) return false;
+    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+        memcpy(payload + (size_t)ply * EVAL_CACHE_STRIDE, EVAL_WEIGHT[ply][0], EVAL_N_WEIGHT * sizeof(int16_t));
+    }
+
+    char header[EVAL_CACHE_PAYLOAD_OFFSET];
+    memset(header, 0, sizeof(header));
+    EvalCacheHeader *h = (EvalCacheHeader *)header;
+    memcpy(h->magic, EVAL_CACHE_MAGIC, sizeof(h->magic));
+    h->version = EVAL_CACHE_VERSION;
+    h->n_ply = EVAL_N_PLY;
+    h->n_weight = EVAL_N_WEIGHT;
+    h->stride = EVAL_CACHE_STRIDE;
+    memcpy(h->eval_version, eval_version, sizeof(h->eval_version));
+    h->source_size = (uint64_t)source->st_size;
+    h->source_mtime_sec = (int64_t)source->st_mtim.tv_sec;
+    h->source_mtime_nsec = (int64_t)source->st_mtim.tv_nsec;
+    h->payload_bytes = payload_bytes;
+    h->checksum = eval_cache_checksum(payload, payload_bytes);
+
+    char tmp_path[PATH_MAX + 32];
+    int n = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d", path, (int)getpid());
+    if (n < 0 || (size_t)n >= sizeof(tmp_path)) {
+        free(payload);
+        return false;
+    }
+    FILE *f = fopen(tmp_path, "wb");
+    bool ok = f &&
+              fwrite(header, 1, sizeof(header), f) == sizeof(header) &&
+              fwrite(payload, 1, payload_bytes, f) == payload_bytes;
+    if (f && fclose(f) != 0) ok = false;
+    if (ok && rename(tmp_path, path) != 0) ok = false;
+    if (!ok) {
+        if (f) unlink(tmp_path);
+        fprintf(stderr, "Warning: Cannot write evaluation cache %s\n", path);
+    }
+    free(payload);
+    return ok;
+}
+
+// eval.dat を読み、重みを展開する
+static bool eval_weights_read(const char *filename, uint32_t *eval_version) {
+    const uint32_t n_w = 114364;
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        fprintf(stderr, "Warning: Cannot open evaluation file %s\n", filename);
+        return false;
+    }
+
+    uint32_t edax_header, eval_header, version, release, build;
+    double date;
+
+    if (fread(&edax_header, sizeof(uint32_t), 1, f) != 1 ||
+        fread(&eval_header, sizeof(uint32_t), 1, f) != 1 ||
+        fread(&version, sizeof(uint32_t), 1, f) != 1 ||
+        fread(&release, sizeof(uint32_t), 1, f) != 1 ||
+        fread(&build, sizeof(uint32_t), 1, f) != 1 ||
+        fread(&date, sizeof(double), 1, f) != 1) {
+        fprintf(stderr, "Warning: Cannot read eval.dat header\n");
+        fclose(f);
+        return false;
+    }
+    eval_version[0] = version;
+    eval_version[1] = release;
+    eval_version[2] = build;
+
+    EVAL_WEIGHT = calloc(EVAL_N_PLY, sizeof(int16_t**));
+    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+        EVAL_WEIGHT[ply] = calloc(1, sizeof(int16_t*));
+        // +1: gather 版は int16 の重みを 32 ビットで読むので、末尾の次の要素まで確保する
+        EVAL_WEIGHT[ply][0] = calloc(EVAL_N_WEIGHT + 1, sizeof(int16_t));
+    }
+
+    int16_t *w = malloc(n_w * sizeof(int16_t));
+    bool complete = true;
+
+    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+        if (fread(w, sizeof(int16_t), n_w, f) != n_w) {
+            fprintf(stderr, "Warning: Incomplete eval.dat file at ply %u\n", ply);
+            complete = false;
+            break;
+        }
+
+        int j = 0;
+        for (int i = 0; i < 13 && j < (int)EVAL_N_WEIGHT; i++) {
+            for (uint32_t k = 0; k < EVAL_SIZE[i] && j < (int)EVAL_N_WEIGHT; k++, j++) {
+                if (k < EVAL_PACKED_SIZE[i]) {
+                    EVAL_WEIGHT[ply][0][j] = w[k];
+                }
+            }
+        }
+    }
+
+    free(w);
+    fclose(f);
+    return complete;
+}
+
+static bool load_evaluation_weights(const char *filename) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    uint32_t eval_version[3] = {0, 0, 0};
+    struct stat source;
+    char cache_path[PATH_MAX];
+    bool use_cache = EVAL_CACHE && stat(filename, &source) == 0;
+    if (use_cache) eval_cache_path(filename, cache_path, sizeof(cache_path));
+
+    if (use_cache && eval_cache_map(cache_path, &source, eval_version)) {
+        EVAL_LOAD_SOURCE = "cache";
+        debug_log("Mapped evaluation weights from %s\n", cache_path);
+    } else {
+        bool complete = eval_weights_read(filename, eval_version);
+        if (!EVAL_WEIGHT) return false;
+        EVAL_LOAD_SOURCE = "eval.dat";
+        // 途中までしか読めなかった重みはキャッシュしない
+        if (use_cache && complete && eval_cache_write(cache_path, &source, eval_version)) {
+            EVAL_LOAD_SOURCE = "cache-created";
+            debug_log("Wrote evaluation cache %s\n", cache_path);
+        }
+    }
+
+    eval_features_init_tables();
+    eval_simd_init_tables();
+    check_cpu_features();
+    eval_kernel_resolve();
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    EVAL_LOAD_MS = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+
+    debug_log("Loaded evaluation weights from %s (version %u.%u.%u, %s, %.3f ms)\n",
+           filename, eval_version[0], eval_version[1], eval_version[2], EVAL_LOAD_SOURCE, EVAL_LOAD_MS);
+
+    return true;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// NUMA-replicated Weights (--eval-numa)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 重み（27 MB）は1組しかないので、2ソケット機では半分のワーカーが評価のたびにソケット間で
+// 重みを読む。NUMAノードごとに複製を作り、ワーカーは自分が動いているノードの複製を
+// スレッドローカルのポインタ（EVAL_WEIGHT_LOCAL）で読む。
+//
+// トポロジは /sys/devices/system/node/node<N>/cpulist から読む（libnuma は使わない）。
+// 複製は、そのノードのCPUに固定した一時スレッドが書き込むので、first-touch でノードの
+// ローカルメモリに置かれる。ワーカーのアフィニティが1ノードに収まればそのノード、
+// 収まらなければ sched_getcpu() のノードをタスクごとに選び直す（OSがスレッドを移すため）。
+
+static int EVAL_NUMA_N_NODES = 0;                               // CPUを持つノードの数
+static int EVAL_NUMA_NODE_ID[EVAL_NUMA_MAX_NODES];              // /sys のノード番号
+static cpu_set_t EVAL_NUMA_CPUS[EVAL_NUMA_MAX_NODES];
+static int16_t ***EVAL_NUMA_REPLICA[EVAL_NUMA_MAX_NODES];       // ノードごとの重み（NULL: 複製なし）
+static void *EVAL_NUMA_MEM[EVAL_NUMA_MAX_NODES];
+static size_t EVAL_NUMA_BYTES = 0;
+
+// "0-3,8-11" 形式のCPUリスト
+static void numa_parse_cpulist(const char *list, cpu_set_t *set) {
+    CPU_ZERO(set);
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long lo = strtol(p, &end, 10);
+        if (end == p) break;
+        long hi = lo;
+        p = end;
+        if (*p == '-') {
+            hi = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = lo; cpu <= hi && cpu < CPU_SETSIZE; cpu++) CPU_SET(cpu, set);
+        if (*p == ',') p++;
+        else break;
+    }
+}
+
+#ifdef STANDALONE_MAIN
+static void eval_numa_read_topology(void) {
+    EVAL_NUMA_N_NODES = 0;
+    for (int node = 0; node < 1024 && EVAL_NUMA_N_NODES < EVAL_NUMA_MAX_NODES; node++) {
+        char path[64], list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        FILE *f = fopen(path, "r");
+        if (!f) continue;
+        bool ok = fgets(list, sizeof(list), f) != NULL;
+        fclose(f);
+        if (!ok) continue;
+
+        cpu_set_t *cpus = &EVAL_NUMA_CPUS[EVAL_NUMA_N_NODES];
+        numa_parse_cpulist(list, cpus);
+        if (CPU_COUNT(cpus) == 0) continue;     // CPUのないノード（メモリのみ）
+        EVAL_NUMA_NODE_ID[EVAL_NUMA_N_NODES++] = node;
+    }
+}
+
+typedef struct {
+    int16_t *dst;
+} EvalNumaCopy;
+
+// ノードのCPUに固定されたスレッドで実行し、複製のページをそのノードに置く
+static void *eval_numa_copy_thread(void *arg) {
+    EvalNumaCopy *copy = arg;
+    for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+        int16_t *dst = copy->dst + (size_t)ply * EVAL_CACHE_STRIDE;
+        memcpy(dst, EVAL_WEIGHT[ply][0], EVAL_N_WEIGHT * sizeof(int16_t));
+        memset(dst + EVAL_N_WEIGHT, 0, (EVAL_CACHE_STRIDE - EVAL_N_WEIGHT) * sizeof(int16_t));
+    }
+    return NULL;
+}
+
+// 重みの読み込み後、ワーカーの起動前に呼ぶ
+static void eval_numa_replicate(void) {
+    if (!EVAL_NUMA || !EVAL_WEIGHT || EVAL_NUMA_BYTES > 0) return;
+
+    eval_numa_read_topology();
+    if (EVAL_NUMA_N_NODES < EVAL_NUMA_MIN_NODES) {
+        debug_log("NUMA replicas: %d node(s) with CPUs, using the shared weights\n", EVAL_NUMA_N_NODES);
+        return;
+    }
+
+    size_t bytes = (size_t)EVAL_N_PLY * EVAL_CACHE_STRIDE * sizeof(int16_t);
+    for (int n = 0; n < EVAL_NUMA_N_NODES; n++) {
+        void *mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            fprintf(stderr, "Warning: Cannot allocate NUMA replica for node %d\n", EVAL_NUMA_NODE_ID[n]);
+            continue;
+        }
+
+        EvalNumaCopy copy = {.dst = mem};
+        pthread_attr_t attr;
+        pthread_t thread;
+        pthread_attr_init(&attr);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &EVAL_NUMA_CPUS[n]);
+        if (pthread_create(&thread, &attr, eval_numa_copy_thread, &copy) == 0) {
+            pthread_join(thread, NULL);
+        } else {
+            eval_numa_copy_thread(&copy);   // 固定できなければこのスレッドで書く（配置はOS任せ）
+        }
+        pthread_attr_destroy(&attr);
+        mprotect(mem, bytes, PROT_READ);
+
+        int16_t ***table = calloc(EVAL_N_PLY, sizeof(int16_t**));
+        for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+            table[ply] = calloc(1, sizeof(int16_t*));
+            table[ply][0] = (int16_t *)mem + (size_t)ply * EVAL_CACHE_STRIDE;
+        }
+        EVAL_NUMA_MEM[n] = mem;
+        EVAL_NUMA_REPLICA[n] = table;
+    }
+    EVAL_NUMA_BYTES = bytes;
+    debug_log("NUMA replicas: %d nodes, %.1f MB each\n", EVAL_NUMA_N_NODES, bytes / (1024.0 * 1024.0));
+}
+#endif
+
+// cpu を含むノード（EVAL_NUMA_* の添字、見つからなければ -1）
+static int eval_numa_index_of_cpu(int cpu) {
+    if (cpu < 0) return -1;
+    for (int n = 0; n < EVAL_NUMA_N_NODES; n++) {
+        if (CPU_ISSET(cpu, &EVAL_NUMA_CPUS[n])) return n;
+    }
+    return -1;
+}
+
+// 呼び出したスレッドのアフィニティが収まるノード（収まらなければ -1）
+static int eval_numa_index_of_affinity(void) {
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return -1;
+    for (int n = 0; n < EVAL_NUMA_N_NODES; n++) {
+        cpu_set_t common;
+        CPU_AND(&common, &mask, &EVAL_NUMA_CPUS[n]);
+        if (CPU_EQUAL(&common, &mask)) return n;
+    }
+    return -1;
+}
+
+static void eval_numa_free(void) {
+    for (int n = 0; n < EVAL_NUMA_N_NODES; n++) {
+        if (EVAL_NUMA_REPLICA[n]) {
+            for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) free(EVAL_NUMA_REPLICA[n][ply]);
+            free(EVAL_NUMA_REPLICA[n]);
+            munmap(EVAL_NUMA_MEM[n], EVAL_NUMA_BYTES);
+            EVAL_NUMA_REPLICA[n] = NULL;
+            EVAL_NUMA_MEM[n] = NULL;
+        }
+    }
+    EVAL_NUMA_BYTES = 0;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Cache Topology for Hierarchical Queues (--queues hier)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// L3ドメイン（L3を共有するCPUの集合）は /sys/devices/system/cpu/cpu<N>/cache/index<i>/
+// の level = 3 のキャッシュの shared_cpu_list、ソケットは topology/physical_package_id から読む。
+// L3の情報がなければソケットを1つのL3ドメインとし、何も読めなければ全体で1ドメインにする。
+
+static int QUEUE_TOPO_N_L3 = 0;
+static int QUEUE_TOPO_N_SOCKETS = 0;
+static cpu_set_t QUEUE_TOPO_L3_CPUS[QUEUE_HIER_MAX_L3];
+static int QUEUE_TOPO_L3_SOCKET[QUEUE_HIER_MAX_L3];         // L3ドメイン → ソケット（添字）
+
+// 1行のファイルを読む（読めなければ false）
+static bool read_sysfs_line(const char *path, char *buf, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    bool ok = fgets(buf, (int)size, f) != NULL;
+    fclose(f);
+    return ok;
+}
+
+// cpu の L3 を共有するCPUの集合（見つからなければ false）
+static bool queue_topo_l3_of_cpu(int cpu, cpu_set_t *set) {
+    for (int index = 0; index < 10; index++) {
+        char path[128], line[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+        if (!read_sysfs_line(path, line, sizeof(line))) return false;
+        if (atoi(line) != 3) continue;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+        if (!read_sysfs_line(path, line, sizeof(line))) return false;
+        numa_parse_cpulist(line, set);
+        return CPU_COUNT(set) > 0;
+    }
+    return false;
+}
+
+static void queue_read_topology(void) {
+    int package_id[QUEUE_HIER_MAX_SOCKETS];
+    cpu_set_t online;
+    char line[4096];
+
+    QUEUE_TOPO_N_L3 = 0;
+    QUEUE_TOPO_N_SOCKETS = 0;
+    if (!read_sysfs_line("/sys/devices/system/cpu/online", line, sizeof(line))) {
+        CPU_ZERO(&online);
+    } else {
+        numa_parse_cpulist(line, &online);
+    }
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &online)) continue;
+
+        // ソケット（physical_package_id を添字に詰める）
+        char path[128];
+        int pkg = 0;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        if (read_sysfs_line(path, line, sizeof(line))) pkg = atoi(line);
+        int socket = -1;
+        for (int s = 0; s < QUEUE_TOPO_N_SOCKETS; s++) {
+            if (package_id[s] == pkg) socket = s;
+        }
+        if (socket < 0) {
+            if (QUEUE_TOPO_N_SOCKETS < QUEUE_HIER_MAX_SOCKETS) {
+                socket = QUEUE_TOPO_N_SOCKETS++;
+                package_id[socket] = pkg;
+            } else {
+                socket = QUEUE_HIER_MAX_SOCKETS - 1;
+            }
+        }
+
+        // 既に登録したL3ドメインに含まれるCPUなら次へ
+        bool known = false;
+        for (int d = 0; d < QUEUE_TOPO_N_L3 && !known; d++) {
+            known = CPU_ISSET(cpu, &QUEUE_TOPO_L3_CPUS[d]);
+        }
+        if (known) continue;
+
+        cpu_set_t l3;
+        if (!queue_topo_l3_of_cpu(cpu, &l3)) {
+            // L3の情報なし: ソケットのCPUをまとめて1ドメインにする（同じソケットの既存ドメインに追加）
+            int d = 0;
+            while (d < QUEUE_TOPO_N_L3 && QUEUE_TOPO_L3_SOCKET[d] != socket) d++;
+            if (d == QUEUE_TOPO_N_L3 && QUEUE_TOPO_N_L3 < QUEUE_HIER_MAX_L3) {
+                CPU_ZERO(&QUEUE_TOPO_L3_CPUS[d]);
+                QUEUE_TOPO_L3_SOCKET[d] = socket;
+                QUEUE_TOPO_N_L3++;
+            }
+            if (d >= QUEUE_HIER_MAX_L3) d = QUEUE_HIER_MAX_L3 - 1;
+            CPU_SET(cpu, &QUEUE_TOPO_L3_CPUS[d]);
+            continue;
+        }
+        if (QUEUE_TOPO_N_L3 < QUEUE_HIER_MAX_L3) {
+            QUEUE_TOPO_L3_CPUS[QUEUE_TOPO_N_L3] = l3;
+            QUEUE_TOPO_L3_SOCKET[QUEUE_TOPO_N_L3] = socket;
+            QUEUE_TOPO_N_L3++;
+        } else {
+            CPU_OR(&QUEUE_TOPO_L3_CPUS[QUEUE_HIER_MAX_L3 - 1], &QUEUE_TOPO_L3_CPUS[QUEUE_HIER_MAX_L3 - 1], &l3);
+        }
+    }
+
+    if (QUEUE_TOPO_N_L3 == 0) {
+        // トポロジが読めない: 全CPUで1ドメイン・1ソケット
+        CPU_ZERO(&QUEUE_TOPO_L3_CPUS[0]);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) CPU_SET(cpu, &QUEUE_TOPO_L3_CPUS[0]);
+        QUEUE_TOPO_L3_SOCKET[0] = 0;
+        QUEUE_TOPO_N_L3 = 1;
+        QUEUE_TOPO_N_SOCKETS = 1;
+    }
+    debug_log("Queue topology: %d L3 domains, %d sockets\n", QUEUE_TOPO_N_L3, QUEUE_TOPO_N_SOCKETS);
+}
+
+// cpu を含むL3ドメイン（見つからなければ 0）
+static int queue_topo_l3_of(int cpu) {
+    if (cpu < 0) return 0;
+    for (int d = 0; d < QUEUE_TOPO_N_L3; d++) {
+        if (CPU_ISSET(cpu, &QUEUE_TOPO_L3_CPUS[d])) return d;
+    }
+    return 0;
+}
+
+// 呼び出したスレッドのアフィニティが収まるL3ドメイン（収まらなければ -1）
+static int queue_topo_l3_of_affinity(void) {
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) != 0) return -1;
+    for (int d = 0; d < QUEUE_TOPO_N_L3; d++) {
+        cpu_set_t common;
+        CPU_AND(&common, &mask, &QUEUE_TOPO_L3_CPUS[d]);
+        if (CPU_EQUAL(&common, &mask)) return d;
+    }
+    return -1;
+}
+
+static void free_evaluation_weights() {
+    eval_hash_free();
+    eval_numa_free();
+    if (EVAL_WEIGHT) {
+        for (uint32_t ply = 0; ply < EVAL_N_PLY; ply++) {
+            if (EVAL_WEIGHT[ply]) {
+                if (!EVAL_WEIGHT_MAP) free(EVAL_WEIGHT[ply][0]);
+                free(EVAL_WEIGHT[ply]);
+            }
+        }
+        free(EVAL_WEIGHT);
+        EVAL_WEIGHT = NULL;
+    }
+    if (EVAL_WEIGHT_MAP) {
+        munmap(EVAL_WEIGHT_MAP, EVAL_WEIGHT_MAP_BYTES);
+        EVAL_WEIGHT_MAP = NULL;
+        EVAL_WEIGHT_MAP_BYTES = 0;
+    }
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Transposition Table
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+typedef struct {
+    uint64_t key;
+    uint32_t pn;
+    uint32_t dn;
+    Result result;
+    int8_t depth;
+    int16_t eval_score;
+    uint8_t age;
+    int8_t target;      // pn/dnの証明目標（石差 >= target を pn = 0 とする）
+    int8_t lower;       // 証明済みの最終石差の下限（ルートムーブを打ったプレイヤー視点）
+    int8_t upper;       // 証明済みの最終石差の上限
+    uint32_t source;    // ソースマーカー: このエントリを最初に作った親局面のタグ（0 = 不明、--dag）
+} TTEntry;
+
+// Stripe lock configuration for TT
+// Fixed number of stripes with cache line padding to prevent false sharing
+#define TT_LOCK_STRIPES 1024
+
+// Cache-line aligned lock structure to prevent false sharing
+typedef struct {
+    pthread_rwlock_t lock;
+    char padding[CACHE_LINE_SIZE - sizeof(pthread_rwlock_t)];
+} __attribute__((aligned(CACHE_LINE_SIZE))) AlignedLock;
+
+typedef struct {
+    TTEntry *entries;
+    size_t size;
+    size_t mask;
+    AlignedLock locks[TT_LOCK_STRIPES];  // Fixed stripe locks with padding
+
+    // Statistics (use atomic operations, no lock needed)
+    volatile uint64_t hits;
+    volatile uint64_t stores;
+    volatile uint64_t collisions;
+} TranspositionTable;
+
+static uint64_t zobrist_table[2][64];
+static bool zobrist_initialized = false;
+
+static void init_zobrist() {
+    if (zobrist_initialized) return;
+    srand(12345);
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 64; j++) {
+            zobrist_table[i][j] = ((uint64_t)rand() << 32) | rand();
+        }
+    }
+    zobrist_initialized = true;
+}
+
+static inline uint64_t hash_position(uint64_t P, uint64_t O) {
+    // ────────────────────────────────────────────────────────────
     // [最適化] init_zobrist()呼び出しを削除
     // ────────────────────────────────────────────────────────────
     // 【元のコード】
@@ -1890,822 +4021,2511 @@ static inline uint64_t hash_position(uint64_t P, uint64_t O) {
     //   solve_endgame()内の対応するinit_zobrist()呼び出しを削除する
     // ────────────────────────────────────────────────────────────
 
-    uint64_t unique_P, unique_O;
-    board_unique(P, O, &unique_P, &unique_O);
+    uint64_t unique_P, unique_O;
+    board_unique(P, O, &unique_P, &unique_O);
+
+    uint64_t hash = 0;
+    for (int i = 0; i < 64; i++) {
+        if (unique_P & (1ULL << i)) hash ^= zobrist_table[0][i];
+        if (unique_O & (1ULL << i)) hash ^= zobrist_table[1][i];
+    }
+    return hash;
+}
+
+static TranspositionTable* tt_create(size_t size_mb) {
+    TranspositionTable *tt = calloc(1, sizeof(TranspositionTable));
+
+    size_t entry_size = sizeof(TTEntry);
+    size_t n_entries = (size_mb << 20) / entry_size;
+
+    size_t size = 1;
+    while (size < n_entries) size <<= 1;
+    size >>= 1;
+
+    tt->size = size;
+    tt->mask = size - 1;
+    tt->entries = calloc(size, sizeof(TTEntry));
+
+    // Initialize fixed stripe locks (much fewer than entries)
+    for (int i = 0; i < TT_LOCK_STRIPES; i++) {
+        pthread_rwlock_init(&tt->locks[i].lock, NULL);
+    }
+
+    debug_log("TT created: %zu MB (%zu entries)\n", size_mb, size);
+
+    return tt;
+}
+
+static void tt_free(TranspositionTable *tt) {
+    for (int i = 0; i < TT_LOCK_STRIPES; i++) {
+        pthread_rwlock_destroy(&tt->locks[i].lock);
+    }
+    free(tt->entries);
+    free(tt);
+}
+
+// 証明目標の異なる探索（--exact の並列しきい値、勝敗判定の2つの問い）でTTを共有するため、
+// 証明済みの結果はエントリの石差の範囲 [lower, upper] に畳み込んで保持する。
+// 範囲で決着する目標はどの目標からでもヒットし、未証明のpn/dnは同じ目標でのみ使う。
+static bool tt_probe(TranspositionTable *tt, uint64_t key, int depth, int target,
+                    uint32_t *pn, uint32_t *dn, Result *result, int16_t *eval_score,
+                    uint32_t *source) {
+    size_t index = key & tt->mask;
+    // Use higher bits of key for stripe selection (better distribution)
+    int lock_index = (key >> 20) & (TT_LOCK_STRIPES - 1);
+
+    pthread_rwlock_rdlock(&tt->locks[lock_index].lock);
+    TTEntry *entry = &tt->entries[index];
+
+    bool hit = false;
+    if (entry->key == key && entry->depth >= depth) {
+        hit = true;
+        if (entry->lower >= target) {
+            *pn = 0;
+            *dn = DN_INF;
+            *result = RESULT_EXACT_WIN;
+        } else if (entry->upper < target) {
+            *pn = PN_INF;
+            *dn = 0;
+            *result = RESULT_EXACT_LOSE;
+        } else if (entry->target == target) {
+            *pn = entry->pn;
+            *dn = entry->dn;
+            *result = entry->result;
+        } else {
+            hit = false;
+        }
+        if (hit) {
+            if (eval_score) *eval_score = entry->eval_score;
+            __sync_fetch_and_add(&tt->hits, 1);
+        }
+    } else if (entry->key != 0 && entry->key != key) {
+        __sync_fetch_and_add(&tt->collisions, 1);
+    }
+    // ソースマーカーは深さ・目標によらず、同じ局面のエントリがあれば返す
+    if (source && entry->key == key && entry->source != 0) {
+        *source = entry->source;
+    }
+
+    pthread_rwlock_unlock(&tt->locks[lock_index].lock);
+    return hit;
+}
+
+static void tt_store(TranspositionTable *tt, uint64_t key, int depth, int target,
+                    uint32_t pn, uint32_t dn, Result result, int16_t eval_score,
+                    uint32_t source) {
+    size_t index = key & tt->mask;
+    // Use higher bits of key for stripe selection (same as tt_probe)
+    int lock_index = (key >> 20) & (TT_LOCK_STRIPES - 1);
+
+    pthread_rwlock_wrlock(&tt->locks[lock_index].lock);
+    TTEntry *entry = &tt->entries[index];
+
+    if (entry->depth <= depth) {
+        if (entry->key != key) {
+            entry->lower = SCORE_MIN;
+            entry->upper = SCORE_MAX;
+            entry->source = source;
+        } else if (entry->source == 0) {
+            entry->source = source;
+        }
+        entry->key = key;
+        entry->pn = pn;
+        entry->dn = dn;
+        entry->result = result;
+        entry->depth = depth;
+        entry->eval_score = eval_score;
+        entry->age = 0;
+        entry->target = target;
+
+        // 証明済みなら石差の範囲を狭める
+        if (pn == 0) {
+            if (target > entry->lower) entry->lower = target;
+        } else if (dn == 0) {
+            if (target - 1 < entry->upper) entry->upper = target - 1;
+        }
+        __sync_fetch_and_add(&tt->stores, 1);
+    }
+
+    pthread_rwlock_unlock(&tt->locks[lock_index].lock);
+}
+
+// 証明済みの石差の範囲を読む（エントリが無ければ [SCORE_MIN, SCORE_MAX]）
+// 読み筋・証明木の取り出し用（統計は数えない）
+static void tt_probe_bounds(TranspositionTable *tt, uint64_t key, int depth, int *lower, int *upper) {
+    size_t index = key & tt->mask;
+    int lock_index = (key >> 20) & (TT_LOCK_STRIPES - 1);
+
+    *lower = SCORE_MIN;
+    *upper = SCORE_MAX;
+    pthread_rwlock_rdlock(&tt->locks[lock_index].lock);
+    TTEntry *entry = &tt->entries[index];
+    if (entry->key == key && entry->depth >= depth) {
+        *lower = entry->lower;
+        *upper = entry->upper;
+    }
+    pthread_rwlock_unlock(&tt->locks[lock_index].lock);
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// df-pn+ Node
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+typedef struct DFPNNode {
+    uint64_t player;
+    uint64_t opponent;
+
+    uint32_t pn;
+    uint32_t dn;
+    uint32_t threshold_pn;
+    uint32_t threshold_dn;
+
+    Result result;
+    NodeType type;
+    int16_t eval_score;
+    bool is_proven;  // 完全に証明されたかどうか（終端ノードから正しく伝播）
+    bool on_path;    // 現在の探索パス上にあるか（GCで回収してはならない）
+    int16_t last_child;          // 前回選んだ子のインデックス（-1 = 未選択）
+    uint16_t sibling_switches;   // 前回と異なる子を選んだ回数
+
+    struct DFPNNode **children;
+    int16_t n_children;
+    bool eval_pending;           // 子の評価を2回目の訪問まで遅らせている（--eval-lazy）
+    int depth;
+
+    float deep;                  // DPN: 深層値 1/(60 - 空きマス数)、最良子から伝播
+    uint32_t source;             // --dag: この局面のTTエントリのソースマーカー（0 = 不明）
+    struct DFPNNode *next_free;  // NodePoolフリーリスト用
+} DFPNNode;
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// MoveWithEval: 手と評価値を保存（expand_node最適化用）
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+typedef struct {
+    int move;
+    int eval_score;
+    uint64_t player;
+    uint64_t opponent;
+} MoveWithEval;
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Memory Pool for DFPNNode (Arena Allocator)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+#define NODE_POOL_BLOCK_SIZE 8192
+
+typedef struct NodePoolBlock {
+    DFPNNode *nodes;
+    struct NodePoolBlock *next;
+} NodePoolBlock;
+
+typedef struct {
+    NodePoolBlock *first_block;
+    NodePoolBlock *current_block;
+    int current_index;
+    int block_size;
+    uint64_t total_allocated;
+
+    // Bounded-memory df-pn: GCで回収したノードを再利用するフリーリスト
+    DFPNNode *free_list;
+    uint64_t live_nodes;        // 現在生存しているノード数
+    uint64_t peak_live_nodes;   // 生存ノード数の最大値
+} NodePool;
+
+static void node_pool_init(NodePool *pool) {
+    pool->block_size = NODE_POOL_BLOCK_SIZE;
+    pool->first_block = malloc(sizeof(NodePoolBlock));
+    pool->first_block->nodes = calloc(pool->block_size, sizeof(DFPNNode));
+    pool->first_block->next = NULL;
+    pool->current_block = pool->first_block;
+    pool->current_index = 0;
+    pool->total_allocated = 0;
+    pool->free_list = NULL;
+    pool->live_nodes = 0;
+    pool->peak_live_nodes = 0;
+}
+
+static DFPNNode* node_pool_alloc(NodePool *pool) {
+    pool->live_nodes++;
+    if (pool->live_nodes > pool->peak_live_nodes) {
+        pool->peak_live_nodes = pool->live_nodes;
+    }
+
+    // フリーリストを優先（GCで回収されたノード）
+    if (pool->free_list) {
+        DFPNNode *node = pool->free_list;
+        pool->free_list = node->next_free;
+        memset(node, 0, sizeof(DFPNNode));
+        return node;
+    }
+
+    if (pool->current_index >= pool->block_size) {
+        // Need new block
+        if (pool->current_block->next == NULL) {
+            // Allocate new block
+            NodePoolBlock *new_block = malloc(sizeof(NodePoolBlock));
+            new_block->nodes = calloc(pool->block_size, sizeof(DFPNNode));
+            new_block->next = NULL;
+            pool->current_block->next = new_block;
+        }
+        pool->current_block = pool->current_block->next;
+        pool->current_index = 0;
+        // Reset nodes in reused block
+        memset(pool->current_block->nodes, 0, pool->block_size * sizeof(DFPNNode));
+    }
+    DFPNNode *node = &pool->current_block->nodes[pool->current_index];
+    pool->current_index++;
+    pool->total_allocated++;
+    // Note: is_proven is initialized to false via calloc/memset
+    return node;
+}
+
+// Return a single node to the free list (children array must already be released)
+static void node_pool_free(NodePool *pool, DFPNNode *node) {
+    node->next_free = pool->free_list;
+    pool->free_list = node;
+    pool->live_nodes--;
+}
+
+static void node_pool_reset(NodePool *pool) {
+    // Reset to beginning - blocks are retained for reuse
+    pool->current_block = pool->first_block;
+    pool->current_index = 0;
+    pool->free_list = NULL;
+    pool->live_nodes = 0;
+    // Reset first block (others reset on demand in node_pool_alloc)
+    memset(pool->first_block->nodes, 0, pool->block_size * sizeof(DFPNNode));
+}
+
+static void node_pool_destroy(NodePool *pool) {
+    NodePoolBlock *block = pool->first_block;
+    while (block) {
+        NodePoolBlock *next = block->next;
+        free(block->nodes);
+        free(block);
+        block = next;
+    }
+    pool->first_block = NULL;
+    pool->current_block = NULL;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Worker with Work Stealing
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+// Global state for hybrid work distribution
+typedef struct Worker Worker;  // Forward declaration
+
+typedef struct {
+    TranspositionTable *tt;
+
+    // Hybrid: GlobalChunkQueue + SharedTaskArray
+    GlobalChunkQueue *global_chunk_queue;
+    SharedTaskArray *shared_array;
+    WorkerState worker_state;
+
+    // --scheduler chaselev: ワーカーごとのdeque（ワーカーIDで添字、NULL = hybrid）
+    ChaseLevDeque *deques;
+
+    // --queues hier: L3ドメインごと・ソケットごとのチャンクキュー（NULL = flat）
+    // global_chunk_queue は最上位（全体）のキューとして使う
+    GlobalChunkQueue **l3_queues;       // [n_l3_queues]
+    GlobalChunkQueue **socket_queues;   // [n_socket_queues]
+    int n_l3_queues;
+    int n_socket_queues;
+
+    // --queues multiqueue: GlobalChunkQueue の代わりに使う緩和優先度キュー（NULL = 使わない）
+    ChunkMultiQueue *mq;
+
+    // Worker references (for statistics)
+    Worker **workers;
+    int n_workers;
+
+    // Results per root move
+    Result *move_results;
+    uint64_t *move_nodes;
+    int *move_list;
+    int *move_evals;
+    int n_moves;
+
+#if ENABLE_EVAL_IMPACT
+    // Evaluation impact tracking (-e option)
+    // 評価関数影響分析用のデータ（ENABLE_EVAL_IMPACT=1 時のみ有効）
+    EvalImpact *eval_impacts;
+    struct timespec *move_start_times;  // 各手の探索開始時刻
+#endif
+
+    // Shared state
+    volatile bool found_win;
+    volatile int winning_move;
+    volatile bool shutdown;
+    volatile int tasks_completed;  // Track completed root tasks
+
+    double time_limit;
+    struct timespec start_time;
+    bool use_evaluation;
+
+    // Dynamic task spawning settings (adjustable for different hardware)
+    int max_generation;         // Max depth of task spawning (default: 3, 40-core: 5)
+    int min_depth_for_spawn;    // Don't spawn subtasks below this depth (default: 6, 40-core: 4)
+    int spawn_threshold;        // Only spawn children with priority above this
+    int spawn_limit;            // Max children to spawn per node (default: 3, 40-core: 6)
+
+    // Bounded-memory df-pn (--node-budget)
+    uint64_t node_budget;       // Per-worker live node budget (0 = unlimited)
+    SearchEngine engine;        // --engine tree|tt
+    double epsilon;             // --epsilon (1+ε threshold, negative = legacy)
+    const struct PnDnInitializer *pn_init;  // --pn-init（新しい葉のpn/dn初期化）
+    PnAggregation aggregation;  // --aggregate（和を取る側の集約）
+    int agg_hybrid_min_empties; // --agg-hybrid-empties（hybrid でWPNを使う空きマス数の下限）
+    double dpn_r;               // --dpn-r（deep proof number の R、負 = 従来の子選択）
+    bool stability;             // --stability（展開前の確定石による判定）
+    int score_target;           // ルートタスクの証明目標（Task.target の初期値）
+
+    // Subtask statistics
+    volatile uint64_t subtasks_spawned;
+    volatile uint64_t subtasks_completed;
+
+    // Hybrid statistics
+    volatile uint64_t total_exports;
+    volatile uint64_t total_imports;
+    volatile uint64_t global_switches;  // tt_store時のGlobal切り替え回数
+
+    // Statistics
+    WorkStealingStats ws_stats;
+    pthread_mutex_t stats_mutex;
+} GlobalState;
+
+struct Worker {
+    pthread_t thread;
+    int id;
+    GlobalState *global;
+
+    // Hybrid: Per-worker LocalHeap
+    LocalHeap local_heap;
+
+    // Local statistics
+    uint64_t nodes;
+    uint64_t tasks_processed;
+    uint64_t tasks_stolen;
+
+    // 処理中のタスクの証明目標（Task.target）
+    int target;
+
+    // Memory pool for node allocation (per-worker, no locking needed)
+    NodePool node_pool;
+
+    // Bounded-memory df-pn: 現在のタスクの木の根とGC統計
+    DFPNNode *gc_root;
+    uint64_t gc_next_trigger;              // 生存ノード数がこの値に達したらGC
+    uint64_t gc_runs;
+    uint64_t gc_nodes_freed;
+
+    // Tree-less engine (--engine tt): スタック上の子ノード数
+    uint64_t path_nodes;
+    uint64_t peak_path_nodes;
+
+    // 1+ε threshold (--epsilon): 兄弟切り替えと再展開の統計
+    uint64_t sibling_switches;
+    uint64_t max_node_switches;            // ノードあたりの切り替え回数の最大値
+    uint64_t reexpansions;                 // TTに未証明の値がある局面の再展開
+
+    // 確定石による早期証明（--stability）: 空きマス数ごとの判定対象ノード数と証明数
+    uint64_t stability_nodes[65];
+    uint64_t stability_cuts[65];
+
+    // 合流を考慮した和（--dag）: 別の親がソースの局面の検出数と、和を補正した更新の数
+    uint64_t dag_transpositions;
+    uint64_t dag_corrections;
+
+    // 手の順序付け（--ordering）: 空きマス数の区分 × マスの履歴表と、空きマス数ごとのキラー手
+    // 子が親を証明（ORで勝ち）・反証（ANDで負け）したときに、その手を手番側の良い手として記録する
+    uint32_t history[HISTORY_BUCKETS][64];
+    uint32_t history_max[HISTORY_BUCKETS];
+    int8_t killer[65][2];
+    uint64_t history_updates;
+    uint64_t ordering_cutoffs;             // 親を証明した子の数
+    uint64_t ordering_first_cutoffs;       // そのうち最初に並べた子（children[0]）だった数
+    uint64_t endgame_order_expansions;     // 終盤用の順序付けで並べた展開の数（--endgame-order）
+
+    // Enhanced transposition cutoff（--etc）: 展開時にTTを引いた子の数、ヒット数、親を証明した展開数
+    uint64_t etc_probes;
+    uint64_t etc_hits;
+    uint64_t etc_cutoffs;
+
+    // 増分評価（--eval-incremental）: 再帰の段ごとの特徴量（eval_path[eval_ply] が探索中のノード）
+    EvalFeatures eval_path[EVAL_PATH_MAX];
+    int eval_ply;
+    uint64_t eval_incremental_evals;       // 差分で評価した子の数
+    uint64_t eval_feature_rebuilds;        // 段の局面が違い、特徴量を最初から作り直した数
+    // まとめ評価（--eval-batch）: まとめて評価した回数と、その子の数
+    uint64_t eval_batches;
+    uint64_t eval_batched_children;
+    // 評価の遅延・省略（--eval-lazy、--eval-min-empties）
+    uint64_t eval_child_evals;             // 展開時・2回目の訪問で評価した子の数
+    uint64_t eval_lazy_deferred;           // 評価を2回目の訪問まで遅らせた子の数
+    uint64_t eval_lazy_resolved;           // そのうち2回目の訪問で評価した子の数
+    uint64_t eval_gated;                   // 空きマス数のしきい値で評価しなかった子の数
+    // 評価値キャッシュ（--eval-hash）: 引いた子の数とヒット数
+    uint64_t eval_hash_probes;
+    uint64_t eval_hash_hits;
+    // NUMA複製（--eval-numa）: 使っている複製のノード（-1: 共有の重み）と、複製を替えた回数
+    int eval_numa_node;
+    bool eval_numa_pinned;                 // アフィニティが1ノードに収まる（タスクごとに見直さない）
+    uint64_t eval_numa_switches;
+
+    ThreadStats *stats;
+    TreeStats *tree_stats;
+
+#if ENABLE_GLOBAL_CHECK_BENCHMARK
+    // Global comparison statistics (per-thread)
+    uint64_t global_check_count;          // should_switch_to_global呼び出し回数
+    uint64_t global_check_true_count;     // Globalの方が良かった回数
+    uint64_t cumulative_nodes;            // 累積ノード数（タスク間でリセットされない）
+    uint64_t nodes_at_last_check;         // 前回チェック時の累積ノード数
+    uint64_t check_interval_sum;          // チェック間隔（ノード数）の合計
+    uint64_t check_interval_min;          // チェック間隔の最小値
+    uint64_t check_interval_max;          // チェック間隔の最大値
+#endif
+
+    // TTヒット時のGlobal切り替え用
+    volatile bool should_abort_task;       // タスク中断フラグ
+    int current_task_priority;             // 現在処理中のタスクの優先度
+
+    // busy_workers追跡用
+    bool is_busy;                          // このワーカーがタスクを持っているか
+    uint64_t idle_ns;                      // タスクを得られず待っていた時間
+
+    // 作業盗み（--scheduler chaselev）: 盗みの試行・成功・CAS負けの数、相手選びの乱数、待機の長さ
+    uint64_t steal_attempts;
+    uint64_t steals;
+    uint64_t steal_aborts;
+    uint64_t steal_rng;
+    int idle_backoff_us;
+
+    // 階層キュー（--queues hier）: いるL3ドメイン、アフィニティが1ドメインに収まるか、
+    // 段ごとに取り出したチャンク数（0: L3、1: ソケット、2: 全体、3: 他のL3ドメイン）
+    int queue_l3;
+    bool queue_pinned;
+    uint64_t queue_pops[4];
+    uint64_t mq_lock_fails;                // --queues multiqueue: trylock に失敗した回数
+
+    // check_and_export最適化用
+    bool has_entered_chunk_mode;           // 一度でもchunk modeに入ったか
+    uint64_t nodes_at_last_export_check;   // 前回export checkした時のノード数
+};
+
+static void dfpn_solve_node(Worker *worker, DFPNNode *node);
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Hybrid Export/Import Operations
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+
+// チャンクキューの段の番号（queue_pops の添字。flat と multiqueue は QLEVEL_GLOBAL だけ）
+enum { QLEVEL_L3, QLEVEL_SOCKET, QLEVEL_GLOBAL, QLEVEL_REMOTE_L3 };
+
+// ワーカーが今いるL3ドメインを選ぶ（--queues hier）
+// 起動時にアフィニティから選び、アフィニティが複数ドメインにまたがるならタスクごとに今のCPUで選び直す
+static void queue_domain_select(Worker *worker, bool at_start) {
+    if (!worker->global->l3_queues) return;
+    if (at_start) {
+        int d = queue_topo_l3_of_affinity();
+        worker->queue_pinned = (d >= 0);
+        worker->queue_l3 = (d >= 0) ? d : queue_topo_l3_of(sched_getcpu());
+    } else if (!worker->queue_pinned) {
+        worker->queue_l3 = queue_topo_l3_of(sched_getcpu());
+    }
+}
+
+// チャンクを入れる最寄りのキュー（flat: GlobalChunkQueue、hier: 自分のL3ドメインのキュー）
+// アイドル時の条件変数待ちもこのキューで行う（multiqueue は GlobalChunkQueue の条件変数だけ使う）
+static inline GlobalChunkQueue *chunk_queue_home(Worker *worker) {
+    GlobalState *g = worker->global;
+    return g->l3_queues ? g->l3_queues[worker->queue_l3] : g->global_chunk_queue;
+}
+
+static inline GlobalChunkQueue *chunk_queue_socket(Worker *worker) {
+    GlobalState *g = worker->global;
+    return g->socket_queues[QUEUE_TOPO_L3_SOCKET[worker->queue_l3]];
+}
+
+// 手の届くキューで最も優先度の高いチャンクの優先度（空なら INT_MIN）
+// hier: 自分のL3ドメイン・ソケット・全体の3つ（他のL3ドメインは見ない）
+static inline int chunk_queue_top_priority(Worker *worker) {
+    GlobalState *g = worker->global;
+    if (g->mq) {
+        return chunk_mq_top_priority(g->mq, &worker->steal_rng);
+    }
+    int top = atomic_load(&g->global_chunk_queue->top_priority);
+    if (g->l3_queues) {
+        int l3_top = atomic_load(&chunk_queue_home(worker)->top_priority);
+        int socket_top = atomic_load(&chunk_queue_socket(worker)->top_priority);
+        if (l3_top > top) top = l3_top;
+        if (socket_top > top) top = socket_top;
+    }
+    return top;
+}
+
+// 手の届くキューがすべて空か（アイドル時の待機判定）
+static inline bool chunk_queues_empty(Worker *worker) {
+    GlobalState *g = worker->global;
+    if (g->mq) {
+        return atomic_load_explicit(&g->mq->size, memory_order_relaxed) == 0;
+    }
+    if (g->l3_queues) {
+        return chunk_queue_home(worker)->size == 0 && chunk_queue_socket(worker)->size == 0 &&
+               g->global_chunk_queue->size == 0;
+    }
+    return g->global_chunk_queue->size == 0;
+}
+
+// チャンクを入れる
+// hier: 自分のL3ドメインのキュー。QUEUE_HIER_L3_SPILL 個たまっていたらソケット、
+//       ソケットも QUEUE_HIER_SOCKET_SPILL 個たまっていたら全体のキューへあふれさせる
+static bool chunk_queue_push(Worker *worker, const Chunk *chunk) {
+    GlobalState *g = worker->global;
+    if (g->mq) {
+        if (!chunk_mq_push(g->mq, chunk, &worker->steal_rng, &worker->mq_lock_fails)) return false;
+        // 待機中のワーカーを起こす（待っている者がいなければ共有データに書き込まない）
+        pthread_cond_broadcast(&g->global_chunk_queue->cond);
+        return true;
+    }
+    if (!g->l3_queues) {
+        return global_chunk_queue_push(g->global_chunk_queue, chunk);
+    }
+
+    GlobalChunkQueue *l3 = chunk_queue_home(worker);
+    if (l3->size < QUEUE_HIER_L3_SPILL && global_chunk_queue_push(l3, chunk)) {
+        return true;
+    }
+    GlobalChunkQueue *socket = chunk_queue_socket(worker);
+    if (socket->size < QUEUE_HIER_SOCKET_SPILL && global_chunk_queue_push(socket, chunk)) {
+        return true;
+    }
+    return global_chunk_queue_push(g->global_chunk_queue, chunk);
+}
+
+// チャンクを取り出す
+// hier: 自分のL3ドメイン → ソケット → 全体の順に、空のときだけ上の段へ進む。
+//       すべて空なら他のL3ドメインのキュー（同じソケットを先に）から取る
+static bool chunk_queue_pop(Worker *worker, Chunk *out_chunk) {
+    GlobalState *g = worker->global;
+    if (g->mq) {
+        if (!chunk_mq_pop(g->mq, out_chunk, &worker->steal_rng, &worker->mq_lock_fails)) return false;
+        worker->queue_pops[QLEVEL_GLOBAL]++;
+        return true;
+    }
+    if (!g->l3_queues) {
+        if (!global_chunk_queue_pop(g->global_chunk_queue, out_chunk)) return false;
+        worker->queue_pops[QLEVEL_GLOBAL]++;
+        return true;
+    }
+
+    if (global_chunk_queue_pop(chunk_queue_home(worker), out_chunk)) {
+        worker->queue_pops[QLEVEL_L3]++;
+        return true;
+    }
+    if (global_chunk_queue_pop(chunk_queue_socket(worker), out_chunk)) {
+        worker->queue_pops[QLEVEL_SOCKET]++;
+        return true;
+    }
+    if (global_chunk_queue_pop(g->global_chunk_queue, out_chunk)) {
+        worker->queue_pops[QLEVEL_GLOBAL]++;
+        return true;
+    }
+
+    int my_socket = QUEUE_TOPO_L3_SOCKET[worker->queue_l3];
+    for (int pass = 0; pass < 2; pass++) {
+        for (int d = 0; d < g->n_l3_queues; d++) {
+            if (d == worker->queue_l3) continue;
+            if ((QUEUE_TOPO_L3_SOCKET[d] == my_socket) != (pass == 0)) continue;
+            if (g->l3_queues[d]->size == 0) continue;  // ロックを取る前に空を除く
+            if (global_chunk_queue_pop(g->l3_queues[d], out_chunk)) {
+                worker->queue_pops[QLEVEL_REMOTE_L3]++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 待機中のワーカーを起こす（全キューの条件変数）
+static void chunk_queues_broadcast(GlobalState *g) {
+    if (!g->global_chunk_queue) return;
+    pthread_cond_broadcast(&g->global_chunk_queue->cond);
+    for (int d = 0; g->l3_queues && d < g->n_l3_queues; d++) {
+        pthread_cond_broadcast(&g->l3_queues[d]->cond);
+    }
+}
+
+// --queues hier: L3ドメインごと・ソケットごとのキューを作る（全体のキューは global_chunk_queue）
+static void chunk_queues_hier_create(GlobalState *g) {
+    if (QUEUE_TOPO_N_L3 == 0) queue_read_topology();
+    g->n_l3_queues = QUEUE_TOPO_N_L3;
+    g->n_socket_queues = QUEUE_TOPO_N_SOCKETS;
+    g->l3_queues = calloc(g->n_l3_queues, sizeof(GlobalChunkQueue *));
+    g->socket_queues = calloc(g->n_socket_queues, sizeof(GlobalChunkQueue *));
+    for (int d = 0; d < g->n_l3_queues; d++) g->l3_queues[d] = global_chunk_queue_create();
+    for (int s = 0; s < g->n_socket_queues; s++) g->socket_queues[s] = global_chunk_queue_create();
+}
+
+static void chunk_queues_hier_destroy(GlobalState *g) {
+    if (!g->l3_queues) return;
+    for (int d = 0; d < g->n_l3_queues; d++) global_chunk_queue_destroy(g->l3_queues[d]);
+    for (int s = 0; s < g->n_socket_queues; s++) global_chunk_queue_destroy(g->socket_queues[s]);
+    free(g->l3_queues);
+    free(g->socket_queues);
+    g->l3_queues = NULL;
+    g->socket_queues = NULL;
+}
+
+// Export top CHUNK_SIZE tasks from LocalHeap to GlobalChunkQueue
+static void export_top_chunk(Worker *worker) {
+    LocalHeap *lh = &worker->local_heap;
+
+    if (lh->size < CHUNK_SIZE + 1) {
+        return;  // Not enough tasks to export (keep at least 1 for self)
+    }
+
+    Chunk chunk;
+    chunk.count = 0;
+
+    // Pop the best task first (will be pushed back)
+    Task best;
+    if (!local_heap_pop(lh, &best)) {
+        return;
+    }
+
+    // Pop CHUNK_SIZE tasks for the chunk
+    for (int i = 0; i < CHUNK_SIZE && lh->size > 0; i++) {
+        if (local_heap_pop(lh, &chunk.tasks[i])) {
+            chunk.count++;
+        }
+    }
+
+    // Push back the best task
+    local_heap_push(lh, &best);
+
+    // Push chunk to global queue
+    if (chunk.count > 0) {
+        chunk.top_priority = chunk.tasks[0].priority;
+        if (chunk_queue_push(worker, &chunk)) {
+            lh->exported_to_global += chunk.count;
+            __sync_fetch_and_add(&worker->global->total_exports, chunk.count);
+
+            #if VERBOSE_EXPORT_IMPORT
+            printf("[Worker %d] Exported %d tasks to Global (top_priority=%d)\n",
+                   worker->id, chunk.count, chunk.top_priority);
+            #endif
+        }
+    }
+}
+
+// Check and export tasks if conditions are met
+static void check_and_export(Worker *worker) {
+    LocalHeap *lh = &worker->local_heap;
+
+    // Condition 1: Local has enough tasks
+    if (lh->size < LOCAL_EXPORT_THRESHOLD) {
+        return;
+    }
+
+    int global_top = chunk_queue_top_priority(worker);
+    int local_top = lh->heap[0].priority;
+
+    // Continue exporting while conditions are met
+    while (lh->size >= CHUNK_SIZE + 1) {
+        bool global_empty = (global_top == INT_MIN);
+        bool local_is_better = (local_top >= global_top);
+
+        if (!global_empty && !local_is_better) {
+            break;  // Global has better tasks, stop exporting
+        }
+
+        export_top_chunk(worker);
+
+        // Update for next iteration
+        global_top = chunk_queue_top_priority(worker);
+        local_top = (lh->size > 0) ? lh->heap[0].priority : INT_MIN;
+    }
+}
+
+// Import chunk from GlobalChunkQueue to LocalHeap
+static bool import_chunk_from_global(Worker *worker, Task *out_task) {
+    LocalHeap *lh = &worker->local_heap;
+
+    Chunk chunk;
+    if (chunk_queue_pop(worker, &chunk)) {
+        // First task goes to caller
+        *out_task = chunk.tasks[0];
+
+        // Remaining tasks go to LocalHeap
+        for (int i = 1; i < chunk.count; i++) {
+            local_heap_push(lh, &chunk.tasks[i]);
+        }
+
+        lh->imported_from_global += chunk.count;
+        __sync_fetch_and_add(&worker->global->total_imports, chunk.count);
+
+        #if VERBOSE_EXPORT_IMPORT
+        printf("[Worker %d] Imported %d tasks from Global (top_priority=%d)\n",
+               worker->id, chunk.count, chunk.top_priority);
+        #endif
+
+        return true;
+    }
+    return false;
+}
+
+// Check if should switch to Global (called after tt_store)
+// TTヒット時に呼び出され、Globalの優先度と現在のタスク優先度を比較
+// Globalの方が良ければshould_abort_taskフラグを立てる
+static bool should_switch_to_global(Worker *worker) {
+    int global_top = chunk_queue_top_priority(worker);
+    int current_priority = worker->current_task_priority;
+
+    // Globalの優先度が現在のタスクより十分高ければ切り替え
+    bool result = (global_top > current_priority);
+
+    if (result) {
+        // 中断フラグを立てる（dfpn_solve_nodeで検知）
+        worker->should_abort_task = true;
+    }
+
+#if ENABLE_GLOBAL_CHECK_BENCHMARK
+    // 統計を記録
+    worker->global_check_count++;
+    if (result) {
+        worker->global_check_true_count++;
+    }
+
+    // チェック間隔（ノード数）を計算
+    // NOTE: worker->nodesはタスクごとにリセットされるため、累積カウンタを使用
+    uint64_t current_nodes = worker->cumulative_nodes;
+    if (worker->nodes_at_last_check > 0 && current_nodes > worker->nodes_at_last_check) {
+        uint64_t interval = current_nodes - worker->nodes_at_last_check;
+        worker->check_interval_sum += interval;
+
+        if (interval < worker->check_interval_min || worker->check_interval_min == 0) {
+            worker->check_interval_min = interval;
+        }
+        if (interval > worker->check_interval_max) {
+            worker->check_interval_max = interval;
+        }
+    }
+    worker->nodes_at_last_check = current_nodes;
+#endif
+
+    return result;
+}
+
+// 高速共有モードかどうかを判定（暇なワーカーがいるか）
+// ビットマップ方式: worker_has_idle() で高速判定
+static inline bool is_fast_sharing_mode(GlobalState *g) {
+    // 暇なワーカーがいれば高速共有モード
+    // ビットマップで効率的に判定（各ワーカーが自分のビットだけを更新するため競合が少ない）
+    if (worker_has_idle(&g->worker_state)) {
+        return true;
+    }
+
+    // 終盤フェーズ: アクティブワーカーが閾値以下なら高速共有モード
+    int active = atomic_load(&g->worker_state.active_workers);
+    return (active < g->worker_state.fast_sharing_threshold);
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Chase-Lev Work Stealing (--scheduler chaselev)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// タスクは作ったワーカーのdequeに積み、オーナーは新しい順（LIFO）に処理する。
+// 手の空いたワーカーは他のワーカーのdequeから古い順（FIFO）に盗む。
+// GlobalChunkQueue と LocalHeap は使わない（SharedTaskArrayはルートタスクの投入口）。
+
+// 自分で処理する予定のタスクを積む（hybrid: LocalHeap、chaselev: 自分のdeque）
+// chaselev では未証明で戻すルートタスクは SharedTaskArray へ（dequeに積むと、後から積んだ
+// サブタスクの下に埋もれてLIFOでは取り出されなくなる）
+static inline bool sched_push_local(Worker *worker, const Task *task) {
+    if (worker->global->deques) {
+        if (task->is_root_task && shared_array_push(worker->global->shared_array, task)) {
+            return true;
+        }
+        return chaselev_push(&worker->global->deques[worker->id], task);
+    }
+    return local_heap_push(&worker->local_heap, task);
+}
+
+// 他のワーカーに回すタスクを積む（hybrid: SharedTaskArray、chaselev: 自分のdeque = 盗まれる側）
+static inline bool sched_push_shared(Worker *worker, const Task *task) {
+    if (worker->global->deques) {
+        return chaselev_push(&worker->global->deques[worker->id], task);
+    }
+    return shared_array_push(worker->global->shared_array, task);
+}
+
+// 処理を終えずに戻すタスク（未証明のルートタスク、中断したタスク）を積む。
+// 手元（LocalHeap / deque）が満杯なら SharedTaskArray、それも満杯なら（hybrid のみ）
+// 1タスクのチャンクとしてチャンクキューへ（落とすとそのルートムーブが証明されずに残る）
+static bool sched_requeue(Worker *worker, const Task *task) {
+    if (sched_push_local(worker, task)) {
+        return true;
+    }
+    if (shared_array_push(worker->global->shared_array, task)) {
+        return true;
+    }
+    if (worker->global->deques) {
+        return false;
+    }
+    Chunk chunk = { .count = 1, .top_priority = task->priority };
+    chunk.tasks[0] = *task;
+    return chunk_queue_push(worker, &chunk);
+}
+
+// 手元に残っているタスク数（スポーン量の調整に使う）
+static inline int sched_local_size(Worker *worker) {
+    if (worker->global->deques) {
+        return chaselev_size(&worker->global->deques[worker->id]);
+    }
+    return worker->local_heap.size;
+}
+
+// 盗む相手（自分以外）を乱数で選ぶ（xorshift64）
+static inline int steal_random_victim(Worker *worker, int n) {
+    uint64_t x = worker->steal_rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    worker->steal_rng = x;
+    int v = (int)(x % (uint64_t)(n - 1));
+    return (v >= worker->id) ? v + 1 : v;
+}
+
+// Chase-Lev task acquisition
+// SharedTaskArray → 自分のdeque → 他のワーカーから盗む。
+// SharedTaskArrayにはルートタスクだけが入る（hybridのFIFOと同じく、ルートタスクを
+// 自分が積んだサブタスクより先に始める。サブタスクは処理中にさらにサブタスクを積むので、
+// dequeのLIFOの下にルートタスクを置くといつまでも取り出されない）。
+// 相手は乱数で2つ選び、次に盗まれるタスクの優先度が高い方から始めて全ワーカーを1周する
+// （優先度は盗む順の目安で、厳密な最良優先ではない）
+static bool get_next_task_chaselev(Worker *worker, Task *out_task) {
+    GlobalState *g = worker->global;
+
+    if (shared_array_pop(g->shared_array, out_task)) {
+        return true;
+    }
+
+    if (chaselev_pop(&g->deques[worker->id], out_task)) {
+        return true;
+    }
+
+    int n = g->n_workers;
+    if (n < 2) {
+        return false;
+    }
+
+    int a = steal_random_victim(worker, n);
+    int b = steal_random_victim(worker, n);
+    int start = (chaselev_top_priority(&g->deques[b]) > chaselev_top_priority(&g->deques[a])) ? b : a;
+
+    for (int k = 0; k < n; k++) {
+        int v = (start + k) % n;
+        if (v == worker->id) continue;
+
+        StealResult r = chaselev_steal(&g->deques[v], out_task);
+        if (r == STEAL_EMPTY) continue;
+
+        worker->steal_attempts++;
+        if (r == STEAL_OK) {
+            worker->steals++;
+            if (DEBUG_CONFIG.track_work_stealing) {
+                debug_log("Worker %d stole task from Worker %d (priority=%d, depth=%d)\n",
+                          worker->id, v, out_task->priority, out_task->depth);
+            }
+            return true;
+        }
+        worker->steal_aborts++;
+    }
+
+    return false;
+}
+
+// Hybrid task acquisition
+static bool get_next_task_hybrid(Worker *worker, Task *out_task) {
+    GlobalState *g = worker->global;
+    LocalHeap *lh = &worker->local_heap;
+
+    // --scheduler chaselev: LocalHeap / GlobalChunkQueue の代わりにワーカーごとのdeque
+    if (g->deques) {
+        return get_next_task_chaselev(worker, out_task);
+    }
+
+    bool fast_sharing = is_fast_sharing_mode(g);
+
+    // ========================================
+    // 高速共有モード（起動フェーズ / 終盤フェーズ）
+    // - SharedTaskArrayを優先（ソート不要、CASのみ）
+    // - チャンクは使わない（オーバーヘッド回避）
+    // ========================================
+    if (fast_sharing) {
+        // 1. まずLocalHeapから取得（自分のタスクがあれば処理）
+        if (lh->size > 0) {
+            local_heap_pop(lh, out_task);
+            return true;
+        }
+
+        // 2. SharedTaskArrayから取得（他ワーカーが投入したタスク）
+        if (shared_array_pop(g->shared_array, out_task)) {
+            if (DEBUG_CONFIG.track_work_stealing) {
+                debug_log("Worker %d got task from SharedArray (fast_sharing, priority=%d, busy=%d/%d)\n",
+                       worker->id, out_task->priority,
+                       worker_count_busy(&g->worker_state),
+                       g->worker_state.total_workers);
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    // ========================================
+    // 通常モード（全ワーカー稼働中）
+    // - LocalHeap + GlobalChunkQueue のハイブリッド
+    // - 優先度に基づく選択
+    // ========================================
+
+    int global_top = chunk_queue_top_priority(worker);
+    int local_top = (lh->size > 0) ? lh->heap[0].priority : INT_MIN;
+
+    // Check 1: Global has better task?
+    if (global_top > local_top) {
+        if (import_chunk_from_global(worker, out_task)) {
+            return true;
+        }
+    }
+
+    // Check 2: Get from Local
+    if (lh->size > 0) {
+        local_heap_pop(lh, out_task);
+        return true;
+    }
+
+    // Check 3: Get from Global (Local is empty)
+    if (import_chunk_from_global(worker, out_task)) {
+        return true;
+    }
+
+    // Fallback: SharedTaskArray (終盤に残ったタスク)
+    if (shared_array_pop(g->shared_array, out_task)) {
+        return true;
+    }
+
+    return false;  // No task available
+}
 
-    uint64_t hash = 0;
-    for (int i = 0; i < 64; i++) {
-        if (unique_P & (1ULL << i)) hash ^= zobrist_table[0][i];
-        if (unique_O & (1ULL << i)) hash ^= zobrist_table[1][i];
+// Share remaining tasks to SharedTaskArray (for endgame)
+static void share_remaining_tasks(Worker *worker) {
+    GlobalState *g = worker->global;
+    LocalHeap *lh = &worker->local_heap;
+
+    // Keep one for self, share the rest
+    while (lh->size > 1) {
+        Task task;
+        if (!local_heap_pop(lh, &task)) {
+            break;
+        }
+        if (!shared_array_push(g->shared_array, &task)) {
+            // SharedArray is full, put it back
+            local_heap_push(lh, &task);
+            break;
+        }
     }
-    return hash;
 }
 
-static TranspositionTable* tt_create(size_t size_mb) {
-    TranspositionTable *tt = calloc(1, sizeof(TranspositionTable));
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Deep proof number selection (--dpn-r)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// Deep_Pns_benchmark.c の DPN() / set_deep() と同じ定義:
+//   dpn = (1 - 1/pn) * R + deep * (1 - R)    （ANDノードの子は pn の代わりに dn）
+//   deep = 1 / (60 - 空きマス数)              （深い葉ほど小さい）
+// dpn が最小の子を選び、その子の deep を親に伝播する（部分木の最良葉の深さ）。
+// R = 1 で従来の最小pn/dn選択、R → 0 で深さ優先に近づく。
+//
+// limit より小さい値（ORはpn、ANDはdn）の子だけを候補にする。しきい値を使う
+// エンジンでは、しきい値以上の子を選ぶと即座に戻って同じ子を選び続けるため。
+// 同じ理由で pn/dn のどちらかが INF の子も選ばない（木エンジンのループ条件で即座に戻る）。
 
-    size_t entry_size = sizeof(TTEntry);
-    size_t n_entries = (size_mb << 20) / entry_size;
+static inline float dpn_leaf_deep(int empties) {
+    int ply = 60 - empties;
+    return 1.0f / (float)(ply > 0 ? ply : 1);
+}
 
-    size_t size = 1;
-    while (size < n_entries) size <<= 1;
-    size >>= 1;
+static int select_dpn_child(DFPNNode *node, double r, uint32_t limit, uint32_t *second) {
+    int best = -1;
+    float best_dpn = 0.0f;
+    uint32_t second_value = UINT32_MAX;
 
-    tt->size = size;
-    tt->mask = size - 1;
-    tt->entries = calloc(size, sizeof(TTEntry));
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        if (child->is_proven || child->pn == 0 || child->dn == 0) continue;
+        uint32_t value = (node->type == NODE_OR) ? child->pn : child->dn;
+        float temp = (value >= PN_INF) ? 0.001f : 1.0f / (float)value;
+        float dpn = (1.0f - temp) * (float)r + child->deep * (float)(1.0 - r);
+
+        bool better;
+        if (value >= limit || child->pn >= PN_INF || child->dn >= DN_INF) {
+            better = false;
+        } else if (best < 0 || dpn < best_dpn) {
+            better = true;
+        } else if (dpn == best_dpn) {
+            int16_t best_eval = node->children[best]->eval_score;
+            better = (node->type == NODE_OR) ? child->eval_score > best_eval
+                                             : child->eval_score < best_eval;
+        } else {
+            better = false;
+        }
 
-    // Initialize fixed stripe locks (much fewer than entries)
-    for (int i = 0; i < TT_LOCK_STRIPES; i++) {
-        pthread_rwlock_init(&tt->locks[i].lock, NULL);
+        if (better) {
+            if (best >= 0) {
+                DFPNNode *prev = node->children[best];
+                uint32_t prev_value = (node->type == NODE_OR) ? prev->pn : prev->dn;
+                if (prev_value < second_value) second_value = prev_value;
+            }
+            best = i;
+            best_dpn = dpn;
+        } else if (value < second_value) {
+            second_value = value;
+        }
     }
 
-    debug_log("TT created: %zu MB (%zu entries)\n", size_mb, size);
+    if (best >= 0) node->deep = node->children[best]->deep;
+    *second = (second_value > PN_INF) ? PN_INF : second_value;
+    return best;
+}
 
-    return tt;
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Move ordering: per-worker history / killer tables (--ordering)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 子の並び順（展開時の children の順、従来しきい値での子選択の同点処理）は評価値だけで
+// 決めていたが、終盤では評価関数は高価で外れやすい。--ordering history / eval+history では、
+// ワーカーごとの履歴表とキラー手から優先度を足す:
+//   - 子が親を証明したら（ORで pn = 0 の子、ANDで dn = 0 の子）、その手を手番側の良い手として
+//     history[空きマス数 / 4][マス] に 空きマス数^2 を加え、空きマス数ごとのキラー手に入れる
+//   - 優先度 = HISTORY_SCALE × 履歴 / 区分内の最大履歴 + キラー手なら KILLER_BONUS（2番目は半分）
+// 表はワーカーごとなのでロックは不要。ttエンジンは着手生成順のまま。
+
+// 親から子への着手（パスなら -1）
+static inline int child_move(const DFPNNode *node, const DFPNNode *child) {
+    uint64_t placed = ~(node->player | node->opponent) & (child->player | child->opponent);
+    return placed ? first_one(placed) : -1;
 }
 
-static void tt_free(TranspositionTable *tt) {
-    for (int i = 0; i < TT_LOCK_STRIPES; i++) {
-        pthread_rwlock_destroy(&tt->locks[i].lock);
+static inline int history_bucket(int empties) {
+    int b = empties >> 2;
+    return (b < HISTORY_BUCKETS) ? b : HISTORY_BUCKETS - 1;
+}
+
+static inline int history_bonus(const Worker *worker, int empties, int move) {
+    if (move < 0) return 0;
+    int b = history_bucket(empties);
+    int bonus = 0;
+    if (worker->history_max[b] > 0) {
+        bonus = (int)((uint64_t)worker->history[b][move] * HISTORY_SCALE / worker->history_max[b]);
     }
-    free(tt->entries);
-    free(tt);
+    if (worker->killer[empties][0] == move) {
+        bonus += KILLER_BONUS;
+    } else if (worker->killer[empties][1] == move) {
+        bonus += KILLER_BONUS / 2;
+    }
+    return bonus;
 }
 
-static bool tt_probe(TranspositionTable *tt, uint64_t key, int depth,
-                    uint32_t *pn, uint32_t *dn, Result *result, int16_t *eval_score) {
-    size_t index = key & tt->mask;
-    // Use higher bits of key for stripe selection (better distribution)
-    int lock_index = (key >> 20) & (TT_LOCK_STRIPES - 1);
+// 証明済みになったノードについて、証明を決めた子の手を記録する
+static void history_record_cutoff(Worker *worker, DFPNNode *node) {
+    int idx = -1;
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        if ((node->type == NODE_OR && node->pn == 0 && child->pn == 0) ||
+            (node->type == NODE_AND && node->dn == 0 && child->dn == 0)) {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0) return;  // 全ての子が逆側に証明された（決め手の手はない）
 
-    pthread_rwlock_rdlock(&tt->locks[lock_index].lock);
-    TTEntry *entry = &tt->entries[index];
+    worker->ordering_cutoffs++;
+    if (idx == 0) worker->ordering_first_cutoffs++;
+    if (!ordering_uses_history()) return;
 
-    bool hit = (entry->key == key && entry->depth >= depth);
-    if (hit) {
-        *pn = entry->pn;
-        *dn = entry->dn;
-        *result = entry->result;
-        if (eval_score) *eval_score = entry->eval_score;
-        __sync_fetch_and_add(&tt->hits, 1);
-    } else if (entry->key != 0 && entry->key != key) {
-        __sync_fetch_and_add(&tt->collisions, 1);
+    int move = child_move(node, node->children[idx]);
+    if (move < 0) return;
+
+    int empties = node->depth;
+    int b = history_bucket(empties);
+    uint32_t h = worker->history[b][move] + (uint32_t)(empties * empties + 1);
+    if (h >= (1u << 30)) {
+        // 飽和する前に区分全体を半減（古い情報を薄める）
+        for (int sq = 0; sq < 64; sq++) worker->history[b][sq] >>= 1;
+        worker->history_max[b] >>= 1;
+        h >>= 1;
     }
+    worker->history[b][move] = h;
+    if (h > worker->history_max[b]) worker->history_max[b] = h;
 
-    pthread_rwlock_unlock(&tt->locks[lock_index].lock);
-    return hit;
+    if (worker->killer[empties][0] != move) {
+        worker->killer[empties][1] = worker->killer[empties][0];
+        worker->killer[empties][0] = (int8_t)move;
+    }
+    worker->history_updates++;
 }
 
-static void tt_store(TranspositionTable *tt, uint64_t key, int depth,
-                    uint32_t pn, uint32_t dn, Result result, int16_t eval_score) {
-    size_t index = key & tt->mask;
-    // Use higher bits of key for stripe selection (same as tt_probe)
-    int lock_index = (key >> 20) & (TT_LOCK_STRIPES - 1);
+// 終盤用の順序付け（--endgame-order）
+//
+// 評価関数の重みは中盤の局面で学習したもので、終盤では当てにならない（eval.dat がなければ
+// 全ての子が 0 になり着手生成順になる）。空きマス数が ENDGAME_ORDER_EMPTIES 以下のノードでは、
+// 評価値の代わりに次の値で子を並べる（大きいほど先、単位は評価値と同じく石差程度）:
+//   - fastest-first: 着手後の相手の合法手数 × ENDGAME_MOBILITY_WEIGHT を引く（隅は2つ分）
+//   - 偶数理論: 着手前に空きマスが奇数の象限へ打つ手に ENDGAME_PARITY_BONUS を足す
+//   - マスの種類: 隅 > 辺 > 内側 > C > X の静的な重み
+// 評価関数は呼ばないので、この範囲の子の eval_score は 0（--pn-init eval も効かない）。
+// --ordering eval / eval+history の評価値の部分だけを置き換え、履歴・キラー手はそのまま足す。
+
+static const int8_t ENDGAME_SQUARE_CLASS[64] = {
+     6, -3,  1,  1,  1,  1, -3,  6,
+    -3, -6,  0,  0,  0,  0, -6, -3,
+     1,  0,  0,  0,  0,  0,  0,  1,
+     1,  0,  0,  0,  0,  0,  0,  1,
+     1,  0,  0,  0,  0,  0,  0,  1,
+     1,  0,  0,  0,  0,  0,  0,  1,
+    -3, -6,  0,  0,  0,  0, -6, -3,
+     6, -3,  1,  1,  1,  1, -3,  6
+};
 
-    pthread_rwlock_wrlock(&tt->locks[lock_index].lock);
-    TTEntry *entry = &tt->entries[index];
+static const uint64_t ENDGAME_QUADRANT[4] = {
+    0x000000000F0F0F0FULL, 0x00000000F0F0F0F0ULL,
+    0x0F0F0F0F00000000ULL, 0xF0F0F0F000000000ULL
+};
 
-    if (entry->depth <= depth) {
-        entry->key = key;
-        entry->pn = pn;
-        entry->dn = dn;
-        entry->result = result;
-        entry->depth = depth;
-        entry->eval_score = eval_score;
-        entry->age = 0;
-        __sync_fetch_and_add(&tt->stores, 1);
-    }
+static inline bool endgame_order_at(int empties) {
+    return ordering_uses_eval() && empties <= ENDGAME_ORDER_EMPTIES;
+}
 
-    pthread_rwlock_unlock(&tt->locks[lock_index].lock);
+// empty: 着手前の空きマス、p/o: 着手後の盤面（p が相手の手番側）
+static inline int endgame_order_score(uint64_t empty, int move, uint64_t p, uint64_t o) {
+    uint64_t reply = get_moves(p, o);
+    int mobility = popcount(reply) + popcount(reply & 0x8100000000000081ULL);
+    int score = ENDGAME_SQUARE_CLASS[move] - ENDGAME_MOBILITY_WEIGHT * mobility;
+    int q = ((move >> 5) & 1) * 2 + ((move >> 2) & 1);
+    if (popcount(empty & ENDGAME_QUADRANT[q]) & 1) score += ENDGAME_PARITY_BONUS;
+    return score;
 }
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// df-pn+ Node
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// 子選択の優先度に足す値（--ordering に従い評価値と履歴を使う）
+static inline int child_order_bonus(const Worker *worker, const DFPNNode *node, const DFPNNode *child,
+                                    const NodeType type) {
+    int bonus = 0;
+    if (ordering_uses_eval()) {
+        bonus += (type == NODE_OR) ? child->eval_score : -child->eval_score;
+    }
+    if (ordering_uses_history()) {
+        bonus += history_bonus(worker, node->depth, child_move(node, child));
+    }
+    return bonus;
+}
 
-typedef struct DFPNNode {
-    uint64_t player;
-    uint64_t opponent;
+// type: node->type（呼び出し側の OR/AND 特殊化から定数で渡す）
+static ALWAYS_INLINE int select_best_child_with_priority(Worker *worker, DFPNNode *node, const NodeType type) {
+    if (!node->children || node->n_children == 0) return -1;
 
-    uint32_t pn;
-    uint32_t dn;
-    uint32_t threshold_pn;
-    uint32_t threshold_dn;
+    if (worker->global->dpn_r >= 0) {
+        uint32_t second;
+        return select_dpn_child(node, worker->global->dpn_r, UINT32_MAX, &second);
+    }
 
-    Result result;
-    NodeType type;
-    int16_t eval_score;
-    bool is_proven;  // 完全に証明されたかどうか（終端ノードから正しく伝播）
+    // [最適化] 優先度キューを線形探索に置き換え
+    // 理由: 1つの要素のみ取り出すため、O(n)の線形探索で十分
+    //       malloc/freeのオーバーヘッドも削減
+    int best_idx = -1;
+    int best_priority = INT_MIN;
 
-    struct DFPNNode **children;
-    int n_children;
-    int depth;
+    if (type == NODE_OR) {
+        for (int i = 0; i < node->n_children; i++) {
+            int priority = (PN_INF - node->children[i]->pn) + child_order_bonus(worker, node, node->children[i], type);
+            if (priority > best_priority) {
+                best_priority = priority;
+                best_idx = i;
+            }
+        }
+    } else {
+        for (int i = 0; i < node->n_children; i++) {
+            int priority = (DN_INF - node->children[i]->dn) + child_order_bonus(worker, node, node->children[i], type);
+            if (priority > best_priority) {
+                best_priority = priority;
+                best_idx = i;
+            }
+        }
+    }
 
-    uint64_t visits;
-} DFPNNode;
+    return best_idx;
+}
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// MoveWithEval: 手と評価値を保存（expand_node最適化用）
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// 和を取る側（ORのdn / ANDのpn）の集約
+//
+// WPN（wpns_tt_parallel.c の update_proof_disproof と同じ規則）は、合流（DAG）で
+// 同じ部分木が複数の子から二重に数えられる和の過大評価を抑える。
+// sum は飽和済み（<= INF）の総和、max は子の最大値、unsolved は未解決の子の数。
+static inline bool aggregate_uses_sum(const GlobalState *g, int empties) {
+    return g->aggregation == AGG_CLASSIC ||
+           (g->aggregation == AGG_HYBRID && empties < g->agg_hybrid_min_empties);
+}
 
-typedef struct {
-    int move;
-    int eval_score;
-    uint64_t player;
-    uint64_t opponent;
-} MoveWithEval;
+static inline uint32_t aggregate_sum_side(const GlobalState *g, uint64_t sum, uint32_t max,
+                                          int unsolved, int empties) {
+    if (aggregate_uses_sum(g, empties)) {
+        return (uint32_t)sum;
+    }
+    if (max >= PN_INF) return PN_INF;
+    uint64_t wpn = (uint64_t)max + (unsolved > 1 ? unsolved - 1 : 0);
+    return (wpn >= PN_INF) ? PN_INF : (uint32_t)wpn;
+}
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// Memory Pool for DFPNNode (Arena Allocator)
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// 合流（トランスポジション）を考慮した和（--dag）
+//
+// Kishimoto–Müller の source node detection と同じ考え方: TTエントリに「最初にその局面を
+// 子として作った親」のタグ（ソースマーカー）を残し、子のソースが自分でなければ
+// その子は別の親（合流元）の部分木と共有されているとみなす。共有された子の pn/dn は
+// 合流元の和ですでに数えられているので、ここでは足さずに最大値だけを使う:
+//   和 = max(自分がソースの子（とソース不明の子）の和, 共有された子の最大値)
+// 0 になるのは全員 0 のときだけ、INF を含めば INF なので、
+// 証明（和 = 0）と反証（和 = INF）の判定は変わらない。WPN は和を使わないので補正しない。
+static inline uint32_t dag_tag(uint64_t key) {
+    return DAG_PNDN ? ((uint32_t)(key >> 32) | 1) : 0;
+}
 
-#define NODE_POOL_BLOCK_SIZE 8192
+static inline void dag_mark_children(DFPNNode *node, uint32_t tag) {
+    for (int i = 0; i < node->n_children; i++) {
+        node->children[i]->source = tag;
+    }
+}
 
-typedef struct NodePoolBlock {
-    DFPNNode *nodes;
-    struct NodePoolBlock *next;
-} NodePoolBlock;
+// TTのソースマーカーをノードに反映する
+// 展開した親と異なるソースを持つ局面は、別の親の部分木との合流として数える
+static inline void dag_note_source(Worker *worker, DFPNNode *node, uint32_t source) {
+    if (source == 0 || source == node->source) return;
+    if (node->source != 0) worker->dag_transpositions++;
+    node->source = source;
+}
 
-typedef struct {
-    NodePoolBlock *first_block;
-    NodePoolBlock *current_block;
-    int current_index;
-    int block_size;
-    uint64_t total_allocated;
-} NodePool;
+static uint64_t dag_sum_side(const DFPNNode *node, uint32_t tag, bool use_dn) {
+    uint64_t owned = 0;
+    uint32_t shared = 0;
+    for (int i = 0; i < node->n_children; i++) {
+        const DFPNNode *child = node->children[i];
+        uint32_t v = use_dn ? child->dn : child->pn;
 
-static void node_pool_init(NodePool *pool) {
-    pool->block_size = NODE_POOL_BLOCK_SIZE;
-    pool->first_block = malloc(sizeof(NodePoolBlock));
-    pool->first_block->nodes = calloc(pool->block_size, sizeof(DFPNNode));
-    pool->first_block->next = NULL;
-    pool->current_block = pool->first_block;
-    pool->current_index = 0;
-    pool->total_allocated = 0;
+        if (child->source != 0 && child->source != tag) {
+            if (v > shared) shared = v;
+        } else {
+            owned += v;
+            if (owned >= PN_INF) return PN_INF;
+        }
+    }
+    return (owned > shared) ? owned : shared;
 }
 
-static DFPNNode* node_pool_alloc(NodePool *pool) {
-    if (pool->current_index >= pool->block_size) {
-        // Need new block
-        if (pool->current_block->next == NULL) {
-            // Allocate new block
-            NodePoolBlock *new_block = malloc(sizeof(NodePoolBlock));
-            new_block->nodes = calloc(pool->block_size, sizeof(DFPNNode));
-            new_block->next = NULL;
-            pool->current_block->next = new_block;
+// tag: このノードのソースマーカー（dag_tag、0 なら合流の補正なし）
+// type: node->type（OR/AND で特殊化した版から定数で渡す）
+// 戻り値: 合流の補正で和が小さくなったか（--dag の統計用）
+static ALWAYS_INLINE bool update_pn_dn_typed(Worker *worker, DFPNNode *node, uint32_t tag,
+                                              const NodeType type) {
+    if (node->children == NULL || node->n_children == 0) {
+        return false;
+    }
+    bool corrected = false;
+
+    // 証明目標に対する二値の問いなので、証明済みは pn = 0（WIN）か dn = 0（LOSE）のみ。
+    // 引き分けは target = 0 / 1 の2つの問いの結果として呼び出し側で判定する。
+
+    if (type == NODE_OR) {
+        // ORノード: pn = min(子のpn), dn = sum(子のdn)
+        uint32_t min_pn = PN_INF;
+        uint64_t sum_dn = 0;
+        uint32_t max_dn = 0;
+        int unsolved = 0;
+
+        for (int i = 0; i < node->n_children; i++) {
+            DFPNNode *child = node->children[i];
+
+            if (child->pn < min_pn) {
+                min_pn = child->pn;
+            }
+            sum_dn += child->dn;
+            if (sum_dn >= DN_INF) sum_dn = DN_INF;
+            if (child->dn > max_dn) max_dn = child->dn;
+            if (child->pn != 0 && child->dn != 0) unsolved++;
+        }
+        if (tag != 0 && aggregate_uses_sum(worker->global, node->depth)) {
+            uint64_t dag_dn = dag_sum_side(node, tag, true);
+            if (dag_dn < sum_dn) {
+                sum_dn = dag_dn;
+                corrected = true;
+            }
+        }
+
+        node->pn = min_pn;
+        node->dn = aggregate_sum_side(worker->global, sum_dn, max_dn, unsolved, node->depth);
+
+        // 結果の判定
+        if (node->pn == 0) {
+            node->result = RESULT_EXACT_WIN;
+            node->is_proven = true;
+        } else if (node->dn == 0) {
+            node->result = RESULT_EXACT_LOSE;
+            node->is_proven = true;
+        }
+
+    } else {
+        // ANDノード: pn = sum(子のpn), dn = min(子のdn)
+        uint64_t sum_pn = 0;
+        uint32_t min_dn = DN_INF;
+        uint32_t max_pn = 0;
+        int unsolved = 0;
+
+        for (int i = 0; i < node->n_children; i++) {
+            DFPNNode *child = node->children[i];
+
+            sum_pn += child->pn;
+            if (sum_pn >= PN_INF) sum_pn = PN_INF;
+            if (child->pn > max_pn) max_pn = child->pn;
+            if (child->pn != 0 && child->dn != 0) unsolved++;
+            if (child->dn < min_dn) {
+                min_dn = child->dn;
+            }
+        }
+        if (tag != 0 && aggregate_uses_sum(worker->global, node->depth)) {
+            uint64_t dag_pn = dag_sum_side(node, tag, false);
+            if (dag_pn < sum_pn) {
+                sum_pn = dag_pn;
+                corrected = true;
+            }
+        }
+
+        node->pn = aggregate_sum_side(worker->global, sum_pn, max_pn, unsolved, node->depth);
+        node->dn = min_dn;
+
+        // 結果の判定
+        if (node->dn == 0) {
+            node->result = RESULT_EXACT_LOSE;
+            node->is_proven = true;
+        } else if (node->pn == 0) {
+            node->result = RESULT_EXACT_WIN;
+            node->is_proven = true;
         }
-        pool->current_block = pool->current_block->next;
-        pool->current_index = 0;
-        // Reset nodes in reused block
-        memset(pool->current_block->nodes, 0, pool->block_size * sizeof(DFPNNode));
     }
-    DFPNNode *node = &pool->current_block->nodes[pool->current_index];
-    pool->current_index++;
-    pool->total_allocated++;
-    // Note: is_proven is initialized to false via calloc/memset
-    return node;
+    return corrected;
 }
 
-static void node_pool_reset(NodePool *pool) {
-    // Reset to beginning - blocks are retained for reuse
-    pool->current_block = pool->first_block;
-    pool->current_index = 0;
-    // Reset first block (others reset on demand in node_pool_alloc)
-    memset(pool->first_block->nodes, 0, pool->block_size * sizeof(DFPNNode));
+static bool update_pn_dn_or(Worker *worker, DFPNNode *node, uint32_t tag) {
+    return update_pn_dn_typed(worker, node, tag, NODE_OR);
 }
 
-static void node_pool_destroy(NodePool *pool) {
-    NodePoolBlock *block = pool->first_block;
-    while (block) {
-        NodePoolBlock *next = block->next;
-        free(block->nodes);
-        free(block);
-        block = next;
-    }
-    pool->first_block = NULL;
-    pool->current_block = NULL;
+static bool update_pn_dn_and(Worker *worker, DFPNNode *node, uint32_t tag) {
+    return update_pn_dn_typed(worker, node, tag, NODE_AND);
+}
+
+static bool update_pn_dn(Worker *worker, DFPNNode *node, uint32_t tag) {
+    return (node->type == NODE_OR) ? update_pn_dn_or(worker, node, tag) : update_pn_dn_and(worker, node, tag);
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// Worker with Work Stealing
+// Heuristic pn/dn initialization (--pn-init)
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// df-pn+ 方式: 新しく作った葉の pn/dn を 1 ではなくヒューリスティックで初期化する。
+// 和を取る側（ANDノードのpn / ORノードのdn）は、その局面の手番側の合法手数で見積もる:
+//   - ANDの子（ORノードの子、相手の手番）: pn = 相手の合法手数, dn = 1
+//   - ORの子（ANDノードの子、自分の手番）: pn = 1, dn = 自分の合法手数
+// 評価値はルートムーブ側視点に直し、有利なら dn、不利なら pn を
+// PNDN_EVAL_SCALE 石ごとに 1 増やす。いずれも PNDN_INIT_MAX で頭打ち。
+//
+// 子の eval_score は親の手番側から見た値なので、親がANDノードなら符号を反転する。
+// 初期化方式は PNDN_INITIALIZERS に関数を追加すれば --pn-init で選べる。
 
-// Global state for hybrid work distribution
-typedef struct Worker Worker;  // Forward declaration
-
-typedef struct {
-    TranspositionTable *tt;
-
-    // Hybrid: GlobalChunkQueue + SharedTaskArray
-    GlobalChunkQueue *global_chunk_queue;
-    SharedTaskArray *shared_array;
-    WorkerState worker_state;
+typedef void (*PnDnInitFn)(const DFPNNode *parent, DFPNNode *child);
 
-    // Worker references (for statistics)
-    Worker **workers;
-    int n_workers;
+typedef struct PnDnInitializer {
+    const char *name;
+    PnDnInitFn init;
+    bool uses_eval;     // 子の eval_score を使う（--eval-lazy は子の作成時に評価が要るので効かない）
+} PnDnInitializer;
 
-    // Results per root move
-    Result *move_results;
-    uint64_t *move_nodes;
-    int *move_list;
-    int *move_evals;
-    int n_moves;
+static inline uint32_t pndn_clamp(uint32_t v) {
+    if (v < 1) return 1;
+    return (v > PNDN_INIT_MAX) ? PNDN_INIT_MAX : v;
+}
 
-#if ENABLE_EVAL_IMPACT
-    // Evaluation impact tracking (-e option)
-    // 評価関数影響分析用のデータ（ENABLE_EVAL_IMPACT=1 時のみ有効）
-    EvalImpact *eval_impacts;
-    struct timespec *move_start_times;  // 各手の探索開始時刻
-#endif
+// 和を取る側の見積もり（手番側の合法手数、パスなら1）
+static inline uint32_t pndn_mobility(const DFPNNode *child) {
+    return (uint32_t)popcount(get_moves(child->player, child->opponent));
+}
 
-    // Shared state
-    volatile bool found_win;
-    volatile int winning_move;
-    volatile bool shutdown;
-    volatile int tasks_completed;  // Track completed root tasks
+// ルートムーブ側から見た子の評価値
+static inline int pndn_root_eval(const DFPNNode *parent, const DFPNNode *child) {
+    return (parent->type == NODE_OR) ? child->eval_score : -child->eval_score;
+}
 
-    double time_limit;
-    struct timespec start_time;
-    bool use_evaluation;
+static void pndn_init_unit(const DFPNNode *parent, DFPNNode *child) {
+    (void)parent;
+    child->pn = 1;
+    child->dn = 1;
+}
 
-    // Dynamic task spawning settings (adjustable for different hardware)
-    int max_generation;         // Max depth of task spawning (default: 3, 40-core: 5)
-    int min_depth_for_spawn;    // Don't spawn subtasks below this depth (default: 6, 40-core: 4)
-    int spawn_threshold;        // Only spawn children with priority above this
-    int spawn_limit;            // Max children to spawn per node (default: 3, 40-core: 6)
+static void pndn_init_mobility(const DFPNNode *parent, DFPNNode *child) {
+    (void)parent;
+    uint32_t mobility = pndn_clamp(pndn_mobility(child));
+    child->pn = (child->type == NODE_AND) ? mobility : 1;
+    child->dn = (child->type == NODE_OR) ? mobility : 1;
+}
 
-    // Subtask statistics
-    volatile uint64_t subtasks_spawned;
-    volatile uint64_t subtasks_completed;
+static void pndn_init_eval(const DFPNNode *parent, DFPNNode *child) {
+    int v = pndn_root_eval(parent, child);
+    child->pn = pndn_clamp(1 + (v < 0 ? -v : 0) / PNDN_EVAL_SCALE);
+    child->dn = pndn_clamp(1 + (v > 0 ? v : 0) / PNDN_EVAL_SCALE);
+}
 
-    // Hybrid statistics
-    volatile uint64_t total_exports;
-    volatile uint64_t total_imports;
-    volatile uint64_t global_switches;  // tt_store時のGlobal切り替え回数
+static void pndn_init_mobility_eval(const DFPNNode *parent, DFPNNode *child) {
+    int v = pndn_root_eval(parent, child);
+    pndn_init_mobility(parent, child);
+    child->pn = pndn_clamp(child->pn + (v < 0 ? -v : 0) / PNDN_EVAL_SCALE);
+    child->dn = pndn_clamp(child->dn + (v > 0 ? v : 0) / PNDN_EVAL_SCALE);
+}
 
-    // Statistics
-    WorkStealingStats ws_stats;
-    pthread_mutex_t stats_mutex;
-} GlobalState;
+static const PnDnInitializer PNDN_INITIALIZERS[] = {
+    {"unit",          pndn_init_unit,          false},  // 従来: pn = dn = 1
+    {"mobility",      pndn_init_mobility,      false},
+    {"eval",          pndn_init_eval,          true},
+    {"mobility+eval", pndn_init_mobility_eval, true},
+};
 
-struct Worker {
-    pthread_t thread;
-    int id;
-    GlobalState *global;
+#define N_PNDN_INITIALIZERS (int)(sizeof(PNDN_INITIALIZERS) / sizeof(PNDN_INITIALIZERS[0]))
 
-    // Hybrid: Per-worker LocalHeap
-    LocalHeap local_heap;
+#ifdef STANDALONE_MAIN
+static const PnDnInitializer *find_pndn_initializer(const char *name) {
+    for (int i = 0; i < N_PNDN_INITIALIZERS; i++) {
+        if (strcmp(PNDN_INITIALIZERS[i].name, name) == 0) return &PNDN_INITIALIZERS[i];
+    }
+    return NULL;
+}
+#endif
 
-    // Local statistics
-    uint64_t nodes;
-    uint64_t tasks_processed;
-    uint64_t tasks_stolen;
+// 葉のpn/dn初期化方式 (--pn-init)
+static const PnDnInitializer *PNDN_INIT = &PNDN_INITIALIZERS[0];
 
-    // Memory pool for node allocation (per-worker, no locking needed)
-    NodePool node_pool;
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Enhanced Transposition Cutoff (--etc)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 木エンジンは子を初期値（--pn-init）で作り、TTは子を訪問したときに初めて引く。
+// ETC では展開の直後に全ての子をTTで引き、ヒットした子を保存済みの pn/dn
+// （証明済みなら石差の範囲から決まる値）で初期化して、親の pn/dn を子から計算し直す。
+//   - ORノードで証明済みの勝ち（pn = 0）の子、ANDノードで証明済みの負け（dn = 0）の子があるか、
+//     全ての子が逆側に証明済みなら、親はその場で証明される（cutoff）
+//   - そうでなければ最初の子選択としきい値判定から保存済みの値を使う
+// ttエンジンは子の再生成時に常にTTを引くので対象外。
+//
+// 戻り値: 親が証明されたか
+static bool etc_probe_children(Worker *worker, DFPNNode *node, uint32_t tag) {
+    TranspositionTable *tt = worker->global->tt;
+    bool any_hit = false;
 
-    ThreadStats *stats;
-    TreeStats *tree_stats;
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        uint64_t key = hash_position(child->player, child->opponent);
+        uint32_t source = 0;
+
+        worker->etc_probes++;
+        bool hit = tt_probe(tt, key, child->depth, worker->target,
+                            &child->pn, &child->dn, &child->result, NULL, &source);
+        dag_note_source(worker, child, source);
+        if (!hit) continue;
+
+        worker->etc_hits++;
+        any_hit = true;
+        if (child->pn == 0 || child->dn == 0) child->is_proven = true;
+    }
+    if (!any_hit) return false;
+
+    // 全ての子がTTで証明済みのときも、子選択は証明済みの子を選ばないので
+    // ここで集約しておかないと親の pn/dn が古いまま残る
+    update_pn_dn(worker, node, tag);
+    if (node->is_proven) {
+        worker->etc_cutoffs++;
+        history_record_cutoff(worker, node);
+        return true;
+    }
+    return false;
+}
 
-#if ENABLE_GLOBAL_CHECK_BENCHMARK
-    // Global comparison statistics (per-thread)
-    uint64_t global_check_count;          // should_switch_to_global呼び出し回数
-    uint64_t global_check_true_count;     // Globalの方が良かった回数
-    uint64_t cumulative_nodes;            // 累積ノード数（タスク間でリセットされない）
-    uint64_t nodes_at_last_check;         // 前回チェック時の累積ノード数
-    uint64_t check_interval_sum;          // チェック間隔（ノード数）の合計
-    uint64_t check_interval_min;          // チェック間隔の最小値
-    uint64_t check_interval_max;          // チェック間隔の最大値
-#endif
+// 増分評価（--eval-incremental）
+//
+// ワーカーの eval_path は再帰の段ごとの特徴量で、子へ降りる前（eval_path_descend）に
+// 親の段から子の段を差分で作る。段の局面が探索中のノードと違えば（タスクの根、
+// ルート分割の子、スタックの深さ超過）その場で最初から作り直すので、正しさは段の検証に頼る。
 
-    // TTヒット時のGlobal切り替え用
-    volatile bool should_abort_task;       // タスク中断フラグ
-    int current_task_priority;             // 現在処理中のタスクの優先度
+// 空きマス数が --eval-min-empties 未満のノードでは子を評価しない
+static inline bool eval_gated_at(int empties) {
+    return empties < EVAL_MIN_EMPTIES;
+}
 
-    // busy_workers追跡用
-    bool is_busy;                          // このワーカーがタスクを持っているか
+// 展開時に評価関数で子を並べるか（--ordering、--endgame-order、--eval-min-empties に従う）。
+// --eval-lazy on でも true（評価は2回目の訪問で使うので、特徴量は子へ降りるときに更新しておく）
+static inline bool expand_uses_eval(const Worker *worker, int empties) {
+    return worker->global->use_evaluation && ordering_uses_eval() && !endgame_order_at(empties)
+        && !eval_gated_at(empties);
+}
 
-    // check_and_export最適化用
-    bool has_entered_chunk_mode;           // 一度でもchunk modeに入ったか
-    uint64_t nodes_at_last_export_check;   // 前回export checkした時のノード数
-};
+// ノードの特徴量（現在の段が別の局面なら作り直す）
+static const EvalFeatures *eval_path_features(Worker *worker, const DFPNNode *node) {
+    int ply = (worker->eval_ply < EVAL_PATH_MAX) ? worker->eval_ply : EVAL_PATH_MAX - 1;
+    EvalFeatures *ef = &worker->eval_path[ply];
+    if (ef->player != node->player || ef->opponent != node->opponent) {
+        eval_features_set(ef, node->player, node->opponent);
+        worker->eval_feature_rebuilds++;
+    }
+    return ef;
+}
 
-static void dfpn_solve_node(Worker *worker, DFPNNode *node);
+// 子へ降りる前に呼び、子の探索から戻ったら eval_path_ascend と対にする
+// needed: 子の部分木で評価関数を使うか（使わなければ段だけ進める）
+static inline void eval_path_descend(Worker *worker, const DFPNNode *node, const DFPNNode *child, bool needed) {
+    if (needed && EVAL_INCREMENTAL && worker->eval_ply + 1 < EVAL_PATH_MAX) {
+        const EvalFeatures *ef = eval_path_features(worker, node);
+        int move = child_move(node, child);
+        uint64_t flip = (move < 0) ? 0 : (node->opponent & ~child->player);
+        eval_features_update(ef, &worker->eval_path[worker->eval_ply + 1], move, flip);
+    }
+    worker->eval_ply++;
+}
 
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-// Hybrid Export/Import Operations
-// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+static inline void eval_path_ascend(Worker *worker) {
+    worker->eval_ply--;
+}
 
-// Export top CHUNK_SIZE tasks from LocalHeap to GlobalChunkQueue
-static void export_top_chunk(Worker *worker) {
-    LocalHeap *lh = &worker->local_heap;
-    GlobalChunkQueue *gq = worker->global->global_chunk_queue;
+// 子（p, o は着手後、p が新しい手番側）の evaluate_position(p, o) と同じ値
+static inline int eval_child_position(Worker *worker, const DFPNNode *node, uint64_t p, uint64_t o, int move) {
+    if (!EVAL_INCREMENTAL) return evaluate_position(p, o);
+    const EvalFeatures *ef = eval_path_features(worker, node);
+    uint64_t flip = (move < 0) ? 0 : (node->opponent & ~p);
+    worker->eval_incremental_evals++;
+    return eval_features_child_score(ef, move, flip, popcount(~(p | o)));
+}
 
-    if (lh->size < CHUNK_SIZE + 1) {
-        return;  // Not enough tasks to export (keep at least 1 for self)
+// ノードの子 n 個（p[i], o[i] は着手後、moves[i] は着手、-1 はパス）の評価値を out に書く。
+// out[i] は eval_child_position と同じ値で、--eval-batch on ならまとめて評価する
+static void eval_children_compute(Worker *worker, const DFPNNode *node, const uint64_t *p, const uint64_t *o,
+                                  const int *moves, int n, int *out) {
+    if (!EVAL_BATCH || n <= 1) {
+        for (int i = 0; i < n; i++) out[i] = eval_child_position(worker, node, p[i], o[i], moves[i]);
+        return;
     }
-
-    Chunk chunk;
-    chunk.count = 0;
-
-    // Pop the best task first (will be pushed back)
-    Task best;
-    if (!local_heap_pop(lh, &best)) {
+    worker->eval_batches++;
+    worker->eval_batched_children += n;
+    if (!EVAL_INCREMENTAL) {
+        evaluate_positions(p, o, n, out);
         return;
     }
+    const EvalFeatures *ef = eval_path_features(worker, node);
+    worker->eval_incremental_evals += n;
+    eval_features_children_score(ef, moves, p, n, popcount(~(p[0] | o[0])), out);
+}
 
-    // Pop CHUNK_SIZE tasks for the chunk
-    for (int i = 0; i < CHUNK_SIZE && lh->size > 0; i++) {
-        if (local_heap_pop(lh, &chunk.tasks[i])) {
-            chunk.count++;
-        }
+// eval_children_compute の前に評価値キャッシュ（--eval-hash）を引き、ミスした子だけを評価する
+static void eval_children_batch(Worker *worker, const DFPNNode *node, const uint64_t *p, const uint64_t *o,
+                                const int *moves, int n, int *out) {
+    worker->eval_child_evals += n;
+    if (!EVAL_HASH_TABLE) {
+        eval_children_compute(worker, node, p, o, moves, n, out);
+        return;
     }
 
-    // Push back the best task
-    local_heap_push(lh, &best);
-
-    // Push chunk to global queue
-    if (chunk.count > 0) {
-        chunk.top_priority = chunk.tasks[0].priority;
-        if (global_chunk_queue_push(gq, &chunk)) {
-            lh->exported_to_global += chunk.count;
-            __sync_fetch_and_add(&worker->global->total_exports, chunk.count);
+    uint64_t h[MAX_CHILDREN], miss_p[MAX_CHILDREN], miss_o[MAX_CHILDREN];
+    int miss[MAX_CHILDREN], miss_moves[MAX_CHILDREN], miss_out[MAX_CHILDREN];
+    int n_miss = 0;
+    for (int i = 0; i < n; i++) {
+        h[i] = eval_hash_key(p[i], o[i]);
+        if (eval_hash_probe(h[i], &out[i])) continue;
+        miss[n_miss] = i;
+        miss_p[n_miss] = p[i];
+        miss_o[n_miss] = o[i];
+        miss_moves[n_miss] = moves[i];
+        n_miss++;
+    }
+    worker->eval_hash_probes += n;
+    worker->eval_hash_hits += n - n_miss;
+    if (n_miss == 0) return;
 
-            #if VERBOSE_EXPORT_IMPORT
-            printf("[Worker %d] Exported %d tasks to Global (top_priority=%d)\n",
-                   worker->id, chunk.count, chunk.top_priority);
-            #endif
-        }
+    eval_children_compute(worker, node, miss_p, miss_o, miss_moves, n_miss, miss_out);
+    for (int k = 0; k < n_miss; k++) {
+        out[miss[k]] = miss_out[k];
+        eval_hash_store(h[miss[k]], miss_out[k]);
     }
 }
 
-// Check and export tasks if conditions are met
-static void check_and_export(Worker *worker) {
-    LocalHeap *lh = &worker->local_heap;
-    GlobalChunkQueue *gq = worker->global->global_chunk_queue;
+// tag: このノードのソースマーカー（--dag、子に付ける）
+static void expand_node_with_evaluation(Worker *worker, DFPNNode *node, uint32_t tag) {
+    uint64_t moves = get_moves(node->player, node->opponent);
+    node->last_child = -1;
+    node->eval_pending = false;
 
-    // Condition 1: Local has enough tasks
-    if (lh->size < LOCAL_EXPORT_THRESHOLD) {
-        return;
+    if (TRACK_TREE_STATS(worker)) {
+        worker->tree_stats->expansions++;
     }
 
-    int global_top = atomic_load(&gq->top_priority);
-    int local_top = lh->heap[0].priority;
-
-    // Continue exporting while conditions are met
-    while (lh->size >= CHUNK_SIZE + 1) {
-        bool global_empty = (global_top == INT_MIN);
-        bool local_is_better = (local_top >= global_top);
+    if (moves == 0) {
+        uint64_t p = node->opponent;
+        uint64_t o = node->player;
 
-        if (!global_empty && !local_is_better) {
-            break;  // Global has better tasks, stop exporting
+        if (get_moves(p, o) == 0) {
+            node->n_children = 0;
+            if (TRACK_TREE_STATS(worker)) {
+                worker->tree_stats->terminal_nodes++;
+            }
+            return;
         }
 
-        export_top_chunk(worker);
-
-        // Update for next iteration
-        global_top = atomic_load(&gq->top_priority);
-        local_top = (lh->size > 0) ? lh->heap[0].priority : INT_MIN;
-    }
-}
-
-// Import chunk from GlobalChunkQueue to LocalHeap
-static bool import_chunk_from_global(Worker *worker, Task *out_task) {
-    GlobalChunkQueue *gq = worker->global->global_chunk_queue;
-    LocalHeap *lh = &worker->local_heap;
+        if (TRACK_TREE_STATS(worker)) {
+            worker->tree_stats->pass_nodes++;
+        }
 
-    Chunk chunk;
-    if (global_chunk_queue_pop(gq, &chunk)) {
-        // First task goes to caller
-        *out_task = chunk.tasks[0];
+        DFPNNode *child = node_pool_alloc(&worker->node_pool);
+        child->player = p;
+        child->opponent = o;
+        child->type = (node->type == NODE_OR) ? NODE_AND : NODE_OR;
+        child->depth = node->depth;
+        child->deep = dpn_leaf_deep(child->depth);
 
-        // Remaining tasks go to LocalHeap
-        for (int i = 1; i < chunk.count; i++) {
-            local_heap_push(lh, &chunk.tasks[i]);
+        if (expand_uses_eval(worker, node->depth)) {
+            if (EVAL_LAZY) {
+                node->eval_pending = true;
+                worker->eval_lazy_deferred++;
+            } else {
+                int pass_move = -1, eval;
+                eval_children_batch(worker, node, &p, &o, &pass_move, 1, &eval);
+                child->eval_score = -eval;
+            }
+        } else if (worker->global->use_evaluation && ordering_uses_eval() && !endgame_order_at(node->depth)) {
+            worker->eval_gated++;
         }
+        worker->global->pn_init->init(node, child);
 
-        lh->imported_from_global += chunk.count;
-        __sync_fetch_and_add(&worker->global->total_imports, chunk.count);
+        node->children = malloc(sizeof(DFPNNode*));
+        node->children[0] = child;
+        node->n_children = 1;
+        dag_mark_children(node, tag);
+        if (ETC_ENABLED) etc_probe_children(worker, node, tag);
+        return;
+    }
 
-        #if VERBOSE_EXPORT_IMPORT
-        printf("[Worker %d] Imported %d tasks from Global (top_priority=%d)\n",
-               worker->id, chunk.count, chunk.top_priority);
-        #endif
+    int n_moves = popcount(moves);
+    node->children = malloc(n_moves * sizeof(DFPNNode*));
+    node->n_children = n_moves;
 
-        return true;
+    if (TRACK_TREE_STATS(worker)) {
+        worker->tree_stats->avg_branching_factor =
+            (worker->tree_stats->avg_branching_factor * (worker->tree_stats->expansions - 1) + n_moves) /
+            worker->tree_stats->expansions;
     }
-    return false;
-}
 
-// Check if should switch to Global (called after tt_store)
-// TTヒット時に呼び出され、Globalの優先度と現在のタスク優先度を比較
-// Globalの方が良ければshould_abort_taskフラグを立てる
-static bool should_switch_to_global(Worker *worker) {
-    GlobalChunkQueue *gq = worker->global->global_chunk_queue;
+    // [最適化] 評価関数の二重呼び出しを削除
+    // フェーズ1: 盤面計算と評価を1回だけ実行し、配列に保存
+    MoveWithEval *moves_array = malloc(n_moves * sizeof(MoveWithEval));
+    PriorityQueue *pq = pq_create(n_moves);
+    uint64_t moves_copy = moves;
+    uint64_t empty = ~(node->player | node->opponent);
+    bool endgame_order = endgame_order_at(node->depth);
+    if (endgame_order) worker->endgame_order_expansions++;
 
-    int global_top = atomic_load(&gq->top_priority);
-    int current_priority = worker->current_task_priority;
+    // 子の盤面（評価関数はまとめて呼ぶので先に全て作る）
+    uint64_t child_p[MAX_CHILDREN], child_o[MAX_CHILDREN];
+    int child_moves[MAX_CHILDREN], child_evals[MAX_CHILDREN];
+    int idx = 0;
+    while(moves_copy) {
+        int move = first_one(moves_copy);
+        moves_copy &= moves_copy - 1;
 
-    // Globalの優先度が現在のタスクより十分高ければ切り替え
-    bool result = (global_top > current_priority);
+        uint64_t p = node->player;
+        uint64_t o = node->opponent;
+        make_move(&p, &o, move);
 
-    if (result) {
-        // 中断フラグを立てる（dfpn_solve_nodeで検知）
-        worker->should_abort_task = true;
+        // 結果を配列に保存
+        moves_array[idx].move = move;
+        moves_array[idx].player = p;
+        moves_array[idx].opponent = o;
+        child_p[idx] = p;
+        child_o[idx] = o;
+        child_moves[idx] = move;
+        idx++;
     }
 
-#if ENABLE_GLOBAL_CHECK_BENCHMARK
-    // 統計を記録
-    worker->global_check_count++;
-    if (result) {
-        worker->global_check_true_count++;
+    bool use_eval = !endgame_order && expand_uses_eval(worker, node->depth);
+    // 評価を省く子・遅らせる子は終盤用の順序付けで並べる（--eval-min-empties / --eval-lazy on）
+    bool cheap_order = endgame_order;
+    if (!endgame_order && ordering_uses_eval() && worker->global->use_evaluation) {
+        if (!use_eval) {
+            worker->eval_gated += n_moves;
+            cheap_order = true;
+        } else if (EVAL_LAZY) {
+            node->eval_pending = true;
+            worker->eval_lazy_deferred += n_moves;
+            use_eval = false;
+            cheap_order = true;
+        }
     }
+    if (use_eval) eval_children_batch(worker, node, child_p, child_o, child_moves, n_moves, child_evals);  // 1回のみ評価
 
-    // チェック間隔（ノード数）を計算
-    // NOTE: worker->nodesはタスクごとにリセットされるため、累積カウンタを使用
-    uint64_t current_nodes = worker->cumulative_nodes;
-    if (worker->nodes_at_last_check > 0 && current_nodes > worker->nodes_at_last_check) {
-        uint64_t interval = current_nodes - worker->nodes_at_last_check;
-        worker->check_interval_sum += interval;
-
-        if (interval < worker->check_interval_min || worker->check_interval_min == 0) {
-            worker->check_interval_min = interval;
-        }
-        if (interval > worker->check_interval_max) {
-            worker->check_interval_max = interval;
+    for (idx = 0; idx < n_moves; idx++) {
+        int move = moves_array[idx].move;
+        int priority;
+        if (cheap_order) {
+            moves_array[idx].eval_score = 0;
+            priority = endgame_order_score(empty, move, moves_array[idx].player, moves_array[idx].opponent);
+        } else {
+            moves_array[idx].eval_score = use_eval ? -child_evals[idx] : 0;
+            // 優先度: 評価値（--ordering eval）、none は着手生成順
+            priority = (MOVE_ORDERING == ORDER_NONE) ? -idx : moves_array[idx].eval_score;
         }
+        // 履歴・キラー手（--ordering history / eval+history）
+        if (ordering_uses_history()) priority += history_bonus(worker, node->depth, move);
+        pq_push(pq, idx, priority);
     }
-    worker->nodes_at_last_check = current_nodes;
-#endif
 
-    return result;
-}
+    // フェーズ2: 保存された結果を使用して優先度順に子ノードを作成
+    for (int i = 0; i < n_moves; i++) {
+        int move_idx = pq_pop(pq);
+        MoveWithEval *m = &moves_array[move_idx];
 
-// 高速共有モードかどうかを判定（暇なワーカーがいるか）
-// ビットマップ方式: worker_has_idle() で高速判定
-static inline bool is_fast_sharing_mode(GlobalState *g) {
-    // 暇なワーカーがいれば高速共有モード
-    // ビットマップで効率的に判定（各ワーカーが自分のビットだけを更新するため競合が少ない）
-    if (worker_has_idle(&g->worker_state)) {
-        return true;
+        DFPNNode *child = node_pool_alloc(&worker->node_pool);
+        child->player = m->player;
+        child->opponent = m->opponent;
+        child->type = (node->type == NODE_OR) ? NODE_AND : NODE_OR;
+        child->depth = node->depth - 1;
+        child->deep = dpn_leaf_deep(child->depth);
+        child->eval_score = m->eval_score;  // 保存された評価値を使用
+        worker->global->pn_init->init(node, child);
+
+        node->children[i] = child;
     }
 
-    // 終盤フェーズ: アクティブワーカーが閾値以下なら高速共有モード
-    int active = atomic_load(&g->worker_state.active_workers);
-    return (active < g->worker_state.fast_sharing_threshold);
+    pq_free(pq);
+    free(moves_array);
+
+    dag_mark_children(node, tag);
+    if (ETC_ENABLED) etc_probe_children(worker, node, tag);
 }
 
-// Hybrid task acquisition
-static bool get_next_task_hybrid(Worker *worker, Task *out_task) {
-    GlobalState *g = worker->global;
-    LocalHeap *lh = &worker->local_heap;
-    GlobalChunkQueue *gq = g->global_chunk_queue;
+// 遅延評価（--eval-lazy on）
+//
+// 展開時は子を終盤用の順序付け（着手後の相手の合法手数・偶数理論）で並べて評価関数を呼ばず、
+// 展開済みのノードを2回目に訪れたとき（しきい値を超えて一度戻った後）に未証明の子だけを評価し、
+// 評価値順に並べ直す。1回目の訪問で証明されるノードや二度と訪れないノードの子は評価しない。
+static void eval_lazy_resolve(Worker *worker, DFPNNode *node) {
+    uint64_t p[MAX_CHILDREN], o[MAX_CHILDREN];
+    int moves[MAX_CHILDREN], evals[MAX_CHILDREN], priority[MAX_CHILDREN];
+    DFPNNode *pending[MAX_CHILDREN];
+    int n_open = 0;
+
+    node->eval_pending = false;
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        if (child->is_proven) continue;
+        pending[n_open] = child;
+        p[n_open] = child->player;
+        o[n_open] = child->opponent;
+        moves[n_open] = child_move(node, child);
+        n_open++;
+    }
+    if (n_open == 0) return;
 
-    bool fast_sharing = is_fast_sharing_mode(g);
+    eval_children_batch(worker, node, p, o, moves, n_open, evals);
+    worker->eval_lazy_resolved += n_open;
+    for (int k = 0; k < n_open; k++) pending[k]->eval_score = -evals[k];
+    if (node->n_children == 1) return;
 
-    // ========================================
-    // 高速共有モード（起動フェーズ / 終盤フェーズ）
-    // - SharedTaskArrayを優先（ソート不要、CASのみ）
-    // - チャンクは使わない（オーバーヘッド回避）
-    // ========================================
-    if (fast_sharing) {
-        // 1. まずLocalHeapから取得（自分のタスクがあれば処理）
-        if (lh->size > 0) {
-            local_heap_pop(lh, out_task);
-            return true;
+    // 展開時と同じ優先度で安定に並べ直す（証明済みの子は選ばれないので末尾）
+    for (int i = 0; i < node->n_children; i++) {
+        const DFPNNode *child = node->children[i];
+        priority[i] = child->is_proven ? INT_MIN : child->eval_score;
+        if (!child->is_proven && ordering_uses_history()) {
+            priority[i] += history_bonus(worker, node->depth, child_move(node, child));
         }
-
-        // 2. SharedTaskArrayから取得（他ワーカーが投入したタスク）
-        if (shared_array_pop(g->shared_array, out_task)) {
-            if (DEBUG_CONFIG.track_work_stealing) {
-                debug_log("Worker %d got task from SharedArray (fast_sharing, priority=%d, busy=%d/%d)\n",
-                       worker->id, out_task->priority,
-                       worker_count_busy(&g->worker_state),
-                       g->worker_state.total_workers);
-            }
-            return true;
+    }
+    for (int i = 1; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        int pr = priority[i];
+        int j = i - 1;
+        while (j >= 0 && priority[j] < pr) {
+            node->children[j + 1] = node->children[j];
+            priority[j + 1] = priority[j];
+            j--;
         }
-
-        return false;
+        node->children[j + 1] = child;
+        priority[j + 1] = pr;
     }
+    node->last_child = -1;
+}
 
-    // ========================================
-    // 通常モード（全ワーカー稼働中）
-    // - LocalHeap + GlobalChunkQueue のハイブリッド
-    // - 優先度に基づく選択
-    // ========================================
+static int get_final_score(uint64_t P, uint64_t O) {
+    int p_count = popcount(P);
+    int o_count = popcount(O);
+    int empty = 64 - p_count - o_count;
 
-    int global_top = atomic_load(&gq->top_priority);
-    int local_top = (lh->size > 0) ? lh->heap[0].priority : INT_MIN;
+    // プレイヤーPから見たスコアを返す
+    // P > O: プレイヤーの勝ち → 正の値（空きマスもプレイヤーのものになる）
+    // O > P: プレイヤーの負け → 負の値（空きマスは相手のものになる）
+    // P == O: 引き分け → 0
+    if (p_count > o_count) return p_count - o_count + empty;
+    else if (o_count > p_count) return -(o_count - p_count + empty);
+    else return 0;
+}
 
-    // Check 1: Global has better task?
-    if (global_top > local_top) {
-        if (import_chunk_from_global(worker, out_task)) {
-            return true;
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Stable discs (--stability)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 確定石（以後どう打っても返らない石）から最終石差の範囲を見積もり、展開前に
+// 証明目標が決まる局面を証明済みにする（Edax の stability cutoff と同じ考え方）。
+// 手番側の確定石 s_p、相手の確定石 s_o のとき、手番側の最終石差は [2*s_p - 64, 64 - 2*s_o]。
+//
+// 確定石は下限の見積もり:
+//   1. 辺: 8マスの辺の全局面（3^8）について、辺の中の着手だけで返らない石を事前計算した表
+//   2. 横・縦・2斜めの4方向の線がすべて埋まっている石
+//   3. 1, 2 から内側へ広げる（4方向それぞれで線が埋まっているか、隣が確定石）
+
+static uint8_t EDGE_STABILITY[256][256];
+static uint64_t FILE_A_UNPACK[256];     // 8ビットの辺 → a列（ビット 0, 8, ..., 56）
+static uint64_t FILE_H_UNPACK[256];     // 8ビットの辺 → h列（ビット 7, 15, ..., 63）
+static uint64_t DIAG9_LINES[15];        // 左上-右下方向の斜め線
+static uint64_t DIAG7_LINES[15];        // 右上-左下方向の斜め線
+static bool stability_initialized = false;
+
+// 辺（8マス）の中で両者が残りの空きマスに打ち続けても返らない P の石を求める
+static int find_edge_stable(int old_P, int old_O, int stable) {
+    int E = ~(old_P | old_O) & 0xff;
+
+    stable &= old_P;
+    if (!stable || E == 0) return stable;
+
+    for (int x = 0; x < 8; x++) {
+        if (!(E & (1 << x))) continue;
+
+        // P が x に打つ / O が x に打つ の両方を調べる
+        for (int side = 0; side < 2; side++) {
+            int P = side ? old_O : old_P;
+            int O = side ? old_P : old_O;
+            P |= 1 << x;
+            int y;
+            if (x > 1) {
+                for (y = x - 1; y > 0 && (O & (1 << y)); y--) ;
+                if (P & (1 << y)) {
+                    for (y = x - 1; y > 0 && (O & (1 << y)); y--) {
+                        O ^= 1 << y;
+                        P ^= 1 << y;
+                    }
+                }
+            }
+            if (x < 6) {
+                for (y = x + 1; y < 8 && (O & (1 << y)); y++) ;
+                if (y < 8 && (P & (1 << y))) {
+                    for (y = x + 1; y < 8 && (O & (1 << y)); y++) {
+                        O ^= 1 << y;
+                        P ^= 1 << y;
+                    }
+                }
+            }
+            stable = side ? find_edge_stable(O, P, stable) : find_edge_stable(P, O, stable);
+            if (!stable) return stable;
         }
     }
+    return stable;
+}
 
-    // Check 2: Get from Local
-    if (lh->size > 0) {
-        local_heap_pop(lh, out_task);
-        return true;
-    }
+static void stability_init(void) {
+    if (stability_initialized) return;
 
-    // Check 3: Get from Global (Local is empty)
-    if (import_chunk_from_global(worker, out_task)) {
-        return true;
+    for (int P = 0; P < 256; P++) {
+        for (int O = 0; O < 256; O++) {
+            EDGE_STABILITY[P][O] = (P & O) ? 0 : (uint8_t)find_edge_stable(P, O, P);
+        }
     }
-
-    // Fallback: SharedTaskArray (終盤に残ったタスク)
-    if (shared_array_pop(g->shared_array, out_task)) {
-        return true;
+    for (int x = 0; x < 256; x++) {
+        uint64_t a = 0;
+        for (int i = 0; i < 8; i++) {
+            if (x & (1 << i)) a |= 1ULL << (8 * i);
+        }
+        FILE_A_UNPACK[x] = a;
+        FILE_H_UNPACK[x] = a << 7;
+    }
+    for (int d = 0; d < 15; d++) {
+        uint64_t l9 = 0, l7 = 0;
+        for (int row = 0; row < 8; row++) {
+            int c9 = d - 7 + row;   // col - row = d - 7
+            int c7 = d - row;       // col + row = d
+            if (c9 >= 0 && c9 < 8) l9 |= 1ULL << (row * 8 + c9);
+            if (c7 >= 0 && c7 < 8) l7 |= 1ULL << (row * 8 + c7);
+        }
+        DIAG9_LINES[d] = l9;
+        DIAG7_LINES[d] = l7;
     }
+    stability_initialized = true;
+}
 
-    return false;  // No task available
+static inline int pack_file_a(uint64_t b) {
+    return (int)(((b & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56);
 }
 
-// Share remaining tasks to SharedTaskArray (for endgame)
-static void share_remaining_tasks(Worker *worker) {
-    GlobalState *g = worker->global;
-    LocalHeap *lh = &worker->local_heap;
+static inline int pack_file_h(uint64_t b) {
+    return (int)((((b & 0x8080808080808080ULL) >> 7) * 0x0102040810204080ULL) >> 56);
+}
 
-    // Keep one for self, share the rest
-    while (lh->size > 1) {
-        Task task;
-        if (!local_heap_pop(lh, &task)) {
-            break;
-        }
-        if (!shared_array_push(g->shared_array, &task)) {
-            // SharedArray is full, put it back
-            local_heap_push(lh, &task);
-            break;
-        }
-    }
+// 4辺の確定石（事前計算した表から）
+static inline uint64_t get_stable_edge(uint64_t P, uint64_t O) {
+    return (uint64_t)EDGE_STABILITY[P & 0xff][O & 0xff]
+         | (uint64_t)EDGE_STABILITY[P >> 56][O >> 56] << 56
+         | FILE_A_UNPACK[EDGE_STABILITY[pack_file_a(P)][pack_file_a(O)]]
+         | FILE_H_UNPACK[EDGE_STABILITY[pack_file_h(P)][pack_file_h(O)]];
 }
 
-static DFPNNode* select_best_child_with_priority(DFPNNode *node) {
-    if (!node->children || node->n_children == 0) return NULL;
+// 方向ごとに「その方向の線がすべて埋まっている」マス
+static inline void get_full_lines(uint64_t disc, uint64_t full[4]) {
+    // 横
+    uint64_t h = disc;
+    h &= (h >> 1) | 0x8080808080808080ULL;
+    h &= (h >> 2) | 0xc0c0c0c0c0c0c0c0ULL;
+    h &= (h >> 4) | 0xf0f0f0f0f0f0f0f0ULL;
+    h &= 0x0101010101010101ULL;
+    full[0] = h * 0xff;
+
+    // 縦
+    uint64_t v = disc;
+    v &= v >> 8;
+    v &= v >> 16;
+    v &= v >> 32;
+    full[1] = (v & 0xff) * 0x0101010101010101ULL;
+
+    // 斜め
+    uint64_t d9 = 0, d7 = 0;
+    for (int d = 0; d < 15; d++) {
+        if ((disc & DIAG9_LINES[d]) == DIAG9_LINES[d]) d9 |= DIAG9_LINES[d];
+        if ((disc & DIAG7_LINES[d]) == DIAG7_LINES[d]) d7 |= DIAG7_LINES[d];
+    }
+    full[2] = d9;
+    full[3] = d7;
+}
 
-    // [最適化] 優先度キューを線形探索に置き換え
-    // 理由: 1つの要素のみ取り出すため、O(n)の線形探索で十分
-    //       malloc/freeのオーバーヘッドも削減
-    int best_idx = -1;
-    int best_priority = INT_MIN;
+// P の確定石の数（下限）
+static int get_stable_count(uint64_t P, uint64_t O) {
+    uint64_t full[4];
+    get_full_lines(P | O, full);
+
+    uint64_t stable = get_stable_edge(P, O);
+    stable |= full[0] & full[1] & full[2] & full[3] & P;
+    if (stable == 0) return 0;
+
+    // 内側のマスへ広げる（辺のマスは表で確定済み）
+    uint64_t central = P & 0x007e7e7e7e7e7e00ULL;
+    uint64_t old_stable;
+    do {
+        old_stable = stable;
+        uint64_t sh = (stable >> 1) | (stable << 1) | full[0];
+        uint64_t sv = (stable >> 8) | (stable << 8) | full[1];
+        uint64_t s9 = (stable >> 9) | (stable << 9) | full[2];
+        uint64_t s7 = (stable >> 7) | (stable << 7) | full[3];
+        stable |= sh & sv & s9 & s7 & central;
+    } while (stable != old_stable);
+
+    return popcount(stable);
+}
 
-    if (node->type == NODE_OR) {
-        for (int i = 0; i < node->n_children; i++) {
-            int priority = (PN_INF - node->children[i]->pn) + node->children[i]->eval_score;
-            if (priority > best_priority) {
-                best_priority = priority;
-                best_idx = i;
-            }
-        }
+// 展開前の確定石による判定。証明目標が決まればノードを証明済みにして true を返す
+static bool stability_cutoff(Worker *worker, DFPNNode *node, int target) {
+    if (!worker->global->stability || node->depth < STABILITY_MIN_EMPTIES) return false;
+    worker->stability_nodes[node->depth]++;
+
+    // ルートムーブ側 R と相手側 A の石（ORノードでは手番側が R）
+    bool or_node = (node->type == NODE_OR);
+    uint64_t R = or_node ? node->player : node->opponent;
+    uint64_t A = or_node ? node->opponent : node->player;
+
+    // ルートムーブ側の最終石差は [2*s_R - 64, 64 - 2*s_A]
+    int need_r = (64 + target + 1) / 2;     // 2*s_R - 64 >= target で WIN
+    int need_a = (64 - target) / 2 + 1;     // 64 - 2*s_A < target で LOSE
+
+    // 石数が足りなければ確定石を数えるまでもない
+    if (popcount(R) >= need_r && get_stable_count(R, A) >= need_r) {
+        node->result = RESULT_EXACT_WIN;
+        node->pn = 0;
+        node->dn = DN_INF;
+    } else if (popcount(A) >= need_a && get_stable_count(A, R) >= need_a) {
+        node->result = RESULT_EXACT_LOSE;
+        node->pn = PN_INF;
+        node->dn = 0;
     } else {
-        for (int i = 0; i < node->n_children; i++) {
-            int priority = (DN_INF - node->children[i]->dn) - node->children[i]->eval_score;
-            if (priority > best_priority) {
-                best_priority = priority;
-                best_idx = i;
-            }
-        }
+        return false;
     }
-
-    return (best_idx >= 0) ? node->children[best_idx] : NULL;
+    node->is_proven = true;
+    worker->stability_cuts[node->depth]++;
+    return true;
 }
 
-static void update_pn_dn(DFPNNode *node) {
-    if (node->children == NULL || node->n_children == 0) {
-        return;
-    }
-
-    // 修正版: is_provenフラグを使用した厳密なDRAW伝播
+// 終端ノード（両者パス）の勝敗をpn/dnに設定する
+// target: 証明目標（ルートムーブを打ったプレイヤーの石差 >= target なら WIN）
+static void set_terminal_result(DFPNNode *node, int target) {
+    // get_final_score(node->player, node->opponent) は「現在手番のプレイヤー」視点のスコアを返す。
+    // pn/dn は「証明対象（ルートムーブを打ったプレイヤー）」視点なので:
     //
-    // pn/dn計算は従来通り行う（探索を正しく進めるため）
-    // DRAWの伝播のみ is_proven フラグで厳密に管理
+    // - ルートタスクはNODE_AND（相手の手番）から開始
+    // - NODE_OR: 自分の手番 → node->playerは「ルートムーブを打ったプレイヤー」→ そのまま
+    // - NODE_AND: 相手の手番 → node->playerは「相手」→ 符号を反転
     //
-    // 「証明済みDRAW」の定義:
-    // - is_proven == true && result == RESULT_EXACT_DRAW
-    // - これは終端ノード（スコア=0）から正しく伝播されたDRAWのみ
+    // 旧実装は石差 > 0 を勝ちに固定し、石差 = 0 を pn = dn = INF のDRAWとして
+    // 別経路で伝播していた。現在は target との比較で必ず WIN / LOSE に決まる。
 
-    if (node->type == NODE_OR) {
-        // ORノード: pn = min(子のpn), dn = sum(子のdn)
-        uint32_t min_pn = PN_INF;
-        uint64_t sum_dn = 0;
+    int score = get_final_score(node->player, node->opponent);
+    int root_score = (node->type == NODE_OR) ? score : -score;
 
-        int proven_draw_count = 0;
-        int proven_win_count = 0;
-        int total_proven = 0;
+    if (root_score >= target) {
+        node->result = RESULT_EXACT_WIN;
+        node->pn = 0;
+        node->dn = DN_INF;
+    } else {
+        node->result = RESULT_EXACT_LOSE;
+        node->pn = PN_INF;
+        node->dn = 0;
+    }
+    // 終端ノードは常に証明済み
+    node->is_proven = true;
+}
 
-        for (int i = 0; i < node->n_children; i++) {
-            DFPNNode *child = node->children[i];
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Bounded-memory df-pn: Subtree GC (--node-budget)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// ワーカーの生存ノード数が予算に達したら、探索パス外の部分木をTTに畳み込み、
+// ノードをNodePoolのフリーリストへ返す。
+//
+//   パス1: 証明済みの部分木（pn=0 / dn=0）を畳み込む
+//   パス2: SmallTreeGC方式。小さい（=探索労力の少ない）部分木から畳み込み、
+//          生存ノード数が低水位（予算の NODE_GC_LOW_WATERMARK %）を下回るまで
+//          サイズ上限を4倍ずつ広げて繰り返す
+//
+// 畳み込まれた部分木の根ノード自体は葉として残すので、親のchildren配列は
+// 有効なまま。再訪問時はTTプローブでpn/dnを復元し、通常通り再展開される。
+// on_path（現在の再帰パス上）のノードは決して畳み込まない。
 
-            if (child->pn < min_pn) {
-                min_pn = child->pn;
-            }
-            sum_dn += child->dn;
-            if (sum_dn >= DN_INF) sum_dn = DN_INF;
+// Release all descendants of node to the free list (node itself is kept)
+static void node_pool_release_subtree(NodePool *pool, DFPNNode *node) {
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        node_pool_release_subtree(pool, child);
+        node_pool_free(pool, child);
+    }
+    free(node->children);
+    node->children = NULL;
+    node->n_children = 0;
+}
 
-            // 証明済み状態のカウント
-            if (child->pn == 0) {
-                proven_win_count++;
-                total_proven++;
-            } else if (child->dn == 0) {
-                total_proven++;
-            } else if (child->is_proven && child->result == RESULT_EXACT_DRAW) {
-                proven_draw_count++;
-                total_proven++;
-            }
+static void gc_collapse_subtree(Worker *worker, DFPNNode *node) {
+    uint64_t key = hash_position(node->player, node->opponent);
+    tt_store(worker->global->tt, key, node->depth, worker->target,
+             node->pn, node->dn, node->result, node->eval_score, node->source);
+    node_pool_release_subtree(&worker->node_pool, node);
+}
+
+// 証明済み部分木と、サイズがsize_limit以下の極大部分木を畳み込む
+// 戻り値: 部分木サイズ（証明済み部分木は畳み込み後、それ以外は畳み込み前）
+static uint64_t gc_sweep(Worker *worker, DFPNNode *node, uint64_t size_limit) {
+    uint64_t size = 1;
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        if (child->children == NULL) {
+            size++;
+            continue;
         }
+        if (!child->on_path && (child->pn == 0 || child->dn == 0 || child->is_proven)) {
+            gc_collapse_subtree(worker, child);
+            size++;
+            continue;
+        }
+        uint64_t child_size = gc_sweep(worker, child, size_limit);
+        if (!child->on_path && child_size <= size_limit) {
+            gc_collapse_subtree(worker, child);
+        }
+        size += child_size;
+    }
+    return size;
+}
 
-        node->pn = min_pn;
-        node->dn = (uint32_t)sum_dn;
+static void node_pool_gc(Worker *worker) {
+    NodePool *pool = &worker->node_pool;
+    uint64_t budget = worker->global->node_budget;
+    uint64_t low_watermark = budget * NODE_GC_LOW_WATERMARK / 100;
+    uint64_t before = pool->live_nodes;
 
-        // 結果の判定
-        if (node->pn == 0) {
-            node->result = RESULT_EXACT_WIN;
-            node->is_proven = true;
-        } else if (node->dn == 0) {
-            node->result = RESULT_EXACT_LOSE;
-            node->is_proven = true;
-        } else if (total_proven == node->n_children && proven_draw_count > 0) {
-            // すべての子が証明済みで、DRAWがある → DRAW
-            // (WINがあればpn=0になるので、ここには来ない)
-            node->result = RESULT_EXACT_DRAW;
-            node->is_proven = true;
-            node->pn = PN_INF;
-            node->dn = DN_INF;
+    if (worker->gc_root) {
+        // パス1: 証明済み部分木のみ
+        uint64_t tree_size = gc_sweep(worker, worker->gc_root, 0);
+
+        // パス2: SmallTreeGC（小さい部分木から）
+        for (uint64_t limit = 8; pool->live_nodes > low_watermark && limit < tree_size; limit *= 4) {
+            gc_sweep(worker, worker->gc_root, limit);
         }
+    }
 
-    } else {
-        // ANDノード: pn = sum(子のpn), dn = min(子のdn)
-        uint64_t sum_pn = 0;
-        uint32_t min_dn = DN_INF;
+    worker->gc_runs++;
+    worker->gc_nodes_freed += before - pool->live_nodes;
 
-        int proven_draw_count = 0;
-        int proven_lose_count = 0;
-        int total_proven = 0;
+    // パスだけで予算を使い切っている場合に毎ノードGCが走らないよう、次回の発動点をずらす
+    worker->gc_next_trigger = (pool->live_nodes > low_watermark)
+                            ? pool->live_nodes + (budget - low_watermark)
+                            : budget;
 
-        for (int i = 0; i < node->n_children; i++) {
-            DFPNNode *child = node->children[i];
+    if (DEBUG_CONFIG.verbose) {
+        debug_log("Worker %d: NODE GC #%llu freed %llu nodes (live=%llu, budget=%llu)\n",
+                  worker->id, (unsigned long long)worker->gc_runs,
+                  (unsigned long long)(before - pool->live_nodes),
+                  (unsigned long long)pool->live_nodes, (unsigned long long)budget);
+    }
+}
 
-            sum_pn += child->pn;
-            if (sum_pn >= PN_INF) sum_pn = PN_INF;
-            if (child->dn < min_dn) {
-                min_dn = child->dn;
-            }
+// タスクの木を捨ててプールを空にする。GCが上げた発動点は前のタスクの生存ノード数に
+// 合わせたものなので、予算に戻す
+static void node_pool_reset_task(Worker *worker) {
+    node_pool_reset(&worker->node_pool);
+    worker->gc_root = NULL;
+    worker->gc_next_trigger = worker->global->node_budget;
+}
 
-            // 証明済み状態のカウント
-            if (child->dn == 0) {
-                proven_lose_count++;
-                total_proven++;
-            } else if (child->pn == 0) {
-                total_proven++;
-            } else if (child->is_proven && child->result == RESULT_EXACT_DRAW) {
-                proven_draw_count++;
-                total_proven++;
-            }
-        }
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// 1+ε threshold (--epsilon)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 標準のMIDでは最良子のしきい値を「2番手 + 1」とするため、pn/dnが拮抗する兄弟の間で
+// 数ノードごとに選択が入れ替わり、そのたびにパスの再走査とTTアクセスが発生する。
+// 1+ε規則（Pawlewicz & Lew）では 2番手の (1+ε) 倍まで最良子に留まる:
+//   ORノード:  child.th_pn = min(th_pn, max(pn2 + 1, ⌈pn2 × (1+ε)⌉))
+//              child.th_dn = th_dn - dn + child.dn
+//   ANDノード: pn/dn を入れ替えた対称形
+// 和の側がINFで飽和している場合、その側のしきい値は制約しない（INF+1）。
+// 飽和値からの差分で子のしきい値を作ると、子のpn/dnが1ずつしか進まなくなるため。
+//
+// ε < 0 の場合、木エンジンは従来のしきい値と評価値付きの子選択を使う。
 
-        node->pn = (uint32_t)sum_pn;
-        node->dn = min_dn;
+// 最小pn（ORノード）/最小dn（ANDノード）の子のインデックスを選び、second-best値も返す
+static int select_min_child(DFPNNode *node, uint32_t *second) {
+    int best = -1;
+    uint32_t best_value = UINT32_MAX;
+    uint32_t second_value = UINT32_MAX;
 
-        // 結果の判定
-        if (node->dn == 0) {
-            node->result = RESULT_EXACT_LOSE;
-            node->is_proven = true;
-        } else if (node->pn == 0) {
-            node->result = RESULT_EXACT_WIN;
-            node->is_proven = true;
-        } else if (total_proven == node->n_children && proven_draw_count > 0) {
-            // すべての子が証明済みで、DRAWがある → DRAW
-            // (LOSEがあればdn=0になるので、ここには来ない)
-            node->result = RESULT_EXACT_DRAW;
-            node->is_proven = true;
-            node->pn = PN_INF;
-            node->dn = DN_INF;
+    for (int i = 0; i < node->n_children; i++) {
+        DFPNNode *child = node->children[i];
+        // 証明済みの子は選ばない（和の側がINFで飽和していると、
+        // min値が同点になり証明済みの子を選び続けて進まなくなる）
+        if (child->is_proven || child->pn == 0 || child->dn == 0) continue;
+        uint32_t value = (node->type == NODE_OR) ? child->pn : child->dn;
+        bool better;
+        if (best < 0 || value < best_value) {
+            better = true;
+        } else if (value == best_value) {
+            // タイブレーク: 評価値（ORは子の評価が高い方、ANDは低い方）
+            int16_t best_eval = node->children[best]->eval_score;
+            better = (node->type == NODE_OR) ? child->eval_score > best_eval
+                                             : child->eval_score < best_eval;
+        } else {
+            better = false;
+        }
+
+        if (better) {
+            if (best >= 0) second_value = best_value;
+            best = i;
+            best_value = value;
+        } else if (value < second_value) {
+            second_value = value;
         }
     }
-}
 
-static void expand_node_with_evaluation(Worker *worker, DFPNNode *node) {
-    uint64_t moves = get_moves(node->player, node->opponent);
+    *second = (second_value > PN_INF) ? PN_INF : second_value;
+    return best;
+}
 
-    if (DEBUG_CONFIG.track_tree_stats && worker->tree_stats) {
-        worker->tree_stats->expansions++;
+// 2番手の値から最良子のしきい値を求める（飽和時は INF+1）
+static inline uint32_t epsilon_threshold(uint32_t second, double epsilon) {
+    if (second >= PN_INF) return PN_INF + 1;
+    uint64_t th = (uint64_t)second + 1;
+    if (epsilon > 0) {
+        uint64_t widened = (uint64_t)ceil(second * (1.0 + epsilon));
+        if (widened > th) th = widened;
     }
+    return (th > PN_INF) ? PN_INF + 1 : (uint32_t)th;
+}
 
-    if (moves == 0) {
-        uint64_t p = node->opponent;
-        uint64_t o = node->player;
+static void set_child_thresholds(DFPNNode *node, DFPNNode *child, uint32_t second, double epsilon) {
+    uint32_t th = epsilon_threshold(second, epsilon);
+    // 最小値以外の子を選んだ場合（DPN選択）でも、子が少なくとも1ノードは進めるようにする
+    uint32_t value = (node->type == NODE_OR) ? child->pn : child->dn;
+    if (th <= value) th = value + 1;
+    if (node->type == NODE_OR) {
+        child->threshold_pn = (node->threshold_pn < th) ? node->threshold_pn : th;
+        child->threshold_dn = (node->dn >= DN_INF) ? DN_INF + 1
+                            : node->threshold_dn - node->dn + child->dn;
+    } else {
+        child->threshold_dn = (node->threshold_dn < th) ? node->threshold_dn : th;
+        child->threshold_pn = (node->pn >= PN_INF) ? PN_INF + 1
+                            : node->threshold_pn - node->pn + child->pn;
+    }
+}
 
-        if (get_moves(p, o) == 0) {
-            node->n_children = 0;
-            if (DEBUG_CONFIG.track_tree_stats && worker->tree_stats) {
-                worker->tree_stats->terminal_nodes++;
-            }
-            return;
+// 選んだ子が前回と異なれば兄弟切り替えとして数える
+static inline void record_child_selection(Worker *worker, DFPNNode *node, int idx) {
+    if (node->last_child >= 0 && node->last_child != idx) {
+        if (node->sibling_switches < UINT16_MAX) node->sibling_switches++;
+        worker->sibling_switches++;
+        if (node->sibling_switches > worker->max_node_switches) {
+            worker->max_node_switches = node->sibling_switches;
         }
+    }
+    node->last_child = (int16_t)idx;
+}
 
-        if (DEBUG_CONFIG.track_tree_stats && worker->tree_stats) {
-            worker->tree_stats->pass_nodes++;
-        }
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Tree-less df-pn engine (--engine tt)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// DFPNNode木を保持せず、現在の探索パスのみをスタック上に持つ深さ優先df-pn（MID）。
+// 各訪問で子ノードを再生成し、子のpn/dnはTT経由で読み書きする。
+// メモリ使用量は木のサイズではなくTTサイズのみに比例する。
+//
+//   - 子のしきい値は second-best 規則（1+ε、ε < 0 は ε = 0 として扱う）
+//   - pn/dnの集約は木エンジンと同じ update_pn_dn
+//   - 子の選択は純粋な最小pn（OR）/最小dn（AND）。評価値は同値時のタイブレークのみ
+//     （評価値で最小でない子を選ぶと、second-best しきい値が子のpn以下になり進捗しない）
+//   - 評価値は新規の子（TTミス）に対してのみ計算し、以降はTTの eval_score を使う
+//
+// 注意: この経路では EARLY SPAWN / MID-SEARCH SPAWN / spawn_child_tasks は発生しない
+//       （並列性はルートタスクとROOT SPLITのみ）。
 
-        DFPNNode *child = node_pool_alloc(&worker->node_pool);
-        child->player = p;
-        child->opponent = o;
-        child->type = (node->type == NODE_OR) ? NODE_AND : NODE_OR;
-        child->depth = node->depth;
-        child->pn = 1;
-        child->dn = 1;
+#define TT_ENGINE_MAX_CHILDREN 34   // 合法手の最大数（33）+ 余裕
+
+// 探索を中断すべきか（WIN発見 / シャットダウン / 時間切れ / Global切り替え）
+static bool dfpn_should_stop(Worker *worker) {
+    if (worker->global->found_win || worker->global->shutdown) return true;
+    if (worker->should_abort_task) return true;
 
-        if (worker->global->use_evaluation) {
-            child->eval_score = -evaluate_position(p, o);
+    if (worker->global->time_limit > 0 && (worker->nodes & 0x3FF) == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double elapsed = (now.tv_sec - worker->global->start_time.tv_sec) +
+                        (now.tv_nsec - worker->global->start_time.tv_nsec) / 1e9;
+        if (elapsed >= worker->global->time_limit) {
+            worker->global->shutdown = true;
+            return true;
         }
+    }
+    return false;
+}
 
-        node->children = malloc(sizeof(DFPNNode*));
-        node->children[0] = child;
-        node->n_children = 1;
-        return;
+// TTの値をノードに反映する（証明済みならis_provenも立てる）
+static bool dfpn_tt_lookup(Worker *worker, uint64_t key, DFPNNode *node) {
+    int16_t eval_score = 0;
+    uint32_t source = 0;
+    bool hit = tt_probe(worker->global->tt, key, node->depth, worker->target,
+                        &node->pn, &node->dn, &node->result, &eval_score, &source);
+    dag_note_source(worker, node, source);
+    if (!hit) {
+        return false;
+    }
+    node->eval_score = eval_score;
+    if (node->pn == 0 || node->dn == 0) {
+        node->is_proven = true;
     }
+    return true;
+}
 
-    int n_moves = popcount(moves);
-    node->children = malloc(n_moves * sizeof(DFPNNode*));
-    node->n_children = n_moves;
+static void dfpn_tt_mid(Worker *worker, DFPNNode *node, uint64_t key) {
+    worker->nodes++;
+    TranspositionTable *tt = worker->global->tt;
+    int target = worker->target;
 
-    if (DEBUG_CONFIG.track_tree_stats && worker->tree_stats) {
-        worker->tree_stats->avg_branching_factor =
-            (worker->tree_stats->avg_branching_factor * (worker->tree_stats->expansions - 1) + n_moves) /
-            worker->tree_stats->expansions;
+    if (TRACK_TREE_STATS(worker) && node->depth < 65) {
+        worker->tree_stats->nodes_by_depth[node->depth]++;
     }
 
-    // [最適化] 評価関数の二重呼び出しを削除
-    // フェーズ1: 盤面計算と評価を1回だけ実行し、配列に保存
-    MoveWithEval *moves_array = malloc(n_moves * sizeof(MoveWithEval));
-    PriorityQueue *pq = pq_create(n_moves);
-    uint64_t moves_copy = moves;
+    if (dfpn_should_stop(worker)) return;
 
-    int idx = 0;
-    while(moves_copy) {
-        int move = first_one(moves_copy);
-        moves_copy &= moves_copy - 1;
+    bool revisit = false;
+    if (dfpn_tt_lookup(worker, key, node)) {
+        if (worker->stats) worker->stats->tt_hits++;
+        should_switch_to_global(worker);
+        if (node->is_proven) return;
+        worker->reexpansions++;
+        revisit = true;
+    }
 
-        uint64_t p = node->player;
-        uint64_t o = node->opponent;
-        make_move(&p, &o, move);
+    if (stability_cutoff(worker, node, target)) {
+        tt_store(tt, key, node->depth, target, node->pn, node->dn, node->result, node->eval_score, node->source);
+        if (worker->stats) worker->stats->tt_stores++;
+        return;
+    }
 
-        // 結果を配列に保存
-        moves_array[idx].move = move;
-        moves_array[idx].player = p;
-        moves_array[idx].opponent = o;
+    // 子ノードの再生成（スタック上）
+    DFPNNode children[TT_ENGINE_MAX_CHILDREN];
+    DFPNNode *child_ptrs[TT_ENGINE_MAX_CHILDREN];
+    uint64_t child_keys[TT_ENGINE_MAX_CHILDREN];
+    int n = 0;
+    NodeType child_type = (node->type == NODE_OR) ? NODE_AND : NODE_OR;
+    bool use_eval = worker->global->use_evaluation;
+    double epsilon = (worker->global->epsilon > 0) ? worker->global->epsilon : 0.0;
+    uint32_t tag = dag_tag(key);
+
+    uint64_t moves = get_moves(node->player, node->opponent);
+    if (moves == 0) {
+        if (get_moves(node->opponent, node->player) == 0) {
+            if (TRACK_TREE_STATS(worker)) {
+                worker->tree_stats->terminal_nodes++;
+            }
+            set_terminal_result(node, target);
+            tt_store(tt, key, node->depth, target, node->pn, node->dn, node->result, node->eval_score, node->source);
+            if (worker->stats) worker->stats->tt_stores++;
+            return;
+        }
+        memset(&children[0], 0, sizeof(DFPNNode));
+        children[0].player = node->opponent;
+        children[0].opponent = node->player;
+        children[0].depth = node->depth;
+        n = 1;
+    } else {
+        while (moves) {
+            int move = first_one(moves);
+            moves &= moves - 1;
+            memset(&children[n], 0, sizeof(DFPNNode));
+            children[n].player = node->player;
+            children[n].opponent = node->opponent;
+            make_move(&children[n].player, &children[n].opponent, move);
+            children[n].depth = node->depth - 1;
+            n++;
+        }
+    }
 
-        if (worker->global->use_evaluation) {
-            moves_array[idx].eval_score = -evaluate_position(p, o);  // 1回のみ評価
+    // TTミスの子だけを評価する（まとめて評価してから pn/dn を初期化）
+    int miss[TT_ENGINE_MAX_CHILDREN], n_miss = 0;
+    for (int i = 0; i < n; i++) {
+        DFPNNode *child = &children[i];
+        child->type = child_type;
+        child_ptrs[i] = child;
+        child_keys[i] = hash_position(child->player, child->opponent);
+        child->source = tag;
+        if (!dfpn_tt_lookup(worker, child_keys[i], child)) miss[n_miss++] = i;
+    }
+    // --eval-min-empties 未満では評価しない。--eval-lazy on では1回目の訪問（TTミス）で評価せず、
+    // TTに残った未証明の局面を再び訪れたときにTTミスの子だけを評価する
+    bool eval_misses = use_eval;
+    if (use_eval && eval_gated_at(node->depth)) {
+        worker->eval_gated += n_miss;
+        eval_misses = false;
+    } else if (use_eval && EVAL_LAZY) {
+        if (revisit) {
+            worker->eval_lazy_resolved += n_miss;
         } else {
-            moves_array[idx].eval_score = 0;
+            worker->eval_lazy_deferred += n_miss;
+            eval_misses = false;
+        }
+    }
+    if (eval_misses && n_miss > 0) {
+        uint64_t miss_p[TT_ENGINE_MAX_CHILDREN], miss_o[TT_ENGINE_MAX_CHILDREN];
+        int miss_moves[TT_ENGINE_MAX_CHILDREN], miss_evals[TT_ENGINE_MAX_CHILDREN];
+        for (int k = 0; k < n_miss; k++) {
+            const DFPNNode *child = &children[miss[k]];
+            miss_p[k] = child->player;
+            miss_o[k] = child->opponent;
+            miss_moves[k] = child_move(node, child);
         }
+        eval_children_batch(worker, node, miss_p, miss_o, miss_moves, n_miss, miss_evals);
+        for (int k = 0; k < n_miss; k++) children[miss[k]].eval_score = -miss_evals[k];
+    }
+    for (int k = 0; k < n_miss; k++) {
+        worker->global->pn_init->init(node, &children[miss[k]]);
+    }
 
-        pq_push(pq, idx, moves_array[idx].eval_score);
-        idx++;
+    node->children = child_ptrs;
+    node->n_children = n;
+    node->last_child = -1;
+    worker->path_nodes += n;
+    if (worker->path_nodes > worker->peak_path_nodes) {
+        worker->peak_path_nodes = worker->path_nodes;
+    }
+    if (TRACK_TREE_STATS(worker)) {
+        worker->tree_stats->expansions++;
     }
 
-    // フェーズ2: 保存された結果を使用して優先度順に子ノードを作成
-    for (int i = 0; i < n_moves; i++) {
-        int move_idx = pq_pop(pq);
-        MoveWithEval *m = &moves_array[move_idx];
+    for (;;) {
+        if (update_pn_dn(worker, node, tag)) worker->dag_corrections++;
+        if (node->is_proven || node->pn == 0 || node->dn == 0) break;
+        if (node->pn >= node->threshold_pn || node->dn >= node->threshold_dn) break;
+        if (dfpn_should_stop(worker)) break;
 
-        DFPNNode *child = node_pool_alloc(&worker->node_pool);
-        child->player = m->player;
-        child->opponent = m->opponent;
-        child->type = (node->type == NODE_OR) ? NODE_AND : NODE_OR;
-        child->depth = node->depth - 1;
-        child->pn = 1;
-        child->dn = 1;
-        child->eval_score = m->eval_score;  // 保存された評価値を使用
+        uint32_t second;
+        int idx = select_min_child(node, &second);
+        if (idx < 0) break;
+        DFPNNode *child = &children[idx];
+        set_child_thresholds(node, child, second, epsilon);
+        record_child_selection(worker, node, idx);
 
-        node->children[i] = child;
+        eval_path_descend(worker, node, child, use_eval && !eval_gated_at(child->depth));
+        dfpn_tt_mid(worker, child, child_keys[idx]);
+        eval_path_ascend(worker);
+
+        if (TRACK_TREE_STATS(worker)) {
+            worker->tree_stats->pn_dn_updates++;
+        }
+
+        // 他ワーカーの成果を取り込むため、未証明の兄弟をTTから再読込
+        for (int i = 0; i < n; i++) {
+            if (&children[i] == child || children[i].is_proven) continue;
+            dfpn_tt_lookup(worker, child_keys[i], &children[i]);
+        }
     }
 
-    pq_free(pq);
-    free(moves_array);
+    worker->path_nodes -= n;
+    node->children = NULL;
+    node->n_children = 0;
+
+    tt_store(tt, key, node->depth, target, node->pn, node->dn, node->result, node->eval_score, node->source);
+    if (worker->stats) worker->stats->tt_stores++;
 }
 
-static int get_final_score(uint64_t P, uint64_t O) {
-    int p_count = popcount(P);
-    int o_count = popcount(O);
-    int empty = 64 - p_count - o_count;
+static void dfpn_solve_node_or(Worker *worker, DFPNNode *node);
+static void dfpn_solve_node_and(Worker *worker, DFPNNode *node);
 
-    // プレイヤーPから見たスコアを返す
-    // P > O: プレイヤーの勝ち → 正の値（空きマスもプレイヤーのものになる）
-    // O > P: プレイヤーの負け → 負の値（空きマスは相手のものになる）
-    // P == O: 引き分け → 0
-    if (p_count > o_count) return p_count - o_count + empty;
-    else if (o_count > p_count) return -(o_count - p_count + empty);
-    else return 0;
+// on_pathマークでラップする（GCが再帰パス上のノードを回収しないように）
+// --engine tt の場合は木を作らない深さ優先エンジンへ委譲する
+// ノードの種類による分岐はここで1回だけ行い、OR/AND で特殊化した本体を呼ぶ
+static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
+    if (worker->global->engine == ENGINE_TT && node->children == NULL) {
+        dfpn_tt_mid(worker, node, hash_position(node->player, node->opponent));
+        return;
+    }
+    node->on_path = true;
+    if (node->type == NODE_OR) {
+        dfpn_solve_node_or(worker, node);
+    } else {
+        dfpn_solve_node_and(worker, node);
+    }
+    node->on_path = false;
 }
 
-static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
+// type: node->type。OR/AND の2つの版（dfpn_solve_node_or / _and）に展開され、
+// 本体と update_pn_dn / select_best_child_with_priority の種類の分岐は定数として畳まれる
+static ALWAYS_INLINE void dfpn_solve_node_body(Worker *worker, DFPNNode *node, const NodeType type) {
     worker->nodes++;
 #if ENABLE_GLOBAL_CHECK_BENCHMARK
     worker->cumulative_nodes++;
@@ -2728,7 +6548,7 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
 
     // Step 3: Do other work while waiting for memory
     // Update thread stats
-    if (DEBUG_CONFIG.track_threads && worker->stats) {
+    if (TRACK_THREADS(worker)) {
         worker->stats->nodes_explored = worker->nodes;
         worker->stats->current_depth = node->depth;
         worker->stats->is_active = true;
@@ -2736,7 +6556,7 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
     }
 
     // Track depth distribution
-    if (DEBUG_CONFIG.track_tree_stats && worker->tree_stats && node->depth < 65) {
+    if (TRACK_TREE_STATS(worker) && node->depth < 65) {
         worker->tree_stats->nodes_by_depth[node->depth]++;
     }
 
@@ -2759,8 +6579,15 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
 
     // Step 4: Now probe TT (data should be in cache from prefetch)
     int16_t eval_score = 0;
+    bool tt_hit = false;
 
-    if (tt_probe(tt, key, node->depth, &node->pn, &node->dn, &node->result, &eval_score)) {
+    int target = worker->target;
+
+    uint32_t source = 0;
+    tt_hit = tt_probe(tt, key, node->depth, target, &node->pn, &node->dn, &node->result, &eval_score, &source);
+    dag_note_source(worker, node, source);
+
+    if (tt_hit) {
         if (worker->stats) worker->stats->tt_hits++;
 
         // TT-HIT VARIANT: Check global queue on TT hit
@@ -2775,80 +6602,40 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
                 node->is_proven = true;  // TT hitでも証明済みフラグを立てる
                 return;
             }
-            // DRAW (pn=∞ かつ dn=∞) の場合も即座にreturn
-            if (node->result == RESULT_EXACT_DRAW && node->pn == PN_INF && node->dn == DN_INF) {
-                node->is_proven = true;  // TT hitでも証明済みフラグを立てる
-                return;
-            }
         }
         node->eval_score = eval_score;
     }
 
     if (node->children == NULL) {
-        expand_node_with_evaluation(worker, node);
+        // 確定石だけで証明目標が決まれば展開しない
+        if (stability_cutoff(worker, node, target)) {
+            tt_store(tt, key, node->depth, target, node->pn, node->dn, node->result, node->eval_score, node->source);
+            if (worker->stats) worker->stats->tt_stores++;
+            return;
+        }
 
-        if (node->n_children == 0) {
-            // 終端ノードの判定:
-            //
-            // get_final_score(node->player, node->opponent) は「現在手番のプレイヤー」視点のスコアを返す。
-            // しかし、df-pnでは「証明対象（ルートムーブを打ったプレイヤー）」の勝敗を判定する。
-            //
-            // - ルートタスクはNODE_AND（相手の手番）から開始
-            // - NODE_OR: 自分の手番 → node->playerは「ルートムーブを打ったプレイヤー」
-            // - NODE_AND: 相手の手番 → node->playerは「相手」
-            //
-            // pn/dnの意味（参考実装 df-pn.c に準拠）:
-            // - pn = 0: ルートムーブを打ったプレイヤーの勝ちが証明された
-            // - dn = 0: ルートムーブを打ったプレイヤーの負けが証明された
-            //
-            // したがって:
-            // - NODE_OR（自分の手番）で score > 0 → 自分の勝ち → pn = 0
-            // - NODE_OR（自分の手番）で score < 0 → 自分の負け → dn = 0
-            // - NODE_AND（相手の手番）で score > 0 → 相手の勝ち = 自分の負け → dn = 0
-            // - NODE_AND（相手の手番）で score < 0 → 相手の負け = 自分の勝ち → pn = 0
-
-            int score = get_final_score(node->player, node->opponent);
-
-            if (node->type == NODE_OR) {
-                // 自分の手番: scoreはそのまま自分視点
-                if (score > 0) {
-                    node->result = RESULT_EXACT_WIN;
-                    node->pn = 0;
-                    node->dn = DN_INF;
-                } else if (score < 0) {
-                    node->result = RESULT_EXACT_LOSE;
-                    node->pn = PN_INF;
-                    node->dn = 0;
-                } else {
-                    node->result = RESULT_EXACT_DRAW;
-                    node->pn = PN_INF;
-                    node->dn = DN_INF;
-                }
-            } else {
-                // NODE_AND: 相手の手番 → scoreは相手視点なので反転が必要
-                if (score > 0) {
-                    // 相手の勝ち = 自分の負け
-                    node->result = RESULT_EXACT_LOSE;
-                    node->pn = PN_INF;
-                    node->dn = 0;
-                } else if (score < 0) {
-                    // 相手の負け = 自分の勝ち
-                    node->result = RESULT_EXACT_WIN;
-                    node->pn = 0;
-                    node->dn = DN_INF;
-                } else {
-                    node->result = RESULT_EXACT_DRAW;
-                    node->pn = PN_INF;
-                    node->dn = DN_INF;
-                }
-            }
-            // 終端ノードは常に証明済み
-            node->is_proven = true;
+        // Bounded-memory df-pn: 予算に達していれば展開前に部分木を回収
+        if (worker->global->node_budget > 0 &&
+            worker->node_pool.live_nodes >= worker->gc_next_trigger) {
+            node_pool_gc(worker);
+        }
 
-            tt_store(worker->global->tt, key, node->depth, node->pn, node->dn, node->result, node->eval_score);
+        // 未証明のままTTに残っていた局面（GC回収・合流）を再び展開する
+        if (tt_hit) worker->reexpansions++;
+
+        expand_node_with_evaluation(worker, node, dag_tag(key));
+
+        // 子がない（終局）、または ETC で証明済みの子から親が決まった
+        if (node->n_children == 0 || node->is_proven) {
+            if (node->n_children == 0) set_terminal_result(node, target);
+
+            tt_store(worker->global->tt, key, node->depth, target, node->pn, node->dn, node->result, node->eval_score, node->source);
             if (worker->stats) worker->stats->tt_stores++;
             return;
         }
+    } else if (node->eval_pending) {
+        // 展開済みのノードへの2回目の訪問: 遅らせていた子の評価（--eval-lazy on）
+        eval_lazy_resolve(worker, node);
     }
 
     // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -2863,7 +6650,7 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
         float idle_rate = 1.0f - (float)busy_count / (float)total_workers;
 
         // ★ ローカルヒープサイズで判定（startup_phaseの代わり）
-        int local_size = worker->local_heap.size;
+        int local_size = sched_local_size(worker);
         bool local_heap_needs_fill = (local_size < CHUNK_SIZE);
 
         // SharedArrayの使用率をチェック（オーバーフロー防止）
@@ -2886,7 +6673,7 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
                 if (child->pn == 0 || child->dn == 0) continue;
 
                 int priority;
-                if (node->type == NODE_OR) {
+                if (type == NODE_OR) {
                     priority = (PN_INF - child->pn) / 1000 + child->eval_score;
                 } else {
                     priority = (DN_INF - child->dn) / 1000 - child->eval_score;
@@ -2901,10 +6688,11 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
                     .is_root_task = false,
                     .depth = child->depth,
                     .node_type = child->type,
-                    .generation = 3  // 早期スポーンのマーカー
+                    .generation = 3,  // 早期スポーンのマーカー
+                    .target = worker->target
                 };
 
-                if (shared_array_push(worker->global->shared_array, &subtask)) {
+                if (sched_push_shared(worker, &subtask)) {
                     early_spawned++;
                     __sync_fetch_and_add(&worker->global->subtasks_spawned, 1);
                 }
@@ -2948,7 +6736,7 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
                     if (c->depth < worker->global->min_depth_for_spawn / 2) continue;  // 浅すぎスキップ
 
                     int priority;
-                    if (node->type == NODE_OR) {
+                    if (type == NODE_OR) {
                         priority = (PN_INF - c->pn) / 1000 + c->eval_score;
                     } else {
                         priority = (DN_INF - c->dn) / 1000 - c->eval_score;
@@ -2963,10 +6751,11 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
                         .is_root_task = false,
                         .depth = c->depth,
                         .node_type = c->type,
-                        .generation = 5  // 探索途中スポーンのマーカー
+                        .generation = 5,  // 探索途中スポーンのマーカー
+                        .target = worker->target
                     };
 
-                    if (shared_array_push(worker->global->shared_array, &subtask)) {
+                    if (sched_push_shared(worker, &subtask)) {
                         spawned++;
                         __sync_fetch_and_add(&worker->global->subtasks_spawned, 1);
                     }
@@ -2980,33 +6769,61 @@ static void dfpn_solve_node(Worker *worker, DFPNNode *node) {
         }
         // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
-        DFPNNode *child = select_best_child_with_priority(node);
-        if (child == NULL) break;
-
-        if (node->type == NODE_OR) {
-            child->threshold_pn = node->threshold_dn - node->dn + child->dn;
-            child->threshold_dn = node->threshold_pn;
+        DFPNNode *child;
+        if (worker->global->epsilon >= 0) {
+            // 1+ε しきい値: 最小pn/dnの子（--dpn-r 指定時はDPN最小の子）を選び、
+            // second-best 規則でしきい値を設定
+            uint32_t second;
+            uint32_t limit = (type == NODE_OR) ? node->threshold_pn : node->threshold_dn;
+            double dpn_r = worker->global->dpn_r;
+            int idx = (dpn_r >= 0) ? select_dpn_child(node, dpn_r, limit, &second)
+                                   : select_min_child(node, &second);
+            if (idx < 0) break;
+            child = node->children[idx];
+            set_child_thresholds(node, child, second, worker->global->epsilon);
+            record_child_selection(worker, node, idx);
         } else {
-            child->threshold_pn = node->threshold_pn;
-            child->threshold_dn = node->threshold_dn - node->dn + child->dn;
+            int idx = select_best_child_with_priority(worker, node, type);
+            if (idx < 0) break;
+            child = node->children[idx];
+            record_child_selection(worker, node, idx);
+
+            if (type == NODE_OR) {
+                child->threshold_pn = node->threshold_dn - node->dn + child->dn;
+                child->threshold_dn = node->threshold_pn;
+            } else {
+                child->threshold_pn = node->threshold_pn;
+                child->threshold_dn = node->threshold_dn - node->dn + child->dn;
+            }
         }
 
+        eval_path_descend(worker, node, child, expand_uses_eval(worker, child->depth));
         dfpn_solve_node(worker, child);
-        update_pn_dn(node);
+        eval_path_ascend(worker);
+        if (update_pn_dn_typed(worker, node, dag_tag(key), type)) worker->dag_corrections++;
+        if (node->is_proven) history_record_cutoff(worker, node);
 
-        if (DEBUG_CONFIG.track_tree_stats && worker->tree_stats) {
+        if (TRACK_TREE_STATS(worker)) {
             worker->tree_stats->pn_dn_updates++;
         }
 
     }
 
-    tt_store(worker->global->tt, key, node->depth, node->pn, node->dn, node->result, node->eval_score);
+    tt_store(worker->global->tt, key, node->depth, target, node->pn, node->dn, node->result, node->eval_score, node->source);
     if (worker->stats) worker->stats->tt_stores++;
 
     // TT-HIT VARIANT: Global check is done only on TT hit (in tt_probe branch)
     // (removed from here to reduce check frequency)
 }
 
+static void dfpn_solve_node_or(Worker *worker, DFPNNode *node) {
+    dfpn_solve_node_body(worker, node, NODE_OR);
+}
+
+static void dfpn_solve_node_and(Worker *worker, DFPNNode *node) {
+    dfpn_solve_node_body(worker, node, NODE_AND);
+}
+
 // Free only the children arrays (nodes are managed by memory pool)
 static void free_dfpn_tree_children(DFPNNode *node) {
     if (!node) return;
@@ -3046,7 +6863,7 @@ static int spawn_child_tasks(Worker *worker, DFPNNode *node, Task *parent_task)
     // ローカルヒープがチャンク未満なら、制限を緩和（ただし無制限ではない）
     // SharedArrayオーバーフロー防止のため、上限を設ける
     // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
-    int local_size = worker->local_heap.size;
+    int local_size = sched_local_size(worker);
     bool local_heap_needs_fill = (local_size < CHUNK_SIZE);
 
     // SharedArrayの使用率をチェック（オーバーフロー防止）
@@ -3108,7 +6925,7 @@ static int spawn_child_tasks(Worker *worker, DFPNNode *node, Task *parent_task)
         bool has_idle = worker_has_idle(&worker->global->worker_state);
 
         // LocalHeapのサイズをチェック
-        int local_size = worker->local_heap.size;
+        int local_size = sched_local_size(worker);
         const int chunk_size = CHUNK_SIZE;  // 16
 
         if (DEBUG_CONFIG.verbose) {
@@ -3191,6 +7008,11 @@ static int spawn_child_tasks(Worker *worker, DFPNNode *node, Task *parent_task)
     // ループ中にモードが変わっても、フォールバック機構で問題なく動作する
     bool fast_sharing = is_fast_sharing_mode(worker->global);
 
+    // --scheduler chaselev: 子タスクは一旦ためて、優先度の低い順に自分のdequeへ積む
+    // （オーナーのLIFO popは最良の子から、盗む側のFIFOは残りの子から取る）
+    Task *deque_batch = worker->global->deques ? malloc(node->n_children * sizeof(Task)) : NULL;
+    int n_batch = 0;
+
     // ★ フェーズ3: 動的スポーン制限を使用
     for (int i = 0; i < node->n_children && spawned < effective_spawn_limit; i++) {
         DFPNNode *child = node->children[i];
@@ -3214,9 +7036,16 @@ static int spawn_child_tasks(Worker *worker, DFPNNode *node, Task *parent_task)
             .is_root_task = false,
             .depth = child->depth,
             .node_type = child->type,
-            .generation = generation + 1
+            .generation = generation + 1,
+            .target = parent_task->target
         };
 
+        if (deque_batch) {
+            deque_batch[n_batch++] = subtask;
+            spawned++;
+            continue;
+        }
+
         // HYBRID: 高速共有モードではSharedTaskArrayを使用、通常モードではLocalHeap
         // (fast_sharingはループ前に1回だけ判定済み)
 
@@ -3271,6 +7100,35 @@ static int spawn_child_tasks(Worker *worker, DFPNNode *node, Task *parent_task)
         }
     }
 
+    if (deque_batch) {
+        // 優先度の昇順に並べ替え（子の数は少ないので挿入ソート）
+        for (int i = 1; i < n_batch; i++) {
+            Task t = deque_batch[i];
+            int j = i - 1;
+            while (j >= 0 && deque_batch[j].priority > t.priority) {
+                deque_batch[j + 1] = deque_batch[j];
+                j--;
+            }
+            deque_batch[j + 1] = t;
+        }
+        for (int i = 0; i < n_batch; i++) {
+            if (sched_push_local(worker, &deque_batch[i])) {
+                __sync_fetch_and_add(&worker->global->subtasks_spawned, 1);
+            } else {
+                spawned--;  // dequeが満杯 → この子は親の探索に任せる
+            }
+        }
+        if (DEBUG_CONFIG.track_work_stealing && n_batch > 0) {
+            debug_log("Worker %d spawned %d subtasks gen=%d to deque (size=%d)\n",
+                      worker->id, spawned, generation + 1, sched_local_size(worker));
+        }
+
+        // dequeは他のワーカーが直接盗むので、エクスポートは不要
+        free(deque_batch);
+        free(children_prio);
+        return spawned;
+    }
+
     // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
     // ★ アイドル駆動型エクスポート（fast_sharingに関係なく実行）
     // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -3370,24 +7228,29 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
     root->n_children = 0;
     root->result = RESULT_UNKNOWN;
     root->is_proven = false;
+    root->on_path = true;   // GC対象外（dfpn_solve_nodeを経由しないため手動で設定）
+    worker->gc_root = root;
 
-    // 子ノードを即座に展開
-    expand_node_with_evaluation(worker, root);
+    // 子ノードを即座に展開（子はすぐに評価値を優先度にしてタスクにするので評価を遅らせない）
+    uint32_t root_tag = DAG_PNDN ? dag_tag(hash_position(p, o)) : 0;
+    expand_node_with_evaluation(worker, root, root_tag);
+    if (root->eval_pending) eval_lazy_resolve(worker, root);
 
     // 子がない場合は通常処理にフォールバック
     if (root->children == NULL || root->n_children == 0) {
         debug_log("Worker %d: ROOT SPLIT - no children, fallback to normal\n", worker->id);
         dfpn_solve_node(worker, root);
 
-        // 結果判定
+        // 結果判定（pn/dnはノード種別によらずルートムーブを打ったプレイヤー視点）
         uint64_t key = hash_position(p, o);
         Result result = RESULT_UNKNOWN;
         if (root->pn == 0) {
-            result = (root->type == NODE_OR) ? RESULT_EXACT_WIN : RESULT_EXACT_LOSE;
+            result = RESULT_EXACT_WIN;
         } else if (root->dn == 0) {
-            result = (root->type == NODE_OR) ? RESULT_EXACT_LOSE : RESULT_EXACT_WIN;
+            result = RESULT_EXACT_LOSE;
         }
-        tt_store(worker->global->tt, key, root->depth, root->pn, root->dn, result, root->eval_score);
+        tt_store(worker->global->tt, key, root->depth, worker->target,
+                 root->pn, root->dn, result, root->eval_score, root->source);
 
         // WIN報告
         if (result == RESULT_EXACT_WIN) {
@@ -3400,7 +7263,7 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
         }
 
         free_dfpn_tree_children(root);
-        node_pool_reset(&worker->node_pool);
+        node_pool_reset_task(worker);
         return true;
     }
 
@@ -3423,9 +7286,9 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
         }
     }
 
-    // 最良以外の子をSharedArrayにスポーン
+    // 最良以外の子をSharedArrayにスポーン（ETC で証明済みならスポーンしない）
     int spawned = 0;
-    for (int i = 0; i < root->n_children; i++) {
+    for (int i = 0; i < root->n_children && !root->is_proven; i++) {
         if (i == best_idx) continue;  // 最良は自分で処理
 
         DFPNNode *child = root->children[i];
@@ -3447,10 +7310,11 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
             .is_root_task = false,
             .depth = child->depth,
             .node_type = child->type,
-            .generation = 1
+            .generation = 1,
+            .target = task->target
         };
 
-        if (shared_array_push(worker->global->shared_array, &subtask)) {
+        if (sched_push_shared(worker, &subtask)) {
             spawned++;
             __sync_fetch_and_add(&worker->global->subtasks_spawned, 1);
         }
@@ -3462,22 +7326,21 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
               spawned, root->n_children - 1);
 
     // 最良子ノードを自分で処理
-    if (root->children[best_idx]->pn > 0 && root->children[best_idx]->dn > 0) {
+    if (!root->is_proven && root->children[best_idx]->pn > 0 && root->children[best_idx]->dn > 0) {
         dfpn_solve_node(worker, root->children[best_idx]);
     }
-    update_pn_dn(root);
+    if (update_pn_dn(worker, root, root_tag)) worker->dag_corrections++;
 
-    // 結果判定とTT保存
+    // 結果判定とTT保存（pn/dnはルートムーブを打ったプレイヤー視点）
     uint64_t key = hash_position(p, o);
     Result result = RESULT_UNKNOWN;
     if (root->pn == 0) {
-        result = (root->type == NODE_OR) ? RESULT_EXACT_WIN : RESULT_EXACT_LOSE;
+        result = RESULT_EXACT_WIN;
     } else if (root->dn == 0) {
-        result = (root->type == NODE_OR) ? RESULT_EXACT_LOSE : RESULT_EXACT_WIN;
-    } else if (root->pn >= PN_INF && root->dn >= DN_INF) {
-        result = RESULT_EXACT_DRAW;
+        result = RESULT_EXACT_LOSE;
     }
-    tt_store(worker->global->tt, key, root->depth, root->pn, root->dn, result, root->eval_score);
+    tt_store(worker->global->tt, key, root->depth, worker->target,
+             root->pn, root->dn, result, root->eval_score, root->source);
 
     // ルートタスクの結果を記録
     int move_idx = -1;
@@ -3506,9 +7369,7 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
                               worker->id,
                               'a' + (task->root_move % 8), 8 - (task->root_move / 8));
 
-                    if (worker->global->global_chunk_queue) {
-                        pthread_cond_broadcast(&worker->global->global_chunk_queue->cond);
-                    }
+                    chunk_queues_broadcast(worker->global);
                 }
             }
 
@@ -3519,7 +7380,10 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
                 Task retry_task = *task;
                 retry_task.priority = task->priority - 100;
                 retry_task.generation = 1;  // ★ generation=1にして通常処理にする（無限ループ防止）
-                local_heap_push(&worker->local_heap, &retry_task);
+                if (!sched_requeue(worker, &retry_task)) {
+                    fprintf(stderr, "Warning: worker %d could not re-enqueue root move %c%d (all queues full)\n",
+                            worker->id, 'a' + (task->root_move % 8), 8 - (task->root_move / 8));
+                }
 
                 debug_log("Worker %d: ROOT SPLIT %c%d not proven (pn=%u, dn=%u), re-enqueued as normal task\n",
                           worker->id,
@@ -3530,7 +7394,7 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
     }
 
     free_dfpn_tree_children(root);
-    node_pool_reset(&worker->node_pool);
+    node_pool_reset_task(worker);
     return true;
 }
 
@@ -3539,6 +7403,7 @@ static bool process_root_task_with_split(Worker *worker, Task *task) {
 // Returns true if task was fully processed, false if aborted for Global switch
 static bool process_task(Worker *worker, Task *task) {
     worker->tasks_processed++;
+    worker->target = task->target;
 
     // ★ フェーズ1修正: ルートタスク（generation=0）は即座分割処理へ分岐
     if (task->is_root_task && task->generation == 0) {
@@ -3584,6 +7449,7 @@ static bool process_task(Worker *worker, Task *task) {
     // Note: PN_INF + 1 is needed because when pn = PN_INF, we still want pn < threshold_pn to be true
     root->threshold_pn = PN_INF + 1;
     root->threshold_dn = DN_INF + 1;
+    worker->gc_root = root;
 
     // Perform the search (TT probe is done inside dfpn_solve_node)
     uint64_t key = hash_position(p, o);
@@ -3593,11 +7459,12 @@ static bool process_task(Worker *worker, Task *task) {
     // 現在のタスクをLocalHeapに戻し、Globalから新しいタスクを取得する
     if (worker->should_abort_task) {
         // 現在の途中結果をTTに保存（次回の探索で再利用）
-        tt_store(worker->global->tt, key, root->depth, root->pn, root->dn, RESULT_UNKNOWN, root->eval_score);
+        tt_store(worker->global->tt, key, root->depth, worker->target,
+                 root->pn, root->dn, RESULT_UNKNOWN, root->eval_score, root->source);
 
         // ツリーのクリーンアップ
         free_dfpn_tree_children(root);
-        node_pool_reset(&worker->node_pool);
+        node_pool_reset_task(worker);
 
         // 統計
         __sync_fetch_and_add(&worker->global->global_switches, 1);
@@ -3621,43 +7488,29 @@ static bool process_task(Worker *worker, Task *task) {
 
     // Determine result from pn/dn
     //
-    // FIXED: ノードタイプを考慮した結果判定
-    //
-    // df-pnでは、pn/dnはそのノード視点での証明/反証を表す。
-    // しかし、ルートタスクはNODE_AND（相手の手番）なので、結果を反転する必要がある。
+    // pn/dnは set_terminal_result / update_pn_dn と同じく、ノード種別によらず
+    // 「ルートムーブを打ったプレイヤー」視点で統一されている:
+    //   - pn = 0 → ルートムーブを打ったプレイヤーの勝ち → WIN
+    //   - dn = 0 → ルートムーブを打ったプレイヤーの負け → LOSE
     //
-    // NODE_OR（自分の手番）:
-    //   - pn = 0 → 自分が勝てる → WIN
-    //   - dn = 0 → 自分が勝てない → LOSE
+    // 修正: 旧実装はNODE_AND（ルートタスク）で結果を反転しており、
+    //       勝ちの手をLOSE、負けの手をWINと報告していた。
     //
-    // NODE_AND（相手の手番）:
-    //   - pn = 0 → 相手が全ての手で勝てる → LOSE
-    //   - dn = 0 → 相手の少なくとも1手で負ける → WIN
+    // 修正: 旧実装は pn >= INF を LOSE、dn >= INF を WIN、両方 INF を DRAW と推定していたが、
+    //       和の飽和（PN_INF で頭打ち）でも INF になるため証明にはならない。
+    //       証明目標に対する結果は pn = 0 / dn = 0 のみで決める。
     //
     Result result = RESULT_UNKNOWN;
     if (root->pn == 0) {
-        // 証明完了: ノードタイプに応じて結果を判定
-        result = (root->type == NODE_OR) ? RESULT_EXACT_WIN : RESULT_EXACT_LOSE;
+        result = RESULT_EXACT_WIN;
     } else if (root->dn == 0) {
-        // 反証完了: ノードタイプに応じて結果を判定
-        result = (root->type == NODE_OR) ? RESULT_EXACT_LOSE : RESULT_EXACT_WIN;
-    } else if (root->pn >= PN_INF) {
-        // pn >= INF: 証明不可能
-        if (root->dn >= DN_INF) {
-            // dn >= INF: 反証も不可能 → DRAW
-            result = RESULT_EXACT_DRAW;
-        } else {
-            // dn < INF: 反証可能 → LOSE (ノードタイプ考慮)
-            result = (root->type == NODE_OR) ? RESULT_EXACT_LOSE : RESULT_EXACT_WIN;
-        }
-    } else if (root->dn >= DN_INF) {
-        // dn >= INF && pn < INF: 反証不可能、証明可能 → WIN (ノードタイプ考慮)
-        result = (root->type == NODE_OR) ? RESULT_EXACT_WIN : RESULT_EXACT_LOSE;
+        result = RESULT_EXACT_LOSE;
     }
-    // 注: pn < INF && dn < INF なら UNKNOWN のまま（探索未完了）
+    // 注: それ以外は UNKNOWN のまま（探索未完了）
 
     // Store result in TT for other workers to find
-    tt_store(worker->global->tt, key, root->depth, root->pn, root->dn, result, root->eval_score);
+    tt_store(worker->global->tt, key, root->depth, worker->target,
+             root->pn, root->dn, result, root->eval_score, root->source);
 
     // Update global results for root tasks (LOCK-FREE)
     if (task->is_root_task) {
@@ -3715,9 +7568,7 @@ static bool process_task(Worker *worker, Task *task) {
                                'a' + (task->root_move % 8), 8 - (task->root_move / 8));
 
                         // 待機中のワーカーを起床（条件変数待機中の場合）
-                        if (worker->global->global_chunk_queue) {
-                            pthread_cond_broadcast(&worker->global->global_chunk_queue->cond);
-                        }
+                        chunk_queues_broadcast(worker->global);
                     }
                 }
 
@@ -3733,7 +7584,10 @@ static bool process_task(Worker *worker, Task *task) {
 
                     // Push back to LocalHeap for re-processing (no lock needed)
                     // TTに途中結果が保存されているので、再処理時にTTヒットで効率的
-                    local_heap_push(&worker->local_heap, &retry_task);
+                    if (!sched_requeue(worker, &retry_task)) {
+                        fprintf(stderr, "Warning: worker %d could not re-enqueue root move %c%d (all queues full)\n",
+                                worker->id, 'a' + (task->root_move % 8), 8 - (task->root_move / 8));
+                    }
 
                     if (DEBUG_CONFIG.verbose) {
                         debug_log("Worker %d: root task %c%d not proven (pn=%u, dn=%u), re-enqueued to LocalHeap\n",
@@ -3748,56 +7602,17 @@ static bool process_task(Worker *worker, Task *task) {
         // Subtask completed (atomic increment)
         __sync_fetch_and_add(&worker->global->subtasks_completed, 1);
 
-        // サブタスクの結果伝播ロジック:
+        // サブタスクの結果はTTにのみ伝播する。
         //
-        // 終端ノードのpn/dn設定が「ルートムーブを打ったプレイヤー視点」で統一されたため、
-        // サブタスクのresultも同じ視点で設定されている:
-        // - result == RESULT_EXACT_WIN: ルートムーブを打ったプレイヤーの勝ち
-        // - result == RESULT_EXACT_LOSE: ルートムーブを打ったプレイヤーの負け
-        //
-        // サブタスクがWINを返した場合、それはルートムーブ全体がWINであることを意味する。
-        // （サブタスクは部分木の探索であり、その部分木でWINが証明されれば、
-        //   その経路を通ることでルートムーブ全体がWINになる）
-
-        if (result == RESULT_EXACT_WIN || result == RESULT_EXACT_LOSE) {
-            int move_idx = -1;
-            for (int i = 0; i < worker->global->n_moves; i++) {
-                if (worker->global->move_list[i] == task->root_move) {
-                    move_idx = i;
-                    break;
-                }
-            }
-
-            if (move_idx >= 0) {
-                if (result == RESULT_EXACT_WIN) {
-                    Result expected = RESULT_UNKNOWN;
-                    if (__sync_bool_compare_and_swap(&worker->global->move_results[move_idx],
-                                                      expected, RESULT_EXACT_WIN)) {
-                        // 早期終了: WINが見つかった
-                        if (atomic_cas_bool(&worker->global->found_win, false, true)) {
-                            __atomic_store_n(&worker->global->winning_move, task->root_move, __ATOMIC_RELEASE);
-                            debug_log("Worker %d: subtask (gen=%d) found WIN for root move %c%d!\n",
-                                   worker->id, task->generation,
-                                   'a' + (task->root_move % 8), 8 - (task->root_move / 8));
-
-                            // 待機中のワーカーを起床（条件変数待機中の場合）
-                            if (worker->global->global_chunk_queue) {
-                                pthread_cond_broadcast(&worker->global->global_chunk_queue->cond);
-                            }
-                        }
-                    }
-                }
-                // LOSEの伝播はサブタスクからは行わない
-                // ルートムーブがLOSEになるには、ルートタスク自体が完全に探索されて
-                // 全ての経路で負けになる必要がある
-                // これはルートタスク完了時の結果判定で処理される
-            }
-        }
+        // 修正: 旧実装はサブタスクのWINをルートムーブのWINとして報告していたが、
+        // サブタスクの局面は途中のANDノード（相手の手番）の子でもあり得るため、
+        // 部分木の勝ちはルートムーブの勝ちを意味しない。ルートタスクは未証明なら
+        // 再キューされ、再探索時にこの局面をTTヒットで証明済みとして取り込む。
     }
 
     // Free children arrays, then reset memory pool for reuse
     free_dfpn_tree_children(root);
-    node_pool_reset(&worker->node_pool);
+    node_pool_reset_task(worker);
 
     if (DEBUG_CONFIG.track_work_stealing) {
         debug_log("Worker %d completed task: move=%c%d, result=%s, nodes=%llu\n",
@@ -3812,11 +7627,32 @@ static bool process_task(Worker *worker, Task *task) {
 }
 
 // Worker thread function with HYBRID work stealing (LocalHeap + GlobalChunk)
+// ワーカーが読む重みの複製を選ぶ（--eval-numa）
+// 起動時にアフィニティから選び、アフィニティが複数ノードにまたがるならタスクごとに今のCPUで選び直す
+static void eval_numa_select(Worker *worker, bool at_start) {
+    if (EVAL_NUMA_BYTES == 0) return;
+    int n;
+    if (at_start) {
+        n = eval_numa_index_of_affinity();
+        worker->eval_numa_pinned = (n >= 0);
+        if (n < 0) n = eval_numa_index_of_cpu(sched_getcpu());
+    } else {
+        if (worker->eval_numa_pinned) return;
+        n = eval_numa_index_of_cpu(sched_getcpu());
+    }
+    if (n < 0 || !EVAL_NUMA_REPLICA[n]) n = -1;
+    if (!at_start && n != worker->eval_numa_node) worker->eval_numa_switches++;
+    worker->eval_numa_node = n;
+    EVAL_WEIGHT_LOCAL = (n >= 0) ? EVAL_NUMA_REPLICA[n] : NULL;
+}
+
 static void* worker_thread(void *arg) {
     Worker *worker = (Worker*)arg;
     worker->nodes = 0;
     worker->tasks_processed = 0;
     worker->tasks_stolen = 0;
+    eval_numa_select(worker, true);
+    queue_domain_select(worker, true);
 
     if (DEBUG_CONFIG.track_threads && worker->stats) {
         worker->stats->thread_id = worker->id;
@@ -3844,6 +7680,7 @@ static void* worker_thread(void *arg) {
                 worker->is_busy = true;
                 worker_set_busy(&worker->global->worker_state, worker->id);
             }
+            worker->idle_backoff_us = 0;
 
             worker->tasks_stolen++;
 
@@ -3856,13 +7693,18 @@ static void* worker_thread(void *arg) {
             uint64_t nodes_before = worker->nodes;
             worker->nodes = 0;
 
+            eval_numa_select(worker, false);
+            queue_domain_select(worker, false);
             bool task_completed = process_task(worker, &task);
 
             // タスクが中断された場合（Globalの方が優先度が高い）
             // 中断されたタスクをLocalHeapに戻し、Globalからインポート
             if (!task_completed && !worker->global->shutdown && !worker->global->found_win) {
                 // 中断されたタスクをLocalHeapに戻す（後で再処理）
-                local_heap_push(&worker->local_heap, &task);
+                if (!sched_requeue(worker, &task)) {
+                    fprintf(stderr, "Warning: worker %d could not re-enqueue a task of root move %c%d (all queues full)\n",
+                            worker->id, 'a' + (task.root_move % 8), 8 - (task.root_move / 8));
+                }
 
                 // Globalからチャンクをインポート（最初のタスクをnew_taskに取得）
                 Task new_task;
@@ -3908,10 +7750,21 @@ static void* worker_thread(void *arg) {
             //   条件変数でGlobalChunkQueueにタスクが追加されるまで
             //   ブロッキング待機。タイムアウト付きでデッドロック防止
             // ────────────────────────────────────────────────────────────
-            int local_size = worker->local_heap.size;
-            GlobalChunkQueue *gq = worker->global->global_chunk_queue;
+            struct timespec idle_start, idle_end;
+            clock_gettime(CLOCK_MONOTONIC, &idle_start);
 
-            if (local_size == 0 && gq && gq->size == 0) {
+            int local_size = worker->local_heap.size;
+            GlobalChunkQueue *gq = chunk_queue_home(worker);
+
+            if (worker->global->deques) {
+                // --scheduler chaselev: 盗めなかった → 指数バックオフで待ってから盗み直す
+                // （GlobalChunkQueueの条件変数は使われないので待たない）
+                worker->idle_backoff_us = (worker->idle_backoff_us == 0) ? 50 : worker->idle_backoff_us * 2;
+                if (worker->idle_backoff_us > CHASELEV_IDLE_MAX_US) {
+                    worker->idle_backoff_us = CHASELEV_IDLE_MAX_US;
+                }
+                usleep(worker->idle_backoff_us);
+            } else if (local_size == 0 && gq && chunk_queues_empty(worker)) {
                 // 条件変数でタスク追加を待機（タイムアウト付き）
                 struct timespec timeout;
                 clock_gettime(CLOCK_REALTIME, &timeout);
@@ -3921,13 +7774,19 @@ static void* worker_thread(void *arg) {
                     timeout.tv_nsec -= 1000000000;
                 }
 
+                // hier: 待つのは自分のL3ドメインのキューの条件変数だけ。ソケット・全体のキューへの
+                // あふれはタイムアウトで拾う（L3が埋まっている＝同じドメインのワーカーは忙しい）
                 pthread_mutex_lock(&gq->mutex);
                 // 再度チェック（ロック取得中にタスクが追加された可能性）
-                if (gq->size == 0 && !worker->global->shutdown && !worker->global->found_win) {
+                if (chunk_queues_empty(worker) && !worker->global->shutdown && !worker->global->found_win) {
                     pthread_cond_timedwait(&gq->cond, &gq->mutex, &timeout);
                 }
                 pthread_mutex_unlock(&gq->mutex);
             }
+
+            clock_gettime(CLOCK_MONOTONIC, &idle_end);
+            worker->idle_ns += (uint64_t)(idle_end.tv_sec - idle_start.tv_sec) * 1000000000ULL +
+                               (uint64_t)(idle_end.tv_nsec - idle_start.tv_nsec);
         }
     }
 
@@ -3993,8 +7852,20 @@ static void* monitor_thread(void *arg) {
 // Main Solver with HYBRID Work Stealing
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
 
-Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
-                    double time_limit, int *best_move, bool use_evaluation) {
+// 1回の探索（証明目標1つ）の設定
+// --exact では並列しきい値ごとに1つずつ使い、同時に複数実行される
+typedef struct {
+    TranspositionTable *shared_tt;  // NULL = この探索専用のTTを作る
+    int score_target;               // 証明目標（石差 >= score_target か）
+    volatile bool *cancel;          // NULL以外: trueになったら探索を打ち切る
+    BenchmarkResult *bench;         // 統計の書き込み先
+} SolveRunConfig;
+
+static Result solve_endgame_run(uint64_t player, uint64_t opponent, int num_threads,
+                                double time_limit, int *best_move, bool use_evaluation,
+                                const SolveRunConfig *cfg) {
+    BenchmarkResult *bench = cfg->bench;
+
     // Initialize CPU feature detection for SIMD acceleration
     check_cpu_features();
 
@@ -4006,10 +7877,15 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     // 詳細は hash_position() 内のコメントを参照。
     // ────────────────────────────────────────────────────────────
     init_zobrist();
+    stability_init();  // 確定石の辺テーブル（同じく一度だけ）
 
     debug_log("\n=== Othello Endgame Solver (HYBRID LocalHeap+GlobalChunk Version) ===\n");
     debug_log("Threads: %d (fixed), Time limit: %.1fs\n", num_threads, time_limit);
     debug_log("Evaluation function: %s\n", use_evaluation ? "ENABLED" : "DISABLED");
+    if (use_evaluation) {
+        debug_log("Evaluation kernel: %s\n", eval_kernel_name(EVAL_KERNEL));
+        debug_log("Evaluation weights: %s (%.3f ms)\n", EVAL_LOAD_SOURCE, EVAL_LOAD_MS);
+    }
     debug_log("SIMD acceleration: Move generation=Scalar, Board symmetry=%s\n",
               cpu_has_avx2 ? "AVX2" : "Scalar");
 
@@ -4018,7 +7894,8 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
 
     // Initialize global state
     GlobalState global = {0};
-    global.tt = tt_create(TT_SIZE_MB);
+    global.tt = cfg->shared_tt ? cfg->shared_tt : tt_create(TT_SIZE_MB);
+    global.score_target = cfg->score_target;
     global.time_limit = time_limit;
     global.use_evaluation = use_evaluation;
     global.found_win = false;
@@ -4029,6 +7906,15 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     // HYBRID: Initialize GlobalChunkQueue and SharedTaskArray
     global.global_chunk_queue = global_chunk_queue_create();
     global.shared_array = shared_array_create();
+    global.n_workers = num_threads;
+    if (TASK_SCHEDULER == SCHED_CHASELEV) {
+        global.deques = chaselev_array_create(num_threads);
+    }
+    if (QUEUE_LAYOUT == QUEUES_HIER) {
+        chunk_queues_hier_create(&global);
+    } else if (QUEUE_LAYOUT == QUEUES_MULTIQUEUE) {
+        global.mq = chunk_mq_create(MQ_C * num_threads);
+    }
 
     // HYBRID: Initialize WorkerState（ビットマップ方式）
     worker_state_init(&global.worker_state, num_threads);
@@ -4042,6 +7928,19 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
               LOCAL_HEAP_CAPACITY, CHUNK_SIZE, LOCAL_EXPORT_THRESHOLD);
     debug_log("HYBRID: GlobalChunkQueue=%d chunks, SharedArray=%d tasks\n",
               GLOBAL_QUEUE_CAPACITY, SHARED_ARRAY_SIZE);
+    if (global.deques) {
+        debug_log("Task scheduler: chaselev (deque=%d tasks/worker, idle backoff <= %d us)\n",
+                  CHASELEV_CAPACITY, CHASELEV_IDLE_MAX_US);
+    } else {
+        debug_log("Task scheduler: hybrid\n");
+    }
+    if (global.l3_queues) {
+        debug_log("Chunk queues: hier (%d L3 domains, %d sockets, spill L3>=%d, socket>=%d)\n",
+                  global.n_l3_queues, global.n_socket_queues, QUEUE_HIER_L3_SPILL, QUEUE_HIER_SOCKET_SPILL);
+    } else if (global.mq) {
+        debug_log("Chunk queues: multiqueue (%d sub-heaps = c %d x %d threads, %d chunks each, 2-choice pop)\n",
+                  global.mq->n_heaps, MQ_C, num_threads, MQ_HEAP_CAPACITY);
+    }
 
     // Dynamic task spawning settings (use global config variables)
     // For 40-core: use -G 5 -D 4 -S 6 command line options
@@ -4049,19 +7948,73 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     global.min_depth_for_spawn = SPAWN_MIN_DEPTH;
     global.spawn_threshold = -1000;     // Spawn children with priority > -1000
     global.spawn_limit = SPAWN_LIMIT_PER_NODE;
+    global.node_budget = NODE_BUDGET;
+    global.engine = SEARCH_ENGINE;
+    global.epsilon = DFPN_EPSILON;
+    global.pn_init = PNDN_INIT;
+    global.aggregation = PN_AGGREGATION;
+    global.agg_hybrid_min_empties = AGG_HYBRID_MIN_EMPTIES;
+    global.dpn_r = DPN_R;
+    global.stability = STABILITY_CUTOFF;
     global.subtasks_spawned = 0;
     global.subtasks_completed = 0;
 
     debug_log("Spawn settings: max_gen=%d, min_depth=%d, limit=%d\n",
               global.max_generation, global.min_depth_for_spawn, global.spawn_limit);
+    debug_log("df-pn engine: %s\n", global.engine == ENGINE_TT ? "tt (tree-less, TT-only)" : "tree");
+    debug_log("Leaf pn/dn init: %s\n", global.pn_init->name);
+    debug_log("Score target: disc difference >= %d (shared TT: %s)\n",
+              global.score_target, cfg->shared_tt ? "yes" : "no");
+    if (global.dpn_r >= 0) {
+        debug_log("Child selection: deep proof number (R=%.3f)%s\n", global.dpn_r,
+                  global.engine == ENGINE_TT ? " [ignored by tt engine]" : "");
+    }
+    if (global.aggregation == AGG_HYBRID) {
+        debug_log("pn/dn aggregation: hybrid (wpn at >= %d empties, classic below)\n",
+                  global.agg_hybrid_min_empties);
+    } else {
+        debug_log("pn/dn aggregation: %s\n", aggregation_name(global.aggregation));
+    }
+    if (DAG_PNDN) {
+        debug_log("DAG-aware sums: on (TT source markers)\n");
+    }
+    debug_log("Child ordering: %s%s\n", ordering_name(MOVE_ORDERING),
+              global.engine == ENGINE_TT ? " [tt engine uses generation order]" : "");
+    if (ordering_uses_eval() && ENDGAME_ORDER_EMPTIES > 0) {
+        debug_log("Endgame ordering: <= %d empties (fastest-first, parity, square class)\n", ENDGAME_ORDER_EMPTIES);
+    }
+    debug_log("Enhanced transposition cutoff: %s%s\n", ETC_ENABLED ? "on" : "off",
+              ETC_ENABLED && global.engine == ENGINE_TT ? " [tt engine always probes children]" : "");
+    debug_log("Incremental evaluation: %s\n", EVAL_INCREMENTAL ? "on" : "off");
+    debug_log("Batched evaluation: %s (width %d)\n", EVAL_BATCH ? "on" : "off", EVAL_BATCH_WIDTH);
+    debug_log("Lazy child evaluation: %s, min empties: %d\n", EVAL_LAZY ? "on" : "off", EVAL_MIN_EMPTIES);
+    debug_log("Evaluation hash: %s (%zu entries)\n", EVAL_HASH_TABLE ? "on" : "off", eval_hash_entries());
+    debug_log("NUMA weight replicas: %s\n", !EVAL_NUMA ? "off" : EVAL_NUMA_BYTES ? "on" : "on [single node, shared weights]");
+    if (global.epsilon >= 0) {
+        debug_log("Threshold: 1+epsilon (epsilon=%.3f)\n", global.epsilon);
+    } else {
+        debug_log("Threshold: legacy%s\n", global.engine == ENGINE_TT ? " (tt engine uses epsilon=0)" : "");
+    }
+    if (global.node_budget > 0) {
+        debug_log("Node budget: %llu nodes/worker (%.1f MB/worker)\n",
+                  (unsigned long long)global.node_budget,
+                  global.node_budget * sizeof(DFPNNode) / (1024.0 * 1024.0));
+    }
 
     uint64_t moves = get_moves(player, opponent);
     if (moves == 0) {
         // HYBRID: Cleanup hybrid resources
         global_chunk_queue_destroy(global.global_chunk_queue);
         shared_array_destroy(global.shared_array);
-        tt_free(global.tt);
+        chaselev_array_destroy(global.deques, num_threads);
+        chunk_queues_hier_destroy(&global);
+        chunk_mq_destroy(global.mq);
+        if (!cfg->shared_tt) tt_free(global.tt);
         pthread_mutex_destroy(&global.stats_mutex);
+        if (best_move) *best_move = -1;
+        bench->empties = empties;
+        snprintf(bench->result, sizeof(bench->result), "UNKNOWN");
+        snprintf(bench->best_move, sizeof(bench->best_move), "N/A");
         return RESULT_UNKNOWN;
     }
 
@@ -4089,6 +8042,10 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     uint64_t moves_copy = moves;
     int idx = 0;
 
+    // ルートの子の評価値（兄弟をまとめて評価、手の生成順）
+    int root_evals[MAX_CHILDREN] = {0};
+    if (use_evaluation) evaluate_children(player, opponent, moves, root_evals);
+
 #if ENABLE_EVAL_IMPACT
     // 評価スコアでソートして優先順位を決定（EvalImpact用）
     // 評価関数による手の順序を記録するため、事前にソート
@@ -4102,11 +8059,8 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     for (int i = 0; i < n_moves; i++) {
         int move = first_one(moves_temp);
         moves_temp &= moves_temp - 1;
-        uint64_t p = player;
-        uint64_t o = opponent;
-        make_move(&p, &o, move);
         sorted_moves[i].move = move;
-        sorted_moves[i].eval = use_evaluation ? -evaluate_position(p, o) : 0;
+        sorted_moves[i].eval = -root_evals[i];
         sorted_moves[i].original_idx = i;
     }
     // ソート（降順：評価が高い順）
@@ -4130,7 +8084,7 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
         uint64_t o = opponent;
         make_move(&p, &o, move);
 
-        int eval = use_evaluation ? -evaluate_position(p, o) : 0;
+        int eval = -root_evals[idx];
 
         global.move_list[idx] = move;
         global.move_evals[idx] = eval;
@@ -4163,7 +8117,8 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
             .is_root_task = true,
             .depth = empties - 1,   // After making move, one less empty
             .node_type = NODE_AND,  // Opponent's turn after our move
-            .generation = 0         // Root level
+            .generation = 0,        // Root level
+            .target = global.score_target
         };
 
         // SharedTaskArrayに投入（ロックフリー、高速）
@@ -4194,12 +8149,17 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     for (int i = 0; i < num_threads; i++) {
         workers[i].id = i;
         workers[i].global = &global;
+        workers[i].target = global.score_target;
         workers[i].is_busy = false;  // busy_workers追跡用
         workers[i].has_entered_chunk_mode = false;  // check_and_export最適化用
         workers[i].nodes_at_last_export_check = 0;
         if (thread_stats) workers[i].stats = &thread_stats[i];
         if (tree_stats) workers[i].tree_stats = &tree_stats[i];
         node_pool_init(&workers[i].node_pool);
+        workers[i].gc_next_trigger = global.node_budget;
+        memset(workers[i].killer, -1, sizeof(workers[i].killer));  // キラー手なし
+        workers[i].eval_numa_node = -1;
+        workers[i].steal_rng = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1);  // 0にならない種
         // HYBRID: Initialize LocalHeap for each worker
         local_heap_init(&workers[i].local_heap);
 
@@ -4228,6 +8188,13 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
 
     // Wait for all tasks to complete or early termination
     while (!global.shutdown && !global.found_win) {
+        // --exact: 他のしきい値の結果で答えが決まった
+        if (cfg->cancel && *cfg->cancel) {
+            debug_log("Search for target %d cancelled.\n", global.score_target);
+            global.shutdown = true;
+            break;
+        }
+
         // Check if all tasks are completed
         if (global.tasks_completed >= n_moves) {
             debug_log("All %d tasks completed.\n", n_moves);
@@ -4256,9 +8223,7 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     global.shutdown = true;
 
     // 待機中のワーカーを起床させる（条件変数待機中の場合）
-    if (global.global_chunk_queue) {
-        pthread_cond_broadcast(&global.global_chunk_queue->cond);
-    }
+    chunk_queues_broadcast(&global);
 
     // Wait for workers to finish
     for (int i = 0; i < num_threads; i++) {
@@ -4299,9 +8264,8 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
             }
         }
 
-        // Determine final result
+        // Determine final result（証明目標に対する二値: 石差 >= score_target か）
         // WIN: If any move leads to WIN
-        // DRAW: If no WIN but some move leads to DRAW
         // LOSE: Only if ALL moves are proven LOSE
         // UNKNOWN: Otherwise (incomplete search)
         for (int i = 0; i < n_moves; i++) {
@@ -4310,12 +8274,6 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
                 final_best_move = global.move_list[i];
                 break;
             }
-            if (global.move_results[i] == RESULT_EXACT_DRAW && final_result != RESULT_EXACT_WIN) {
-                final_result = RESULT_EXACT_DRAW;
-                if (final_best_move == -1) {
-                    final_best_move = global.move_list[i];
-                }
-            }
             if (global.move_evals[i] > best_eval) {
                 best_eval = global.move_evals[i];
                 if (final_result == RESULT_UNKNOWN) {
@@ -4324,7 +8282,7 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
             }
         }
 
-        // Only LOSE if all moves are proven LOSE (no UNKNOWN, no DRAW, no WIN)
+        // Only LOSE if all moves are proven LOSE (no UNKNOWN, no WIN)
         if (final_result == RESULT_UNKNOWN && lose_count == n_moves) {
             final_result = RESULT_EXACT_LOSE;
         }
@@ -4355,10 +8313,11 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     // Add worker statistics
     debug_log("\n=== Worker Statistics ===\n");
     for (int i = 0; i < num_threads; i++) {
-        debug_log("Worker %d: %llu nodes, %llu tasks\n",
+        debug_log("Worker %d: %llu nodes, %llu tasks, idle %.1f ms\n",
                i,
                (unsigned long long)workers[i].nodes,
-               (unsigned long long)workers[i].tasks_processed);
+               (unsigned long long)workers[i].tasks_processed,
+               workers[i].idle_ns / 1e6);
         total_nodes += workers[i].nodes;
     }
 
@@ -4399,12 +8358,242 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
     debug_log("GlobalChunkQueue: %llu chunks pushed, %llu chunks popped\n",
            (unsigned long long)(global.global_chunk_queue ? global.global_chunk_queue->chunks_pushed : 0),
            (unsigned long long)(global.global_chunk_queue ? global.global_chunk_queue->chunks_popped : 0));
+    // チャンクキューの段ごとのpush/pop数（flat は全体のキューだけ）
+    uint64_t queue_pushed[3] = {0, 0, 0};
+    uint64_t queue_pops[4] = {0, 0, 0, 0};
+    uint64_t mq_lock_fails = 0;
+    queue_pushed[QLEVEL_GLOBAL] = global.global_chunk_queue ? global.global_chunk_queue->chunks_pushed : 0;
+    for (int i = 0; global.mq && i < global.mq->n_heaps; i++) {
+        queue_pushed[QLEVEL_GLOBAL] += global.mq->heaps[i].chunks_pushed;
+    }
+    for (int i = 0; i < num_threads; i++) {
+        for (int l = 0; l < 4; l++) queue_pops[l] += workers[i].queue_pops[l];
+        mq_lock_fails += workers[i].mq_lock_fails;
+    }
+    if (global.mq) {
+        debug_log("Chunk queues (multiqueue): %llu pushed, %llu popped, %llu try-lock failures\n",
+                  (unsigned long long)queue_pushed[QLEVEL_GLOBAL],
+                  (unsigned long long)queue_pops[QLEVEL_GLOBAL],
+                  (unsigned long long)mq_lock_fails);
+    }
+    if (global.l3_queues) {
+        for (int d = 0; d < global.n_l3_queues; d++) queue_pushed[QLEVEL_L3] += global.l3_queues[d]->chunks_pushed;
+        for (int s = 0; s < global.n_socket_queues; s++) {
+            queue_pushed[QLEVEL_SOCKET] += global.socket_queues[s]->chunks_pushed;
+        }
+        debug_log("Chunk queues (hier): pushed L3=%llu socket=%llu global=%llu\n",
+                  (unsigned long long)queue_pushed[QLEVEL_L3],
+                  (unsigned long long)queue_pushed[QLEVEL_SOCKET],
+                  (unsigned long long)queue_pushed[QLEVEL_GLOBAL]);
+        debug_log("Chunk queues (hier): popped L3=%llu socket=%llu global=%llu other-L3=%llu\n",
+                  (unsigned long long)queue_pops[QLEVEL_L3],
+                  (unsigned long long)queue_pops[QLEVEL_SOCKET],
+                  (unsigned long long)queue_pops[QLEVEL_GLOBAL],
+                  (unsigned long long)queue_pops[QLEVEL_REMOTE_L3]);
+    }
     debug_log("Export/Import: %llu exported, %llu imported\n",
            (unsigned long long)total_exported,
            (unsigned long long)total_imported);
     debug_log("Global switches (TT-hit triggered): %llu\n",
            (unsigned long long)global.global_switches);
 
+    // Chase-Lev work stealing statistics (--scheduler chaselev)
+    uint64_t total_deque_pushes = 0, total_deque_pops = 0;
+    uint64_t total_steal_attempts = 0, total_steals = 0, total_steal_aborts = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (global.deques) {
+            total_deque_pushes += global.deques[i].pushes;
+            total_deque_pops += global.deques[i].pops;
+        }
+        total_steal_attempts += workers[i].steal_attempts;
+        total_steals += workers[i].steals;
+        total_steal_aborts += workers[i].steal_aborts;
+    }
+    if (global.deques) {
+        debug_log("\n=== Chase-Lev Statistics ===\n");
+        debug_log("Deque: %llu pushes, %llu pops (owner)\n",
+                  (unsigned long long)total_deque_pushes,
+                  (unsigned long long)total_deque_pops);
+        debug_log("Steal success: %llu\n", (unsigned long long)total_steals);
+        debug_log("Steal fail: %llu (lost CAS race)\n", (unsigned long long)total_steal_aborts);
+        debug_log("Steal attempts: %llu (%.1f%% success)\n",
+                  (unsigned long long)total_steal_attempts,
+                  total_steal_attempts ? 100.0 * total_steals / total_steal_attempts : 0.0);
+    }
+
+    // Node memory statistics (bounded-memory df-pn)
+    uint64_t peak_live_nodes = 0, total_gc_runs = 0, total_gc_freed = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (workers[i].node_pool.peak_live_nodes > peak_live_nodes) {
+            peak_live_nodes = workers[i].node_pool.peak_live_nodes;
+        }
+        // 木を持たないエンジンではスタック上の子ノード数が生存ノード数に相当
+        if (workers[i].peak_path_nodes > peak_live_nodes) {
+            peak_live_nodes = workers[i].peak_path_nodes;
+        }
+        total_gc_runs += workers[i].gc_runs;
+        total_gc_freed += workers[i].gc_nodes_freed;
+    }
+    debug_log("\n=== Node Memory Statistics ===\n");
+    debug_log("Budget: %llu nodes/worker%s\n", (unsigned long long)global.node_budget,
+              global.node_budget > 0 ? "" : " (unlimited)");
+    debug_log("Peak live nodes (max over workers): %llu (%.1f MB)\n",
+              (unsigned long long)peak_live_nodes,
+              peak_live_nodes * sizeof(DFPNNode) / (1024.0 * 1024.0));
+    debug_log("GC runs: %llu, nodes freed: %llu\n",
+              (unsigned long long)total_gc_runs, (unsigned long long)total_gc_freed);
+
+    // Threshold statistics (1+ε threshold)
+    uint64_t total_switches = 0, max_node_switches = 0, total_reexpansions = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_switches += workers[i].sibling_switches;
+        total_reexpansions += workers[i].reexpansions;
+        if (workers[i].max_node_switches > max_node_switches) {
+            max_node_switches = workers[i].max_node_switches;
+        }
+    }
+    debug_log("\n=== Threshold Statistics ===\n");
+    debug_log("Epsilon: %.3f%s\n", global.epsilon, global.epsilon >= 0 ? "" : " (legacy)");
+    debug_log("Sibling switches: %llu (max per node: %llu)\n",
+              (unsigned long long)total_switches, (unsigned long long)max_node_switches);
+    debug_log("Re-expansions: %llu\n", (unsigned long long)total_reexpansions);
+
+    // Child ordering statistics
+    uint64_t total_ordering_cutoffs = 0, total_ordering_first = 0, total_history_updates = 0;
+    uint64_t total_endgame_order = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_ordering_cutoffs += workers[i].ordering_cutoffs;
+        total_ordering_first += workers[i].ordering_first_cutoffs;
+        total_history_updates += workers[i].history_updates;
+        total_endgame_order += workers[i].endgame_order_expansions;
+    }
+    debug_log("\n=== Child Ordering ===\n");
+    debug_log("Mode: %s\n", ordering_name(MOVE_ORDERING));
+    debug_log("Proving children: %llu, first-ordered: %llu (%.2f%%)\n",
+              (unsigned long long)total_ordering_cutoffs, (unsigned long long)total_ordering_first,
+              total_ordering_cutoffs ? 100.0 * total_ordering_first / total_ordering_cutoffs : 0.0);
+    debug_log("History updates: %llu\n", (unsigned long long)total_history_updates);
+    debug_log("Endgame-ordered expansions: %llu (<= %d empties)\n",
+              (unsigned long long)total_endgame_order, ENDGAME_ORDER_EMPTIES);
+
+    // Enhanced transposition cutoff statistics
+    uint64_t total_etc_probes = 0, total_etc_hits = 0, total_etc_cutoffs = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_etc_probes += workers[i].etc_probes;
+        total_etc_hits += workers[i].etc_hits;
+        total_etc_cutoffs += workers[i].etc_cutoffs;
+    }
+    debug_log("\n=== Enhanced Transposition Cutoff ===\n");
+    debug_log("Enabled: %s\n", ETC_ENABLED ? "yes" : "no");
+    debug_log("Child probes: %llu, hits: %llu (%.2f%%)\n",
+              (unsigned long long)total_etc_probes, (unsigned long long)total_etc_hits,
+              total_etc_probes ? 100.0 * total_etc_hits / total_etc_probes : 0.0);
+    debug_log("Cutoffs (parent proven at expansion): %llu\n", (unsigned long long)total_etc_cutoffs);
+
+    // Incremental evaluation statistics
+    uint64_t total_eval_incremental = 0, total_eval_rebuilds = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_eval_incremental += workers[i].eval_incremental_evals;
+        total_eval_rebuilds += workers[i].eval_feature_rebuilds;
+    }
+    debug_log("\n=== Incremental Evaluation ===\n");
+    debug_log("Enabled: %s\n", EVAL_INCREMENTAL ? "yes" : "no");
+    debug_log("Incremental child evals: %llu, feature rebuilds: %llu\n",
+              (unsigned long long)total_eval_incremental, (unsigned long long)total_eval_rebuilds);
+
+    // Batched evaluation statistics
+    uint64_t total_eval_batches = 0, total_eval_batched = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_eval_batches += workers[i].eval_batches;
+        total_eval_batched += workers[i].eval_batched_children;
+    }
+    debug_log("\n=== Batched Evaluation ===\n");
+    debug_log("Enabled: %s (width %d)\n", EVAL_BATCH ? "yes" : "no", EVAL_BATCH_WIDTH);
+    debug_log("Batches: %llu, children: %llu (avg %.2f per batch)\n",
+              (unsigned long long)total_eval_batches, (unsigned long long)total_eval_batched,
+              total_eval_batches ? (double)total_eval_batched / total_eval_batches : 0.0);
+
+    // Lazy / gated evaluation statistics
+    uint64_t total_child_evals = 0, total_lazy_deferred = 0, total_lazy_resolved = 0, total_eval_gated = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_child_evals += workers[i].eval_child_evals;
+        total_lazy_deferred += workers[i].eval_lazy_deferred;
+        total_lazy_resolved += workers[i].eval_lazy_resolved;
+        total_eval_gated += workers[i].eval_gated;
+    }
+    debug_log("\n=== Lazy / Gated Evaluation ===\n");
+    debug_log("Lazy: %s, min empties: %d\n", EVAL_LAZY ? "yes" : "no", EVAL_MIN_EMPTIES);
+    debug_log("Evaluated children: %llu, deferred: %llu, resolved on revisit: %llu, gated: %llu\n",
+              (unsigned long long)total_child_evals, (unsigned long long)total_lazy_deferred,
+              (unsigned long long)total_lazy_resolved, (unsigned long long)total_eval_gated);
+
+    // Evaluation hash statistics
+    uint64_t total_eval_hash_probes = 0, total_eval_hash_hits = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_eval_hash_probes += workers[i].eval_hash_probes;
+        total_eval_hash_hits += workers[i].eval_hash_hits;
+    }
+    debug_log("\n=== Evaluation Hash ===\n");
+    debug_log("Entries: %zu (%d MB)\n", eval_hash_entries(), EVAL_HASH_TABLE ? EVAL_HASH_MB : 0);
+    debug_log("Probes: %llu, hits: %llu (%.2f%%)\n",
+              (unsigned long long)total_eval_hash_probes, (unsigned long long)total_eval_hash_hits,
+              total_eval_hash_probes ? 100.0 * total_eval_hash_hits / total_eval_hash_probes : 0.0);
+
+    // NUMA replica statistics
+    int numa_nodes = (EVAL_NUMA_BYTES > 0) ? EVAL_NUMA_N_NODES : 0;
+    int numa_workers[EVAL_NUMA_MAX_NODES] = {0};
+    uint64_t total_numa_switches = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (workers[i].eval_numa_node >= 0) numa_workers[workers[i].eval_numa_node]++;
+        total_numa_switches += workers[i].eval_numa_switches;
+    }
+    if (numa_nodes > 0) {
+        debug_log("\n=== NUMA Weight Replicas ===\n");
+        for (int n = 0; n < numa_nodes; n++) {
+            debug_log("Node %d: %d workers (at finish)\n", EVAL_NUMA_NODE_ID[n], numa_workers[n]);
+        }
+        debug_log("Replica switches (worker moved to another node): %llu\n",
+                  (unsigned long long)total_numa_switches);
+    }
+
+    // DAG-aware sum statistics
+    uint64_t total_dag_transpositions = 0, total_dag_corrections = 0;
+    for (int i = 0; i < num_threads; i++) {
+        total_dag_transpositions += workers[i].dag_transpositions;
+        total_dag_corrections += workers[i].dag_corrections;
+    }
+    debug_log("\n=== DAG-aware Sums ===\n");
+    debug_log("Enabled: %s\n", DAG_PNDN ? "yes" : "no");
+    debug_log("Transpositions (foreign source): %llu\n", (unsigned long long)total_dag_transpositions);
+    debug_log("Corrected pn/dn updates: %llu (%.4f per node)\n",
+              (unsigned long long)total_dag_corrections,
+              total_nodes ? (double)total_dag_corrections / total_nodes : 0.0);
+
+    // Stable-disc cutoff statistics
+    uint64_t stability_nodes[65] = {0}, stability_cuts[65] = {0};
+    uint64_t total_stability_nodes = 0, total_stability_cuts = 0;
+    for (int i = 0; i < num_threads; i++) {
+        for (int e = 0; e <= 64; e++) {
+            stability_nodes[e] += workers[i].stability_nodes[e];
+            stability_cuts[e] += workers[i].stability_cuts[e];
+        }
+    }
+    for (int e = 0; e <= 64; e++) {
+        total_stability_nodes += stability_nodes[e];
+        total_stability_cuts += stability_cuts[e];
+    }
+    debug_log("\n=== Stable-disc Cutoffs ===\n");
+    debug_log("Enabled: %s (min empties %d)\n", global.stability ? "yes" : "no", STABILITY_MIN_EMPTIES);
+    debug_log("Cutoffs: %llu / %llu expansions (%.2f%%)\n",
+              (unsigned long long)total_stability_cuts, (unsigned long long)total_stability_nodes,
+              total_stability_nodes ? 100.0 * total_stability_cuts / total_stability_nodes : 0.0);
+    for (int e = 0; e <= 64; e++) {
+        if (stability_nodes[e] == 0) continue;
+        debug_log("  empties %2d: %llu / %llu (%.2f%%)\n", e,
+                  (unsigned long long)stability_cuts[e], (unsigned long long)stability_nodes[e],
+                  100.0 * stability_cuts[e] / stability_nodes[e]);
+    }
+
 #if ENABLE_EVAL_IMPACT
     // EvalImpact統計出力 (-e option)
     if (DEBUG_CONFIG.track_eval_impact && global.eval_impacts) {
@@ -4482,122 +8671,1119 @@ Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
             debug_log("勝利手は評価関数で最高評価だったか: %s\n",
                    win_by_top_eval ? "YES（評価関数が正しく予測）" : "NO（評価関数が外れた）");
         }
-        debug_log("証明に要した総ノード数: %llu\n", (unsigned long long)total_nodes_proven);
-        debug_log("証明に要した総時間: %.3fs\n", total_time_proven);
+        debug_log("証明に要した総ノード数: %llu\n", (unsigned long long)total_nodes_proven);
+        debug_log("証明に要した総時間: %.3fs\n", total_time_proven);
+    }
+#endif // ENABLE_EVAL_IMPACT
+
+#if ENABLE_GLOBAL_CHECK_BENCHMARK
+    // Global比較ベンチマーク統計（スレッドごと）
+    debug_log("\n=== Global Check Benchmark (per-thread) ===\n");
+    debug_log("Thread | Checks | GlobalBetter | AvgInterval | MinInterval | MaxInterval\n");
+    debug_log("-------|--------|--------------|-------------|-------------|------------\n");
+
+    uint64_t total_checks = 0;
+    uint64_t total_true = 0;
+
+    for (int i = 0; i < num_threads; i++) {
+        uint64_t checks = workers[i].global_check_count;
+        uint64_t true_count = workers[i].global_check_true_count;
+        uint64_t interval_sum = workers[i].check_interval_sum;
+        uint64_t interval_min = workers[i].check_interval_min;
+        uint64_t interval_max = workers[i].check_interval_max;
+
+        double avg_interval = (checks > 1) ? (double)interval_sum / (checks - 1) : 0;
+
+        debug_log("   %2d  | %6llu | %12llu | %11.1f | %11llu | %11llu\n",
+               i,
+               (unsigned long long)checks,
+               (unsigned long long)true_count,
+               avg_interval,
+               (unsigned long long)interval_min,
+               (unsigned long long)interval_max);
+
+        total_checks += checks;
+        total_true += true_count;
+    }
+
+    debug_log("-------|--------|--------------|-------------|-------------|------------\n");
+    debug_log(" Total | %6llu | %12llu |             |             |\n",
+           (unsigned long long)total_checks,
+           (unsigned long long)total_true);
+
+    if (total_checks > 0) {
+        debug_log("\nGlobal比較でGlobalが良かった割合: %.2f%%\n",
+               100.0 * total_true / total_checks);
+        debug_log("平均: %.1f ノードごとに1回Global比較\n",
+               (double)total_nodes / total_checks);
+    }
+#endif
+
+    debug_log("\n=== Result Summary ===\n");
+    debug_log("WIN: %d, LOSE: %d, DRAW: %d, UNKNOWN: %d\n",
+           win_count, lose_count, draw_count, unknown_count);
+    debug_log("Final result: %s\n",
+           final_result == RESULT_EXACT_WIN ? "WIN" :
+           (final_result == RESULT_EXACT_LOSE ? "LOSE" :
+           (final_result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")));
+
+    if (best_move) *best_move = final_best_move;
+
+    // Populate benchmark result for CSV/JSON output
+    bench->empties = empties;
+    bench->legal_moves = n_moves;
+    strncpy(bench->result,
+            final_result == RESULT_EXACT_WIN ? "WIN" :
+            (final_result == RESULT_EXACT_LOSE ? "LOSE" :
+            (final_result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")),
+            sizeof(bench->result) - 1);
+    if (final_best_move >= 0 && final_best_move < 64) {
+        snprintf(bench->best_move, sizeof(bench->best_move),
+                 "%c%d", 'a' + (final_best_move % 8), 8 - (final_best_move / 8));
+    } else {
+        strncpy(bench->best_move, "N/A", sizeof(bench->best_move) - 1);
+    }
+    bench->total_nodes = total_nodes;
+    bench->time_sec = elapsed;
+    bench->nps = (total_nodes > 0 && elapsed > 0) ? total_nodes / elapsed : 0;
+    bench->tt_hits = global.tt->hits;
+    bench->tt_stores = global.tt->stores;
+    bench->tt_collisions = global.tt->collisions;
+    bench->tt_hit_rate = 100.0 * global.tt->hits / (global.tt->hits + global.tt->stores + 1);
+    bench->subtasks_spawned = global.subtasks_spawned;
+    bench->subtasks_completed = global.subtasks_completed;
+    snprintf(bench->scheduler, sizeof(bench->scheduler), "%s", scheduler_name(TASK_SCHEDULER));
+    bench->deque_pushes = total_deque_pushes;
+    bench->deque_pops = total_deque_pops;
+    bench->steal_attempts = total_steal_attempts;
+    bench->steals = total_steals;
+    bench->steal_aborts = total_steal_aborts;
+    snprintf(bench->queue_layout, sizeof(bench->queue_layout), "%s",
+             queue_layout_name(global.mq ? QUEUES_MULTIQUEUE : global.l3_queues ? QUEUES_HIER : QUEUES_FLAT));
+    bench->queue_l3_domains = global.n_l3_queues;
+    bench->queue_sockets = global.n_socket_queues;
+    bench->queue_l3_pushed = queue_pushed[QLEVEL_L3];
+    bench->queue_socket_pushed = queue_pushed[QLEVEL_SOCKET];
+    bench->queue_global_pushed = queue_pushed[QLEVEL_GLOBAL];
+    bench->queue_l3_popped = queue_pops[QLEVEL_L3];
+    bench->queue_socket_popped = queue_pops[QLEVEL_SOCKET];
+    bench->queue_global_popped = queue_pops[QLEVEL_GLOBAL];
+    bench->queue_remote_l3_popped = queue_pops[QLEVEL_REMOTE_L3];
+    bench->queue_mq_heaps = global.mq ? global.mq->n_heaps : 0;
+    bench->queue_mq_lock_fails = mq_lock_fails;
+    bench->win_count = win_count;
+    bench->lose_count = lose_count;
+    bench->draw_count = draw_count;
+    bench->unknown_count = unknown_count;
+    snprintf(bench->engine, sizeof(bench->engine), "%s",
+             global.engine == ENGINE_TT ? "tt" : "tree");
+    bench->node_bytes = sizeof(DFPNNode);
+    bench->node_budget = global.node_budget;
+    bench->peak_live_nodes = peak_live_nodes;
+    bench->gc_runs = total_gc_runs;
+    bench->gc_nodes_freed = total_gc_freed;
+    bench->epsilon = global.epsilon;
+    bench->sibling_switches = total_switches;
+    bench->max_node_switches = max_node_switches;
+    bench->reexpansions = total_reexpansions;
+    snprintf(bench->ordering, sizeof(bench->ordering), "%s", ordering_name(MOVE_ORDERING));
+    bench->ordering_cutoffs = total_ordering_cutoffs;
+    bench->ordering_first_cutoffs = total_ordering_first;
+    bench->history_updates = total_history_updates;
+    bench->endgame_order_empties = ENDGAME_ORDER_EMPTIES;
+    bench->endgame_order_expansions = total_endgame_order;
+    bench->etc = ETC_ENABLED;
+    bench->etc_probes = total_etc_probes;
+    bench->etc_hits = total_etc_hits;
+    bench->etc_cutoffs = total_etc_cutoffs;
+    bench->eval_incremental = EVAL_INCREMENTAL;
+    bench->eval_incremental_evals = total_eval_incremental;
+    bench->eval_feature_rebuilds = total_eval_rebuilds;
+    bench->eval_batch = EVAL_BATCH;
+    bench->eval_batches = total_eval_batches;
+    bench->eval_batched_children = total_eval_batched;
+    bench->eval_hash_mb = EVAL_HASH_TABLE ? EVAL_HASH_MB : 0;
+    bench->eval_hash_entries = eval_hash_entries();
+    bench->eval_hash_probes = total_eval_hash_probes;
+    bench->eval_hash_hits = total_eval_hash_hits;
+    bench->eval_lazy = EVAL_LAZY;
+    bench->eval_min_empties = EVAL_MIN_EMPTIES;
+    bench->eval_child_evals = total_child_evals;
+    bench->eval_lazy_deferred = total_lazy_deferred;
+    bench->eval_lazy_resolved = total_lazy_resolved;
+    bench->eval_gated = total_eval_gated;
+    bench->eval_numa = EVAL_NUMA;
+    bench->eval_numa_nodes = numa_nodes;
+    memcpy(bench->eval_numa_workers, numa_workers, sizeof(numa_workers));
+    bench->eval_numa_switches = total_numa_switches;
+    bench->dag = DAG_PNDN;
+    bench->dag_transpositions = total_dag_transpositions;
+    bench->dag_corrections = total_dag_corrections;
+    bench->stability = global.stability;
+    memcpy(bench->stability_nodes, stability_nodes, sizeof(stability_nodes));
+    memcpy(bench->stability_cuts, stability_cuts, sizeof(stability_cuts));
+    snprintf(bench->pn_init, sizeof(bench->pn_init), "%s", global.pn_init->name);
+    snprintf(bench->eval_kernel, sizeof(bench->eval_kernel), "%s",
+             use_evaluation ? eval_kernel_name(EVAL_KERNEL) : "none");
+    snprintf(bench->eval_load_source, sizeof(bench->eval_load_source), "%s",
+             use_evaluation ? EVAL_LOAD_SOURCE : "none");
+    bench->eval_load_ms = use_evaluation ? EVAL_LOAD_MS : 0.0;
+    snprintf(bench->aggregation, sizeof(bench->aggregation), "%s",
+             aggregation_name(global.aggregation));
+    bench->agg_hybrid_min_empties = global.agg_hybrid_min_empties;
+    bench->dpn_r = global.dpn_r;
+
+    // Store per-worker statistics
+    for (int i = 0; i < num_threads && i < MAX_THREADS; i++) {
+        bench->worker_nodes[i] = workers[i].nodes;
+        bench->worker_tasks[i] = workers[i].tasks_processed;
+        bench->worker_idle_ms[i] = workers[i].idle_ns / 1e6;
+    }
+
+    // Cleanup
+    if (thread_stats) free(thread_stats);
+    if (tree_stats) free(tree_stats);
+#if ENABLE_EVAL_IMPACT
+    if (global.eval_impacts) free(global.eval_impacts);
+    if (global.move_start_times) free(global.move_start_times);
+#endif
+    free(global.move_results);
+    free(global.move_nodes);
+    free(global.move_list);
+    free(global.move_evals);
+    free(workers);
+    if (!cfg->shared_tt) tt_free(global.tt);
+    pthread_mutex_destroy(&global.stats_mutex);
+
+    // HYBRID: Cleanup hybrid resources
+    global_chunk_queue_destroy(global.global_chunk_queue);
+    shared_array_destroy(global.shared_array);
+    chaselev_array_destroy(global.deques, num_threads);
+    chunk_queues_hier_destroy(&global);
+    chunk_mq_destroy(global.mq);
+
+    return final_result;
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Principal variation and proof tree (--proof-dump)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 探索後の共有TTに残った証明済みの石差の範囲 [lower, upper] から、読み筋と証明木を取り出す。
+// 証明するのは「ルート局面の手番側の最終石差 >= target」が
+//   goal = true : 成り立つ → ORノード（手番側の手番）で1手、ANDノードで全手
+//   goal = false: 成り立たない → ANDノードで1手、ORノードで全手
+// 1手を選ぶ側は、TTの範囲で証明済みの子のうち手番側に最も良い子を選ぶ。
+// TTに残っていなければ（浅い局面は深い局面に置換されやすい）小さな逐次探索で証明する。
+// 全手側の読み筋は、範囲から見て手番側に最も良い子を辿る。
+//
+// 証明木ファイル（リトルエンディアン）:
+//   ProofFileHeader, 続いてセクションごとに ProofSectionHeader + ProofRecord × n_records
+//   レコードはDFS前順で、各レコードの直後に n_children 個の子の部分木が続く。
+//   同じ局面の2回目以降は PROOF_FLAG_REF（子は省略）。引き分けや --exact では
+//   「>= 下限」と「< 上限 + 1」の2セクションになる。
+
+#define PROOF_FILE_MAGIC 0x5450544fu    // "OTPT"
+#define PROOF_FILE_VERSION 1
+
+#define PROOF_FLAG_AND       0x01       // ルート局面の手番側の相手の手番
+#define PROOF_FLAG_TERMINAL  0x02       // 終局（score に石差）
+#define PROOF_FLAG_PASS      0x04       // 手番側に合法手が無い（子はパス後の局面1つ）
+#define PROOF_FLAG_LOCAL     0x08       // TTに無く逐次探索で証明した
+#define PROOF_FLAG_REF       0x10       // 既出の局面（子は省略）
+#define PROOF_FLAG_UNPROVEN  0x20       // 証明できなかった、またはレコード上限で打ち切り（子は省略）
+
+#define PROOF_MOVE_ROOT 255
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t player;        // ルート局面（手番側）
+    uint64_t opponent;
+    uint32_t n_sections;
+} ProofFileHeader;
+
+typedef struct __attribute__((packed)) {
+    int32_t target;
+    uint8_t goal;           // 1: 石差 >= target、0: 石差 < target
+    uint8_t complete;       // PROOF_FLAG_UNPROVEN のレコードが無い
+    uint16_t reserved;
+    uint64_t n_records;
+} ProofSectionHeader;
+
+typedef struct __attribute__((packed)) {
+    uint64_t player;        // 手番側
+    uint64_t opponent;
+    uint8_t flags;
+    int8_t score;           // 終局: ルート局面の手番側から見た石差
+    uint8_t n_children;
+    uint8_t move;           // 親からの手（0-63、パス = PV_PASS、ルート = PROOF_MOVE_ROOT）
+} ProofRecord;
+
+typedef struct {
+    int target;
+    bool goal;
+} ProofGoal;
+
+typedef struct {
+    TranspositionTable *tt;
+    int target;
+    uint64_t budget;        // 逐次探索の残りノード数
+} ProofContext;
+
+// 逐次探索で「石差 >= target か」を解く（TTの範囲で決まる局面はそこで止める）
+// 戻り値: 1 = はい、0 = いいえ、-1 = ノード上限
+static int proof_local_solve(ProofContext *ctx, uint64_t p, uint64_t o, bool or_node) {
+    int empties = popcount(~(p | o));
+    int lower, upper;
+    tt_probe_bounds(ctx->tt, hash_position(p, o), empties, &lower, &upper);
+    if (lower >= ctx->target) return 1;
+    if (upper < ctx->target) return 0;
+
+    if (ctx->budget == 0) return -1;
+    ctx->budget--;
+
+    uint64_t moves = get_moves(p, o);
+    if (moves == 0) {
+        if (get_moves(o, p) == 0) {
+            int score = get_final_score(p, o);
+            return ((or_node ? score : -score) >= ctx->target) ? 1 : 0;
+        }
+        return proof_local_solve(ctx, o, p, !or_node);
+    }
+
+    // ORノードは1つでも「はい」ならはい、ANDノードは1つでも「いいえ」ならいいえ
+    int decisive = or_node ? 1 : 0;
+    bool exhausted = false;
+    while (moves) {
+        int move = first_one(moves);
+        moves &= moves - 1;
+        uint64_t cp = p, co = o;
+        make_move(&cp, &co, move);
+        int r = proof_local_solve(ctx, cp, co, !or_node);
+        if (r == decisive) return decisive;
+        if (r < 0) exhausted = true;
+    }
+    return exhausted ? -1 : 1 - decisive;
+}
+
+// 読み筋・証明木で辿る子を選ぶ
+//   chooser: 目標を満たす子を1つ選ぶ（TTの範囲 → 無ければ逐次探索）
+//   それ以外: 範囲から手番側に最も良い子を選ぶ（目標は全ての子で成り立つ）
+// 戻り値: 手（見つからなければ -1）。*local: 逐次探索で証明したら true
+static int proof_pick_child(ProofContext *ctx, uint64_t p, uint64_t o, bool or_node,
+                            bool goal, bool chooser, int preferred, bool *local) {
+    uint64_t moves = get_moves(p, o);
+    int depth = popcount(~(p | o)) - 1;
+    int best_move = -1;
+    int best_pref = INT_MIN;
+    *local = false;
+
+    for (uint64_t m = moves; m; m &= m - 1) {
+        int move = first_one(m);
+        uint64_t cp = p, co = o;
+        make_move(&cp, &co, move);
+        int lower, upper;
+        tt_probe_bounds(ctx->tt, hash_position(cp, co), depth, &lower, &upper);
+
+        if (chooser) {
+            bool proven = goal ? (lower >= ctx->target) : (upper < ctx->target);
+            if (!proven) continue;
+            if (move == preferred) return move;
+        }
+        // 範囲の中点で比較（ORノードは大きい方、ANDノードは小さい方が手番側に良い）
+        int pref = or_node ? lower + upper : -(lower + upper);
+        if (pref > best_pref) {
+            best_pref = pref;
+            best_move = move;
+        }
+    }
+    if (best_move >= 0 || !chooser) return best_move;
+
+    // TTで証明済みの子が無い: 逐次探索で目標を満たす子を探す
+    for (uint64_t m = moves; m; m &= m - 1) {
+        int move = first_one(m);
+        uint64_t cp = p, co = o;
+        make_move(&cp, &co, move);
+        int r = proof_local_solve(ctx, cp, co, !or_node);
+        if (r >= 0 && (r == 1) == goal) {
+            *local = true;
+            return move;
+        }
+    }
+    return -1;
+}
+
+// 読み筋を取り出す（ルート局面から終局まで、または証明が辿れなくなるまで）
+static int extract_pv(ProofContext *ctx, uint64_t p, uint64_t o, bool goal, int first_move,
+                      int *pv, int max_len, bool *complete, int *final_score) {
+    bool or_node = true;
+    int len = 0;
+    *complete = false;
+
+    while (len < max_len) {
+        uint64_t moves = get_moves(p, o);
+        if (moves == 0) {
+            if (get_moves(o, p) == 0) {
+                int score = get_final_score(p, o);
+                *final_score = or_node ? score : -score;
+                *complete = true;
+                break;
+            }
+            pv[len++] = PV_PASS;
+            uint64_t tmp = p;
+            p = o;
+            o = tmp;
+            or_node = !or_node;
+            continue;
+        }
+
+        bool local;
+        int move = proof_pick_child(ctx, p, o, or_node, goal, or_node == goal,
+                                    len == 0 ? first_move : -1, &local);
+        if (move < 0) break;
+        pv[len++] = move;
+        make_move(&p, &o, move);
+        or_node = !or_node;
+    }
+    return len;
+}
+
+// 証明木の出力で既出の局面を判定する集合（オープンアドレス法、満杯に近づいたら倍に拡張）
+typedef struct {
+    uint64_t *keys;
+    size_t mask;
+    size_t count;
+} ProofVisited;
+
+static bool proof_visited_insert(ProofVisited *v, uint64_t key) {
+    if (key == 0) key = 1;  // 0 は空きスロット
+    if ((v->count + 1) * 2 > v->mask + 1) {
+        size_t new_size = (v->mask + 1) * 2;
+        uint64_t *new_keys = calloc(new_size, sizeof(uint64_t));
+        for (size_t i = 0; i <= v->mask; i++) {
+            if (!v->keys[i]) continue;
+            size_t j = v->keys[i] & (new_size - 1);
+            while (new_keys[j]) j = (j + 1) & (new_size - 1);
+            new_keys[j] = v->keys[i];
+        }
+        free(v->keys);
+        v->keys = new_keys;
+        v->mask = new_size - 1;
+    }
+    size_t i = key & v->mask;
+    while (v->keys[i]) {
+        if (v->keys[i] == key) return false;
+        i = (i + 1) & v->mask;
+    }
+    v->keys[i] = key;
+    v->count++;
+    return true;
+}
+
+typedef struct {
+    ProofContext ctx;
+    FILE *f;
+    ProofVisited visited;
+    uint64_t n_records;
+    uint64_t n_unproven;
+} ProofDump;
+
+static void proof_dump_write_record(ProofDump *d, const ProofRecord *rec) {
+    fwrite(rec, sizeof(*rec), 1, d->f);
+    d->n_records++;
+    if (rec->flags & PROOF_FLAG_UNPROVEN) d->n_unproven++;
+}
+
+static void proof_dump_node(ProofDump *d, uint64_t p, uint64_t o, bool or_node, bool goal,
+                            int move, uint8_t extra_flags) {
+    ProofRecord rec = {
+        .player = p,
+        .opponent = o,
+        .flags = (uint8_t)((or_node ? 0 : PROOF_FLAG_AND) | extra_flags),
+        .score = 0,
+        .n_children = 0,
+        .move = (uint8_t)move
+    };
+
+    if (d->n_records >= PROOF_DUMP_MAX_RECORDS) {
+        rec.flags |= PROOF_FLAG_UNPROVEN;
+        proof_dump_write_record(d, &rec);
+        return;
+    }
+    if (!proof_visited_insert(&d->visited, hash_position(p, o))) {
+        rec.flags |= PROOF_FLAG_REF;
+        proof_dump_write_record(d, &rec);
+        return;
+    }
+
+    uint64_t moves = get_moves(p, o);
+    if (moves == 0) {
+        if (get_moves(o, p) == 0) {
+            int score = get_final_score(p, o);
+            rec.flags |= PROOF_FLAG_TERMINAL;
+            rec.score = (int8_t)(or_node ? score : -score);
+            proof_dump_write_record(d, &rec);
+            return;
+        }
+        rec.flags |= PROOF_FLAG_PASS;
+        rec.n_children = 1;
+        proof_dump_write_record(d, &rec);
+        proof_dump_node(d, o, p, !or_node, goal, PV_PASS, 0);
+        return;
+    }
+
+    if (or_node == goal) {
+        bool local;
+        int child_move = proof_pick_child(&d->ctx, p, o, or_node, goal, true, -1, &local);
+        if (child_move < 0) {
+            rec.flags |= PROOF_FLAG_UNPROVEN;
+            proof_dump_write_record(d, &rec);
+            return;
+        }
+        rec.n_children = 1;
+        proof_dump_write_record(d, &rec);
+        uint64_t cp = p, co = o;
+        make_move(&cp, &co, child_move);
+        proof_dump_node(d, cp, co, !or_node, goal, child_move, local ? PROOF_FLAG_LOCAL : 0);
+    } else {
+        rec.n_children = (uint8_t)popcount(moves);
+        proof_dump_write_record(d, &rec);
+        while (moves) {
+            int child_move = first_one(moves);
+            moves &= moves - 1;
+            uint64_t cp = p, co = o;
+            make_move(&cp, &co, child_move);
+            proof_dump_node(d, cp, co, !or_node, goal, child_move, 0);
+        }
+    }
+}
+
+// 証明木をファイルに書く。戻り値: 成功なら true
+static bool proof_dump_write(const char *filename, TranspositionTable *tt, uint64_t player,
+                             uint64_t opponent, const ProofGoal *goals, int n_goals,
+                             uint64_t *records, uint64_t *unproven) {
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        fprintf(stderr, "Error: cannot open proof dump file %s\n", filename);
+        return false;
+    }
+
+    ProofFileHeader header = {
+        .magic = PROOF_FILE_MAGIC,
+        .version = PROOF_FILE_VERSION,
+        .player = player,
+        .opponent = opponent,
+        .n_sections = (uint32_t)n_goals
+    };
+    fwrite(&header, sizeof(header), 1, f);
+
+    ProofDump d = {
+        .ctx = { .tt = tt, .budget = PROOF_DUMP_LOCAL_NODE_LIMIT },
+        .f = f
+    };
+    d.visited.mask = 4095;
+    d.visited.keys = calloc(d.visited.mask + 1, sizeof(uint64_t));
+
+    *records = 0;
+    *unproven = 0;
+    for (int i = 0; i < n_goals; i++) {
+        ProofSectionHeader section = {
+            .target = goals[i].target,
+            .goal = goals[i].goal ? 1 : 0
+        };
+        long section_pos = ftell(f);
+        fwrite(&section, sizeof(section), 1, f);
+
+        d.ctx.target = goals[i].target;
+        d.n_records = 0;
+        d.n_unproven = 0;
+        memset(d.visited.keys, 0, (d.visited.mask + 1) * sizeof(uint64_t));
+        d.visited.count = 0;
+        proof_dump_node(&d, player, opponent, true, goals[i].goal, PROOF_MOVE_ROOT, 0);
+
+        // レコード数が確定したのでセクションヘッダーを書き直す
+        section.n_records = d.n_records;
+        section.complete = (d.n_unproven == 0) ? 1 : 0;
+        long end_pos = ftell(f);
+        fseek(f, section_pos, SEEK_SET);
+        fwrite(&section, sizeof(section), 1, f);
+        fseek(f, end_pos, SEEK_SET);
+
+        debug_log("Proof tree: score %s %d, %llu records, %llu unproven\n",
+                  goals[i].goal ? ">=" : "<", goals[i].target,
+                  (unsigned long long)d.n_records, (unsigned long long)d.n_unproven);
+        *records += d.n_records;
+        *unproven += d.n_unproven;
+    }
+
+    free(d.visited.keys);
+    fclose(f);
+    return true;
+}
+
+// 結果確定後に読み筋を取り出し、--proof-dump 指定時は証明木を書き出す
+// goals[0] の証明から読み筋を取り出す（引き分け・--exact では「>= 下限」の側）
+static void report_pv_and_proof(TranspositionTable *tt, uint64_t player, uint64_t opponent,
+                                const ProofGoal *goals, int n_goals, int best_move) {
+    BenchmarkResult *bench = &g_benchmark_result;
+    if (n_goals == 0) return;
+
+    struct timespec start_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    ProofContext ctx = { .tt = tt, .target = goals[0].target, .budget = PV_LOCAL_NODE_LIMIT };
+    bench->pv_target = goals[0].target;
+    bench->pv_goal = goals[0].goal;
+    bench->pv_len = extract_pv(&ctx, player, opponent, goals[0].goal, best_move,
+                               bench->pv, MAX_PV_LENGTH, &bench->pv_complete, &bench->pv_final_score);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    bench->pv_time_sec = (end_time.tv_sec - start_time.tv_sec) +
+                         (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+
+    char pv_str[MAX_PV_LENGTH * 5 + 1];
+    format_pv(pv_str, sizeof(pv_str), bench->pv, bench->pv_len);
+    debug_log("PV (score %s %d): %s%s (%.3fs, %llu local nodes)\n",
+              goals[0].goal ? ">=" : "<", goals[0].target, pv_str,
+              bench->pv_complete ? "" : " [incomplete]", bench->pv_time_sec,
+              (unsigned long long)(PV_LOCAL_NODE_LIMIT - ctx.budget));
+
+    if (PROOF_DUMP_FILE) {
+        if (proof_dump_write(PROOF_DUMP_FILE, tt, player, opponent, goals, n_goals,
+                             &bench->proof_records, &bench->proof_unproven)) {
+            snprintf(bench->proof_file, sizeof(bench->proof_file), "%s", PROOF_DUMP_FILE);
+        }
+    }
+}
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Exact score solving (--exact)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 最終石差を null-window の「石差 >= k」証明の繰り返しで求める。
+// 1ラウンドで複数の k をワーカーグループ（スレッドを等分）に割り当てて同時に証明し、
+// 結果で窓 [lo, hi] を狭める。全グループが1つのTTを共有し、証明済みの結果は
+// TTエントリの石差の範囲として他の k からも再利用される（tt_probe 参照）。
+//
+//   - 石差は常に偶数なので、k は窓の中の奇数から等間隔に選ぶ
+//   - 初回は評価値を中心とした窓（グループあたり ±EXACT_ASPIRATION 石）から選び、
+//     ラウンドごとに窓の半幅を2倍にする（アスピレーション）
+//   - 他グループの結果で答えが決まった k（k <= lo または k > hi）は打ち切る
+//   - 各 k の証明では従来の found_win 早期終了がそのまま「石差 >= k」の証明になる
+
+typedef struct {
+    uint64_t player;
+    uint64_t opponent;
+    int threads;
+    double time_limit;
+    bool use_evaluation;
+    TranspositionTable *tt;
+    int target;
+
+    volatile bool cancel;
+    volatile bool done;
+    Result result;
+    int best_move;
+    BenchmarkResult bench;
+} ExactGroup;
+
+static void* exact_group_thread(void *arg) {
+    ExactGroup *g = (ExactGroup*)arg;
+    SolveRunConfig cfg = {
+        .shared_tt = g->tt,
+        .score_target = g->target,
+        .cancel = &g->cancel,
+        .bench = &g->bench
+    };
+    g->result = solve_endgame_run(g->player, g->opponent, g->threads, g->time_limit,
+                                  &g->best_move, g->use_evaluation, &cfg);
+    __atomic_store_n(&g->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// 窓 [lo, hi]（両端は偶数）の中の奇数しきい値を、center の周り ±span の範囲から
+// 最大 n 個等間隔に選ぶ。戻り値は選んだ個数
+static int exact_pick_targets(int lo, int hi, int center, int span, int n, int *targets) {
+    int a = center - span;
+    int b = center + span;
+    if (a < lo) a = lo;
+    if (b > hi) b = hi;
+    if (a >= b) {
+        a = lo;
+        b = hi;
+    }
+
+    int m = (b - a) / 2;  // 候補（a+1, a+3, ..., b-1）の数
+    if (n > m) n = m;
+    for (int i = 0; i < n; i++) {
+        targets[i] = a + 1 + 2 * (int)(((int64_t)(i + 1) * m) / (n + 1));
+    }
+    return n;
+}
+
+// しきい値ごとの探索の統計を合算する（ワーカー統計はグループの位置に並べる）
+static void merge_benchmark_result(BenchmarkResult *dst, const BenchmarkResult *src,
+                                   int worker_offset, int n_workers) {
+    dst->empties = src->empties;
+    dst->legal_moves = src->legal_moves;
+    dst->total_nodes += src->total_nodes;
+    dst->subtasks_spawned += src->subtasks_spawned;
+    dst->subtasks_completed += src->subtasks_completed;
+    snprintf(dst->scheduler, sizeof(dst->scheduler), "%s", src->scheduler);
+    dst->deque_pushes += src->deque_pushes;
+    dst->deque_pops += src->deque_pops;
+    dst->steal_attempts += src->steal_attempts;
+    dst->steals += src->steals;
+    dst->steal_aborts += src->steal_aborts;
+    snprintf(dst->queue_layout, sizeof(dst->queue_layout), "%s", src->queue_layout);
+    dst->queue_l3_domains = src->queue_l3_domains;
+    dst->queue_sockets = src->queue_sockets;
+    dst->queue_l3_pushed += src->queue_l3_pushed;
+    dst->queue_socket_pushed += src->queue_socket_pushed;
+    dst->queue_global_pushed += src->queue_global_pushed;
+    dst->queue_l3_popped += src->queue_l3_popped;
+    dst->queue_socket_popped += src->queue_socket_popped;
+    dst->queue_global_popped += src->queue_global_popped;
+    dst->queue_remote_l3_popped += src->queue_remote_l3_popped;
+    dst->queue_mq_heaps = src->queue_mq_heaps;
+    dst->queue_mq_lock_fails += src->queue_mq_lock_fails;
+    snprintf(dst->engine, sizeof(dst->engine), "%s", src->engine);
+    dst->node_bytes = src->node_bytes;
+    dst->node_budget = src->node_budget;
+    if (src->peak_live_nodes > dst->peak_live_nodes) dst->peak_live_nodes = src->peak_live_nodes;
+    dst->gc_runs += src->gc_runs;
+    dst->gc_nodes_freed += src->gc_nodes_freed;
+    dst->epsilon = src->epsilon;
+    dst->sibling_switches += src->sibling_switches;
+    if (src->max_node_switches > dst->max_node_switches) dst->max_node_switches = src->max_node_switches;
+    dst->reexpansions += src->reexpansions;
+    snprintf(dst->ordering, sizeof(dst->ordering), "%s", src->ordering);
+    dst->ordering_cutoffs += src->ordering_cutoffs;
+    dst->ordering_first_cutoffs += src->ordering_first_cutoffs;
+    dst->history_updates += src->history_updates;
+    dst->endgame_order_empties = src->endgame_order_empties;
+    dst->endgame_order_expansions += src->endgame_order_expansions;
+    dst->etc = src->etc;
+    dst->etc_probes += src->etc_probes;
+    dst->etc_hits += src->etc_hits;
+    dst->etc_cutoffs += src->etc_cutoffs;
+    dst->eval_incremental = src->eval_incremental;
+    dst->eval_batch = src->eval_batch;
+    dst->eval_incremental_evals += src->eval_incremental_evals;
+    dst->eval_feature_rebuilds += src->eval_feature_rebuilds;
+    dst->eval_batches += src->eval_batches;
+    dst->eval_batched_children += src->eval_batched_children;
+    dst->eval_hash_mb = src->eval_hash_mb;
+    dst->eval_hash_entries = src->eval_hash_entries;
+    dst->eval_hash_probes += src->eval_hash_probes;
+    dst->eval_hash_hits += src->eval_hash_hits;
+    dst->eval_lazy = src->eval_lazy;
+    dst->eval_min_empties = src->eval_min_empties;
+    dst->eval_child_evals += src->eval_child_evals;
+    dst->eval_lazy_deferred += src->eval_lazy_deferred;
+    dst->eval_lazy_resolved += src->eval_lazy_resolved;
+    dst->eval_gated += src->eval_gated;
+    dst->eval_numa = src->eval_numa;
+    dst->eval_numa_nodes = src->eval_numa_nodes;
+    for (int n = 0; n < EVAL_NUMA_MAX_NODES; n++) dst->eval_numa_workers[n] += src->eval_numa_workers[n];
+    dst->eval_numa_switches += src->eval_numa_switches;
+    dst->dag = src->dag;
+    dst->dag_transpositions += src->dag_transpositions;
+    dst->dag_corrections += src->dag_corrections;
+    dst->stability = src->stability;
+    for (int e = 0; e <= 64; e++) {
+        dst->stability_nodes[e] += src->stability_nodes[e];
+        dst->stability_cuts[e] += src->stability_cuts[e];
+    }
+    snprintf(dst->pn_init, sizeof(dst->pn_init), "%s", src->pn_init);
+    snprintf(dst->eval_kernel, sizeof(dst->eval_kernel), "%s", src->eval_kernel);
+    snprintf(dst->eval_load_source, sizeof(dst->eval_load_source), "%s", src->eval_load_source);
+    dst->eval_load_ms = src->eval_load_ms;
+    snprintf(dst->aggregation, sizeof(dst->aggregation), "%s", src->aggregation);
+    dst->agg_hybrid_min_empties = src->agg_hybrid_min_empties;
+    dst->dpn_r = src->dpn_r;
+    for (int i = 0; i < n_workers && worker_offset + i < MAX_THREADS; i++) {
+        dst->worker_nodes[worker_offset + i] += src->worker_nodes[i];
+        dst->worker_tasks[worker_offset + i] += src->worker_tasks[i];
+        dst->worker_idle_ms[worker_offset + i] += src->worker_idle_ms[i];
+    }
+}
+
+// 最終石差（手番側視点）を求める。確定しなければ *lower < *upper のまま返る
+// 戻り値: 石差の符号による勝敗（範囲で符号が決まらなければ UNKNOWN）
+Result solve_endgame_exact(uint64_t player, uint64_t opponent, int num_threads,
+                           double time_limit, int *best_move, bool use_evaluation,
+                           int n_groups, int *lower, int *upper) {
+    check_cpu_features();
+    init_zobrist();
+    stability_init();  // グループのスレッドが同時に初期化しないよう先に作る
+
+    if (n_groups > MAX_EXACT_GROUPS) n_groups = MAX_EXACT_GROUPS;
+    if (n_groups > num_threads) n_groups = num_threads;
+    if (n_groups < 1) n_groups = 1;
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    TranspositionTable *tt = tt_create(TT_SIZE_MB);
+    ExactGroup *groups = calloc(n_groups, sizeof(ExactGroup));
+    BenchmarkResult *bench = &g_benchmark_result;
+    bench->exact = true;
+    bench->exact_groups = n_groups;
+
+    // 評価値（手番側視点の石差の予測）をアスピレーション窓の中心にする
+    int center = 0;
+    if (use_evaluation) {
+        int best_eval = SCORE_MIN;
+        uint64_t moves = get_moves(player, opponent);
+        int evals[MAX_CHILDREN];
+        int n = moves ? evaluate_children(player, opponent, moves, evals) : 0;
+        for (int i = 0; i < n; i++) {
+            if (-evals[i] > best_eval) best_eval = -evals[i];
+        }
+        center = best_eval;
+        if (center < SCORE_MIN) center = SCORE_MIN;
+        if (center > SCORE_MAX) center = SCORE_MAX;
+        center &= ~1;
     }
-#endif // ENABLE_EVAL_IMPACT
 
-#if ENABLE_GLOBAL_CHECK_BENCHMARK
-    // Global比較ベンチマーク統計（スレッドごと）
-    debug_log("\n=== Global Check Benchmark (per-thread) ===\n");
-    debug_log("Thread | Checks | GlobalBetter | AvgInterval | MinInterval | MaxInterval\n");
-    debug_log("-------|--------|--------------|-------------|-------------|------------\n");
+    int lo = SCORE_MIN, hi = SCORE_MAX;
+    int lo_move = -1;       // lo を証明した手
+    int span = EXACT_ASPIRATION * n_groups;
+    int round = 0;
+    bool stalled = false;
 
-    uint64_t total_checks = 0;
-    uint64_t total_true = 0;
+    debug_log("\n=== Exact score search: %d groups, aspiration center %+d ===\n", n_groups, center);
 
-    for (int i = 0; i < num_threads; i++) {
-        uint64_t checks = workers[i].global_check_count;
-        uint64_t true_count = workers[i].global_check_true_count;
-        uint64_t interval_sum = workers[i].check_interval_sum;
-        uint64_t interval_min = workers[i].check_interval_min;
-        uint64_t interval_max = workers[i].check_interval_max;
+    while (lo < hi && !stalled) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double elapsed = (now.tv_sec - start_time.tv_sec) + (now.tv_nsec - start_time.tv_nsec) / 1e9;
+        double remaining = (time_limit > 0) ? time_limit - elapsed : 0;
+        if (time_limit > 0 && remaining <= 0) break;
+
+        int c = center < lo ? lo : (center > hi ? hi : center);
+        int targets[MAX_EXACT_GROUPS];
+        int n = exact_pick_targets(lo, hi, c, span, n_groups, targets);
+
+        // スレッドをグループに等分（余りは先頭のグループへ）
+        int worker_offset[MAX_EXACT_GROUPS];
+        int offset = 0;
+        for (int g = 0; g < n; g++) {
+            ExactGroup *grp = &groups[g];
+            memset(grp, 0, sizeof(*grp));
+            grp->player = player;
+            grp->opponent = opponent;
+            grp->threads = num_threads / n + (g < num_threads % n ? 1 : 0);
+            grp->time_limit = remaining;
+            grp->use_evaluation = use_evaluation;
+            grp->tt = tt;
+            grp->target = targets[g];
+            grp->best_move = -1;
+            worker_offset[g] = offset;
+            offset += grp->threads;
+        }
 
-        double avg_interval = (checks > 1) ? (double)interval_sum / (checks - 1) : 0;
+        debug_log("Round %d: window [%+d, %+d], targets:", round, lo, hi);
+        for (int g = 0; g < n; g++) debug_log(" >=%+d (%d threads)", targets[g], groups[g].threads);
+        debug_log("\n");
+
+        pthread_t threads[MAX_EXACT_GROUPS];
+        struct timespec round_start[MAX_EXACT_GROUPS];
+        double query_time[MAX_EXACT_GROUPS];
+        bool collected[MAX_EXACT_GROUPS] = {false};
+        for (int g = 0; g < n; g++) {
+            clock_gettime(CLOCK_MONOTONIC, &round_start[g]);
+            pthread_create(&threads[g], NULL, exact_group_thread, &groups[g]);
+        }
 
-        debug_log("   %2d  | %6llu | %12llu | %11.1f | %11llu | %11llu\n",
-               i,
-               (unsigned long long)checks,
-               (unsigned long long)true_count,
-               avg_interval,
-               (unsigned long long)interval_min,
-               (unsigned long long)interval_max);
+        // 終わったグループから窓を狭め、答えが決まったしきい値を打ち切る
+        int n_collected = 0;
+        while (n_collected < n) {
+            usleep(10000);
+            for (int g = 0; g < n; g++) {
+                if (collected[g] || !__atomic_load_n(&groups[g].done, __ATOMIC_ACQUIRE)) continue;
+                collected[g] = true;
+                n_collected++;
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                query_time[g] = (now.tv_sec - round_start[g].tv_sec) +
+                                (now.tv_nsec - round_start[g].tv_nsec) / 1e9;
+
+                int k = groups[g].target;
+                if (groups[g].result == RESULT_EXACT_WIN && k + 1 > lo) {
+                    lo = k + 1;
+                    lo_move = groups[g].best_move;
+                } else if (groups[g].result == RESULT_EXACT_LOSE && k - 1 < hi) {
+                    hi = k - 1;
+                }
+                for (int h = 0; h < n; h++) {
+                    if (!collected[h] && (groups[h].target <= lo || groups[h].target > hi)) {
+                        groups[h].cancel = true;
+                    }
+                }
+            }
+        }
 
-        total_checks += checks;
-        total_true += true_count;
-    }
+        for (int g = 0; g < n; g++) {
+            pthread_join(threads[g], NULL);
+            ExactGroup *grp = &groups[g];
+            bool decided = (grp->result == RESULT_EXACT_WIN || grp->result == RESULT_EXACT_LOSE);
+            if (!decided && !grp->cancel) stalled = true;  // 時間切れ（またはルートで打てない）
+
+            if (bench->n_exact_queries < MAX_EXACT_QUERIES) {
+                ExactQueryStat *q = &bench->exact_queries[bench->n_exact_queries++];
+                q->target = grp->target;
+                q->round = round;
+                snprintf(q->result, sizeof(q->result), "%s",
+                         grp->result == RESULT_EXACT_WIN ? "ge" :
+                         (grp->result == RESULT_EXACT_LOSE ? "lt" : "unknown"));
+                q->cancelled = grp->cancel && !decided;
+                q->best_move = (grp->result == RESULT_EXACT_WIN) ? grp->best_move : -1;
+                q->threads = grp->threads;
+                q->nodes = grp->bench.total_nodes;
+                q->time_sec = query_time[g];
+            }
+            merge_benchmark_result(bench, &grp->bench, worker_offset[g], grp->threads);
 
-    debug_log("-------|--------|--------------|-------------|-------------|------------\n");
-    debug_log(" Total | %6llu | %12llu |             |             |\n",
-           (unsigned long long)total_checks,
-           (unsigned long long)total_true);
+            debug_log("  score >= %+d: %s%s (%llu nodes, %.3fs)\n", grp->target,
+                      grp->result == RESULT_EXACT_WIN ? "yes" :
+                      (grp->result == RESULT_EXACT_LOSE ? "no" : "unknown"),
+                      grp->cancel && !decided ? " [cancelled]" : "",
+                      (unsigned long long)grp->bench.total_nodes, query_time[g]);
+        }
 
-    if (total_checks > 0) {
-        debug_log("\nGlobal比較でGlobalが良かった割合: %.2f%%\n",
-               100.0 * total_true / total_checks);
-        debug_log("平均: %.1f ノードごとに1回Global比較\n",
-               (double)total_nodes / total_checks);
+        round++;
+        span *= 2;
     }
-#endif
 
-    debug_log("\n=== Result Summary ===\n");
-    debug_log("WIN: %d, LOSE: %d, DRAW: %d, UNKNOWN: %d\n",
-           win_count, lose_count, draw_count, unknown_count);
-    debug_log("Final result: %s\n",
-           final_result == RESULT_EXACT_WIN ? "WIN" :
-           (final_result == RESULT_EXACT_LOSE ? "LOSE" :
-           (final_result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")));
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double elapsed = (end_time.tv_sec - start_time.tv_sec) + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
 
-    if (best_move) *best_move = final_best_move;
+    // 石差 = -64 のときはどの手も同じ（最初の合法手を返す）
+    if (lo_move < 0 && lo == hi) {
+        uint64_t moves = get_moves(player, opponent);
+        if (moves) lo_move = first_one(moves);
+    }
 
-    // Populate benchmark result for CSV/JSON output
-    g_benchmark_result.empties = empties;
-    g_benchmark_result.legal_moves = n_moves;
-    strncpy(g_benchmark_result.result,
-            final_result == RESULT_EXACT_WIN ? "WIN" :
-            (final_result == RESULT_EXACT_LOSE ? "LOSE" :
-            (final_result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")),
-            sizeof(g_benchmark_result.result) - 1);
-    if (final_best_move >= 0 && final_best_move < 64) {
-        snprintf(g_benchmark_result.best_move, sizeof(g_benchmark_result.best_move),
-                 "%c%d", 'a' + (final_best_move % 8), 8 - (final_best_move / 8));
+    Result result = RESULT_UNKNOWN;
+    if (lo > 0) result = RESULT_EXACT_WIN;
+    else if (hi < 0) result = RESULT_EXACT_LOSE;
+    else if (lo == 0 && hi == 0) result = RESULT_EXACT_DRAW;
+
+    if (lo == hi) {
+        debug_log("Exact score: %+d (best move %c%d), %d rounds, %.3fs\n", lo,
+                  lo_move >= 0 ? 'a' + (lo_move % 8) : '-', lo_move >= 0 ? 8 - (lo_move / 8) : 0,
+                  round, elapsed);
+    } else {
+        debug_log("Exact score not determined: [%+d, %+d] after %d rounds, %.3fs\n", lo, hi, round, elapsed);
+    }
+
+    *lower = lo;
+    *upper = hi;
+    if (best_move) *best_move = lo_move;
+
+    bench->exact_lower = lo;
+    bench->exact_upper = hi;
+    bench->exact_rounds = round;
+    bench->num_threads = num_threads;
+    snprintf(bench->result, sizeof(bench->result), "%s",
+             result == RESULT_EXACT_WIN ? "WIN" :
+             (result == RESULT_EXACT_LOSE ? "LOSE" :
+             (result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")));
+    if (lo_move >= 0 && lo_move < 64) {
+        snprintf(bench->best_move, sizeof(bench->best_move), "%c%d", 'a' + (lo_move % 8), 8 - (lo_move / 8));
     } else {
-        strncpy(g_benchmark_result.best_move, "N/A", sizeof(g_benchmark_result.best_move) - 1);
-    }
-    g_benchmark_result.total_nodes = total_nodes;
-    g_benchmark_result.time_sec = elapsed;
-    g_benchmark_result.nps = (total_nodes > 0 && elapsed > 0) ? total_nodes / elapsed : 0;
-    g_benchmark_result.tt_hits = global.tt->hits;
-    g_benchmark_result.tt_stores = global.tt->stores;
-    g_benchmark_result.tt_collisions = global.tt->collisions;
-    g_benchmark_result.tt_hit_rate = 100.0 * global.tt->hits / (global.tt->hits + global.tt->stores + 1);
-    g_benchmark_result.subtasks_spawned = global.subtasks_spawned;
-    g_benchmark_result.subtasks_completed = global.subtasks_completed;
-    g_benchmark_result.win_count = win_count;
-    g_benchmark_result.lose_count = lose_count;
-    g_benchmark_result.draw_count = draw_count;
-    g_benchmark_result.unknown_count = unknown_count;
+        snprintf(bench->best_move, sizeof(bench->best_move), "N/A");
+    }
+    bench->time_sec = elapsed;
+    bench->nps = (bench->total_nodes > 0 && elapsed > 0) ? bench->total_nodes / elapsed : 0;
+    bench->tt_hits = tt->hits;
+    bench->tt_stores = tt->stores;
+    bench->tt_collisions = tt->collisions;
+    bench->tt_hit_rate = 100.0 * tt->hits / (tt->hits + tt->stores + 1);
+
+    // 読み筋と証明木: 「>= lo」（lo - 1 は奇数のしきい値）と「< hi + 1」
+    ProofGoal goals[2] = {0};
+    int n_goals = 0;
+    if (lo > SCORE_MIN) goals[n_goals++] = (ProofGoal){ lo - 1, true };
+    if (hi < SCORE_MAX) goals[n_goals++] = (ProofGoal){ hi + 1, false };
+    report_pv_and_proof(tt, player, opponent, goals, n_goals, lo_move);
+
+    output_csv_result(bench);
+    output_json_result(bench);
+
+    free(groups);
+    tt_free(tt);
+    return result;
+}
 
-    // Store per-worker statistics
-    for (int i = 0; i < num_threads && i < MAX_THREADS; i++) {
-        g_benchmark_result.worker_nodes[i] = workers[i].nodes;
-        g_benchmark_result.worker_tasks[i] = workers[i].tasks_processed;
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Score-threshold queries and win/loss/draw solving
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 探索は常に「手番側の最終石差 >= target か」の二値の問いを解く（Task.target）。
+// 勝ち/負け/引き分けは2つの問いで決める:
+//   1. 石差 >= +1 か → はい: WIN
+//   2. いいえなら 石差 >= 0 か → はい: DRAW、いいえ: LOSE
+// 2つ目の問いは1つ目とTTを共有する（石差の範囲が証明済みの局面は再探索しない）。
+
+// 1つの問いを解き、統計を bench に合算して問いの記録を残す
+static Result solve_threshold_query(uint64_t player, uint64_t opponent, int num_threads,
+                                    double time_limit, int *best_move, bool use_evaluation,
+                                    TranspositionTable *tt, int target, int round) {
+    BenchmarkResult *bench = &g_benchmark_result;
+    BenchmarkResult *run_bench = calloc(1, sizeof(BenchmarkResult));
+    SolveRunConfig cfg = {
+        .shared_tt = tt,
+        .score_target = target,
+        .cancel = NULL,
+        .bench = run_bench
+    };
+    Result result = solve_endgame_run(player, opponent, num_threads, time_limit,
+                                      best_move, use_evaluation, &cfg);
+
+    if (bench->n_exact_queries < MAX_EXACT_QUERIES) {
+        ExactQueryStat *q = &bench->exact_queries[bench->n_exact_queries++];
+        q->target = target;
+        q->round = round;
+        snprintf(q->result, sizeof(q->result), "%s",
+                 result == RESULT_EXACT_WIN ? "ge" :
+                 (result == RESULT_EXACT_LOSE ? "lt" : "unknown"));
+        q->cancelled = false;
+        q->best_move = (result == RESULT_EXACT_WIN) ? *best_move : -1;
+        q->threads = num_threads;
+        q->nodes = run_bench->total_nodes;
+        q->time_sec = run_bench->time_sec;
+    }
+    merge_benchmark_result(bench, run_bench, 0, num_threads);
+    bench->time_sec += run_bench->time_sec;
+    bench->nps = (bench->total_nodes > 0 && bench->time_sec > 0) ? bench->total_nodes / bench->time_sec : 0;
+    bench->tt_hits = tt->hits;
+    bench->tt_stores = tt->stores;
+    bench->tt_collisions = tt->collisions;
+    bench->tt_hit_rate = 100.0 * tt->hits / (tt->hits + tt->stores + 1);
+    bench->win_count = run_bench->win_count;
+    bench->lose_count = run_bench->lose_count;
+    bench->draw_count = run_bench->draw_count;
+    bench->unknown_count = run_bench->unknown_count;
+
+    free(run_bench);
+    return result;
+}
+
+// 最終的な答えと手を bench に記録する（複数の問いを組み合わせた結果）
+static void set_benchmark_outcome(BenchmarkResult *bench, Result result, int best_move) {
+    snprintf(bench->result, sizeof(bench->result), "%s",
+             result == RESULT_EXACT_WIN ? "WIN" :
+             (result == RESULT_EXACT_LOSE ? "LOSE" :
+             (result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")));
+    if (best_move >= 0 && best_move < 64) {
+        snprintf(bench->best_move, sizeof(bench->best_move), "%c%d", 'a' + (best_move % 8), 8 - (best_move / 8));
+    } else {
+        snprintf(bench->best_move, sizeof(bench->best_move), "N/A");
     }
+}
+
+static void set_query_answer(BenchmarkResult *bench, Result answer) {
+    snprintf(bench->query_answer, sizeof(bench->query_answer), "%s",
+             answer == RESULT_EXACT_WIN ? "yes" : (answer == RESULT_EXACT_LOSE ? "no" : "unknown"));
+}
 
-    // Output to CSV and/or JSON
+// 「手番側の最終石差 >= target か」を解く
+// 戻り値: RESULT_EXACT_WIN = はい、RESULT_EXACT_LOSE = いいえ、RESULT_UNKNOWN = 時間切れ
+// best_move: はいの場合、石差 >= target を達成する手
+Result solve_endgame_at_least(uint64_t player, uint64_t opponent, int num_threads,
+                              double time_limit, int *best_move, bool use_evaluation,
+                              int target) {
+    TranspositionTable *tt = tt_create(TT_SIZE_MB);
+    Result result = solve_threshold_query(player, opponent, num_threads, time_limit,
+                                          best_move, use_evaluation, tt, target, 0);
+    if (result != RESULT_UNKNOWN) {
+        ProofGoal goal = { target, result == RESULT_EXACT_WIN };
+        report_pv_and_proof(tt, player, opponent, &goal, 1, *best_move);
+    }
+    tt_free(tt);
+
+    set_benchmark_outcome(&g_benchmark_result, result, *best_move);
+    set_query_answer(&g_benchmark_result, result);
     output_csv_result(&g_benchmark_result);
     output_json_result(&g_benchmark_result);
+    return result;
+}
 
-    // Cleanup
-    if (thread_stats) free(thread_stats);
-    if (tree_stats) free(tree_stats);
-#if ENABLE_EVAL_IMPACT
-    if (global.eval_impacts) free(global.eval_impacts);
-    if (global.move_start_times) free(global.move_start_times);
-#endif
-    free(global.move_results);
-    free(global.move_nodes);
-    free(global.move_list);
-    free(global.move_evals);
-    free(workers);
-    tt_free(global.tt);
-    pthread_mutex_destroy(&global.stats_mutex);
-
-    // HYBRID: Cleanup hybrid resources
-    global_chunk_queue_destroy(global.global_chunk_queue);
-    shared_array_destroy(global.shared_array);
+// 「手番側の最終石差 <= k か」を解く（= 「石差 >= k + 1 か」の否定）
+// 戻り値: RESULT_EXACT_WIN = はい、RESULT_EXACT_LOSE = いいえ、RESULT_UNKNOWN = 時間切れ
+Result solve_endgame_at_most(uint64_t player, uint64_t opponent, int num_threads,
+                             double time_limit, int *best_move, bool use_evaluation,
+                             int k) {
+    TranspositionTable *tt = tt_create(TT_SIZE_MB);
+    Result ge = solve_threshold_query(player, opponent, num_threads, time_limit,
+                                      best_move, use_evaluation, tt, k + 1, 0);
+    if (ge != RESULT_UNKNOWN) {
+        ProofGoal goal = { k + 1, ge == RESULT_EXACT_WIN };
+        report_pv_and_proof(tt, player, opponent, &goal, 1, *best_move);
+    }
+    tt_free(tt);
+
+    Result result = (ge == RESULT_EXACT_WIN) ? RESULT_EXACT_LOSE :
+                    (ge == RESULT_EXACT_LOSE ? RESULT_EXACT_WIN : RESULT_UNKNOWN);
+    set_benchmark_outcome(&g_benchmark_result, result, *best_move);
+    set_query_answer(&g_benchmark_result, result);
+    output_csv_result(&g_benchmark_result);
+    output_json_result(&g_benchmark_result);
+    return result;
+}
 
-    return final_result;
+// 勝ち/負け/引き分けを解く（石差 >= +1 と 石差 >= 0 の2つの問い）
+Result solve_endgame(uint64_t player, uint64_t opponent, int num_threads,
+                    double time_limit, int *best_move, bool use_evaluation) {
+    TranspositionTable *tt = tt_create(TT_SIZE_MB);
+    Result result = solve_threshold_query(player, opponent, num_threads, time_limit,
+                                          best_move, use_evaluation, tt, SCORE_TARGET_WIN, 0);
+
+    // time_limit = 0 は制限なし（remaining = 0 で2つ目の問いも制限なし）
+    double remaining = (time_limit > 0) ? time_limit - g_benchmark_result.time_sec : 0;
+    if (result == RESULT_EXACT_LOSE && (time_limit <= 0 || remaining > 0)) {
+        // 勝てない: 引き分けに持ち込めるか
+        int draw_move = -1;
+        Result not_lose = solve_threshold_query(player, opponent, num_threads, remaining,
+                                                &draw_move, use_evaluation, tt,
+                                                SCORE_TARGET_NOT_LOSE, 1);
+        if (not_lose == RESULT_EXACT_WIN) {
+            result = RESULT_EXACT_DRAW;
+            *best_move = draw_move;
+        } else if (not_lose == RESULT_UNKNOWN) {
+            result = RESULT_UNKNOWN;
+        }
+    } else if (result == RESULT_EXACT_LOSE) {
+        result = RESULT_UNKNOWN;  // 引き分けか負けかを判定する時間が残っていない
+    }
+
+    // 読み筋と証明木: WIN は >= +1、LOSE は < 0、DRAW は >= 0 と < +1 の両方
+    ProofGoal goals[2] = {0};
+    int n_goals = 0;
+    if (result == RESULT_EXACT_WIN) {
+        goals[n_goals++] = (ProofGoal){ SCORE_TARGET_WIN, true };
+    } else if (result == RESULT_EXACT_LOSE) {
+        goals[n_goals++] = (ProofGoal){ SCORE_TARGET_NOT_LOSE, false };
+    } else if (result == RESULT_EXACT_DRAW) {
+        goals[n_goals++] = (ProofGoal){ SCORE_TARGET_NOT_LOSE, true };
+        goals[n_goals++] = (ProofGoal){ SCORE_TARGET_WIN, false };
+    }
+    report_pv_and_proof(tt, player, opponent, goals, n_goals, *best_move);
+    tt_free(tt);
+
+    debug_log("Win/loss/draw: %d queries, result %s\n", g_benchmark_result.n_exact_queries,
+              result == RESULT_EXACT_WIN ? "WIN" :
+              (result == RESULT_EXACT_LOSE ? "LOSE" :
+              (result == RESULT_EXACT_DRAW ? "DRAW" : "UNKNOWN")));
+
+    set_benchmark_outcome(&g_benchmark_result, result, *best_move);
+    output_csv_result(&g_benchmark_result);
+    output_json_result(&g_benchmark_result);
+    return result;
 }
 
 // ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
@@ -4650,6 +9836,25 @@ static bool parse_pos_file(const char *filename, uint64_t *black, uint64_t *whit
 }
 
 #ifdef STANDALONE_MAIN
+// 読み筋と証明木ファイルの表示（結果が確定したときのみ）
+static void print_pv_and_proof(void) {
+    const BenchmarkResult *r = &g_benchmark_result;
+    if (r->pv_len > 0) {
+        char pv_str[MAX_PV_LENGTH * 5 + 1];
+        format_pv(pv_str, sizeof(pv_str), r->pv, r->pv_len);
+        printf("PV: %s", pv_str);
+        if (r->pv_complete) {
+            printf(" (final %+d)\n", r->pv_final_score);
+        } else {
+            printf(" ...\n");
+        }
+    }
+    if (r->proof_file[0]) {
+        printf("Proof tree: %s (%llu records, %llu unproven)\n", r->proof_file,
+               (unsigned long long)r->proof_records, (unsigned long long)r->proof_unproven);
+    }
+}
+
 int main(int argc, char *argv[]) {
     if (argc < 2) {
         fprintf(stderr, "Usage: %s <pos_file> [threads] [time_limit] [eval_dat] [options]\n", argv[0]);
@@ -4670,6 +9875,67 @@ int main(int argc, char *argv[]) {
         fprintf(stderr, "  -G <num>      Max generation depth (default: 3, 40-core: 5)\n");
         fprintf(stderr, "  -D <num>      Min depth for spawning (default: 6, 40-core: 4)\n");
         fprintf(stderr, "  -S <num>      Spawn limit per node (default: 3, 40-core: 6)\n");
+        fprintf(stderr, "\nSearch options:\n");
+        fprintf(stderr, "  --node-budget <n>  Max live df-pn nodes per worker; proven and small\n");
+        fprintf(stderr, "                     off-path subtrees are collapsed into the TT (default: 0 = unlimited)\n");
+        fprintf(stderr, "  --engine <e>       df-pn engine: tree (DFPNNode tree, default) or\n");
+        fprintf(stderr, "                     tt (tree-less depth-first, child pn/dn via TT only)\n");
+        fprintf(stderr, "  --scheduler <s>    Task scheduler: hybrid (LocalHeap + GlobalChunkQueue,\n");
+        fprintf(stderr, "                     default) or chaselev (per-worker Chase-Lev deques,\n");
+        fprintf(stderr, "                     randomized stealing)\n");
+        fprintf(stderr, "  --queues <q>       GlobalChunkQueue layout: flat (one queue, default),\n");
+        fprintf(stderr, "                     hier (per-L3-domain, per-socket, then global; escalate\n");
+        fprintf(stderr, "                     when empty), or multiqueue (c x threads try-locked\n");
+        fprintf(stderr, "                     sub-heaps, pop best of 2 random)\n");
+        fprintf(stderr, "  --mq-c <c>         MultiQueue sub-heaps per thread (default: %d)\n", DEFAULT_MQ_C);
+        fprintf(stderr, "  --epsilon <e>      1+e child thresholds, e.g. 0.25 (default: -1 = legacy\n");
+        fprintf(stderr, "                     tree thresholds; the tt engine treats e < 0 as 0)\n");
+        fprintf(stderr, "  --pn-init <m>      Leaf pn/dn initialization: unit (default), mobility,\n");
+        fprintf(stderr, "                     eval, or mobility+eval (df-pn+ style)\n");
+        fprintf(stderr, "  --eval-kernel <k>  Evaluation kernel: auto (default: best gather kernel),\n");
+        fprintf(stderr, "                     scalar, avx2, avx2-gather or avx512-gather\n");
+        fprintf(stderr, "  --eval-cache <s>   Unpacked weight image mapped with mmap: off (default),\n");
+        fprintf(stderr, "                     on (<eval file>%s, created on first use), or a path\n",
+                EVAL_CACHE_SUFFIX);
+        fprintf(stderr, "  --aggregate <a>    Summed-side pn/dn aggregation: classic (sum, default),\n");
+        fprintf(stderr, "                     wpn (max + unsolved - 1), or hybrid (wpn at high empties)\n");
+        fprintf(stderr, "  --agg-hybrid-empties <n>  hybrid: use wpn at >= n empties (default: %d)\n",
+                DEFAULT_AGG_HYBRID_MIN_EMPTIES);
+        fprintf(stderr, "  --ordering <m>     Child ordering: eval (default), eval+history, history\n");
+        fprintf(stderr, "                     (per-worker history/killer tables, no eval calls), or none\n");
+        fprintf(stderr, "  --endgame-order <n>  Order by opponent mobility, parity and square class\n");
+        fprintf(stderr, "                     instead of eval at <= n empties (0 = off; default: %d,\n",
+                DEFAULT_ENDGAME_ORDER_EMPTIES);
+        fprintf(stderr, "                     or 0 with --ordering eval*, --pn-init *eval or --eval-*)\n");
+        fprintf(stderr, "  --etc <s>          Probe all children in the TT at expansion and prove the\n");
+        fprintf(stderr, "                     parent from a proven child: on (default) or off\n");
+        fprintf(stderr, "  --eval-incremental <s>  Evaluate children from pattern features updated by\n");
+        fprintf(stderr, "                     the move and flips: on (default) or off (full recompute)\n");
+        fprintf(stderr, "  --eval-numa <s>    Replicate eval weights on each NUMA node and read the\n");
+        fprintf(stderr, "                     worker's local copy: on or off (default)\n");
+        fprintf(stderr, "  --eval-batch <s>   Evaluate all children of a node together so the weight\n");
+        fprintf(stderr, "                     gathers of siblings overlap: on (default) or off\n");
+        fprintf(stderr, "  --eval-hash <MB>   Shared position -> eval cache checked before evaluating\n");
+        fprintf(stderr, "                     a child: size in MB (default: %d) or off\n", DEFAULT_EVAL_HASH_MB);
+        fprintf(stderr, "  --eval-lazy <s>    Order new children by mobility/parity and evaluate them\n");
+        fprintf(stderr, "                     only when the node is visited again: on or off (default)\n");
+        fprintf(stderr, "  --eval-min-empties <n>  Do not evaluate children of nodes with < n empties\n");
+        fprintf(stderr, "                     (default: 0, always evaluate)\n");
+        fprintf(stderr, "  --dag <s>          Transposition-aware summed pn/dn via TT source markers:\n");
+        fprintf(stderr, "                     on or off (default); no effect where wpn is used\n");
+        fprintf(stderr, "  --dpn-r <R>        Deep proof number child selection, 0 <= R <= 1\n");
+        fprintf(stderr, "                     (1 = proof number, 0 = depth-first; tree engine only)\n");
+        fprintf(stderr, "  --stability <s>    Stable-disc cutoffs before expansion: on (default) or off\n");
+        fprintf(stderr, "  --exact            Solve the exact final disc difference with parallel\n");
+        fprintf(stderr, "                     null-window \"score >= k\" proofs sharing one TT\n");
+        fprintf(stderr, "  --exact-groups <n> --exact: thresholds proved at once, threads split\n");
+        fprintf(stderr, "                     evenly across groups (default: %d, max: %d)\n",
+                DEFAULT_EXACT_GROUPS, MAX_EXACT_GROUPS);
+        fprintf(stderr, "  --at-least <k>     Answer only \"is the final disc difference >= k?\"\n");
+        fprintf(stderr, "                     for the side to move (-64 <= k <= 64)\n");
+        fprintf(stderr, "  --at-most <k>      Answer only \"is the final disc difference <= k?\"\n");
+        fprintf(stderr, "  --proof-dump <f>   Write the proof tree (minimal proving positions) to a\n");
+        fprintf(stderr, "                     binary file; the PV is always printed when solved\n");
         fprintf(stderr, "\nExamples:\n");
         fprintf(stderr, "  Basic:   %s test.pos 8 30.0 eval.dat -v -w\n", argv[0]);
         fprintf(stderr, "  40-core: %s test.pos 40 120.0 eval.dat -v -w -G 5 -D 4 -S 6\n", argv[0]);
@@ -4698,8 +9964,13 @@ int main(int argc, char *argv[]) {
     int max_generation = DEFAULT_SPAWN_MAX_GENERATION;
     int min_depth_for_spawn = DEFAULT_SPAWN_MIN_DEPTH;
     int spawn_limit = DEFAULT_SPAWN_LIMIT_PER_NODE;
+    // 評価値を使う指定（--ordering eval / eval+history、--pn-init eval、--eval-* の各オプション）
+    bool eval_requested = false;
 
     for (int i = 5; i < argc; i++) {
+        if (strncmp(argv[i], "--eval-", 7) == 0) {
+            eval_requested = true;
+        }
         if (strcmp(argv[i], "-v") == 0) {
             debug_enabled = true;
             verbose = true;
@@ -4731,6 +10002,231 @@ int main(int argc, char *argv[]) {
             min_depth_for_spawn = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
             spawn_limit = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scheduler") == 0 && i + 1 < argc) {
+            const char *sched = argv[++i];
+            if (strcmp(sched, "hybrid") == 0) {
+                TASK_SCHEDULER = SCHED_HYBRID;
+            } else if (strcmp(sched, "chaselev") == 0) {
+                TASK_SCHEDULER = SCHED_CHASELEV;
+            } else {
+                fprintf(stderr, "Error: unknown scheduler '%s' (expected hybrid or chaselev)\n", sched);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--queues") == 0 && i + 1 < argc) {
+            const char *queues = argv[++i];
+            if (strcmp(queues, "flat") == 0) {
+                QUEUE_LAYOUT = QUEUES_FLAT;
+            } else if (strcmp(queues, "hier") == 0) {
+                QUEUE_LAYOUT = QUEUES_HIER;
+            } else if (strcmp(queues, "multiqueue") == 0) {
+                QUEUE_LAYOUT = QUEUES_MULTIQUEUE;
+            } else {
+                fprintf(stderr, "Error: unknown queue layout '%s' (expected flat, hier or multiqueue)\n", queues);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--mq-c") == 0 && i + 1 < argc) {
+            MQ_C = atoi(argv[++i]);
+            if (MQ_C < 1) {
+                fprintf(stderr, "Error: --mq-c must be >= 1\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--node-budget") == 0 && i + 1 < argc) {
+            NODE_BUDGET = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            const char *engine = argv[++i];
+            if (strcmp(engine, "tt") == 0) {
+                SEARCH_ENGINE = ENGINE_TT;
+            } else if (strcmp(engine, "tree") == 0) {
+                SEARCH_ENGINE = ENGINE_TREE;
+            } else {
+                fprintf(stderr, "Error: unknown engine '%s' (expected tree or tt)\n", engine);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--epsilon") == 0 && i + 1 < argc) {
+            DFPN_EPSILON = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--pn-init") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            PNDN_INIT = find_pndn_initializer(name);
+            if (PNDN_INIT == NULL) {
+                fprintf(stderr, "Error: unknown pn/dn initializer '%s' "
+                                "(expected unit, mobility, eval or mobility+eval)\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-cache") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                EVAL_CACHE = true;
+                EVAL_CACHE_FILE = NULL;
+            } else if (strcmp(mode, "off") == 0) {
+                EVAL_CACHE = false;
+            } else {
+                EVAL_CACHE = true;
+                EVAL_CACHE_FILE = mode;
+            }
+        } else if (strcmp(argv[i], "--eval-kernel") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (strcmp(name, "auto") == 0) {
+                EVAL_KERNEL = EVAL_KERNEL_AUTO;
+            } else if (strcmp(name, "scalar") == 0) {
+                EVAL_KERNEL = EVAL_KERNEL_SCALAR;
+            } else if (strcmp(name, "avx2") == 0) {
+                EVAL_KERNEL = EVAL_KERNEL_AVX2;
+            } else if (strcmp(name, "avx2-gather") == 0) {
+                EVAL_KERNEL = EVAL_KERNEL_AVX2_GATHER;
+            } else if (strcmp(name, "avx512-gather") == 0) {
+                EVAL_KERNEL = EVAL_KERNEL_AVX512_GATHER;
+            } else {
+                fprintf(stderr, "Error: unknown eval kernel '%s' "
+                                "(expected auto, scalar, avx2, avx2-gather or avx512-gather)\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--aggregate") == 0 && i + 1 < argc) {
+            const char *agg = argv[++i];
+            if (strcmp(agg, "classic") == 0) {
+                PN_AGGREGATION = AGG_CLASSIC;
+            } else if (strcmp(agg, "wpn") == 0) {
+                PN_AGGREGATION = AGG_WPN;
+            } else if (strcmp(agg, "hybrid") == 0) {
+                PN_AGGREGATION = AGG_HYBRID;
+            } else {
+                fprintf(stderr, "Error: unknown aggregation '%s' (expected classic, wpn or hybrid)\n", agg);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--agg-hybrid-empties") == 0 && i + 1 < argc) {
+            AGG_HYBRID_MIN_EMPTIES = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ordering") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "none") == 0) {
+                MOVE_ORDERING = ORDER_NONE;
+            } else if (strcmp(mode, "eval") == 0) {
+                MOVE_ORDERING = ORDER_EVAL;
+                eval_requested = true;
+            } else if (strcmp(mode, "history") == 0) {
+                MOVE_ORDERING = ORDER_HISTORY;
+            } else if (strcmp(mode, "eval+history") == 0) {
+                MOVE_ORDERING = ORDER_EVAL_HISTORY;
+                eval_requested = true;
+            } else {
+                fprintf(stderr, "Error: unknown ordering '%s' (expected none, eval, history or eval+history)\n", mode);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--endgame-order") == 0 && i + 1 < argc) {
+            ENDGAME_ORDER_EMPTIES = atoi(argv[++i]);
+            if (ENDGAME_ORDER_EMPTIES < 0 || ENDGAME_ORDER_EMPTIES > 64) {
+                fprintf(stderr, "Error: --endgame-order must be 0..64\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--etc") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                ETC_ENABLED = true;
+            } else if (strcmp(mode, "off") == 0) {
+                ETC_ENABLED = false;
+            } else {
+                fprintf(stderr, "Error: --etc must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-incremental") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                EVAL_INCREMENTAL = true;
+            } else if (strcmp(mode, "off") == 0) {
+                EVAL_INCREMENTAL = false;
+            } else {
+                fprintf(stderr, "Error: --eval-incremental must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-numa") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                EVAL_NUMA = true;
+            } else if (strcmp(mode, "off") == 0) {
+                EVAL_NUMA = false;
+            } else {
+                fprintf(stderr, "Error: --eval-numa must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-batch") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                EVAL_BATCH = true;
+            } else if (strcmp(mode, "off") == 0) {
+                EVAL_BATCH = false;
+            } else {
+                fprintf(stderr, "Error: --eval-batch must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-hash") == 0 && i + 1 < argc) {
+            const char *size = argv[++i];
+            if (strcmp(size, "off") == 0) {
+                EVAL_HASH_MB = 0;
+            } else {
+                EVAL_HASH_MB = atoi(size);
+                if (EVAL_HASH_MB <= 0 || EVAL_HASH_MB > 65536) {
+                    fprintf(stderr, "Error: --eval-hash must be off or 1..65536 (MB)\n");
+                    return 1;
+                }
+            }
+        } else if (strcmp(argv[i], "--eval-lazy") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                EVAL_LAZY = true;
+            } else if (strcmp(mode, "off") == 0) {
+                EVAL_LAZY = false;
+            } else {
+                fprintf(stderr, "Error: --eval-lazy must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--eval-min-empties") == 0 && i + 1 < argc) {
+            EVAL_MIN_EMPTIES = atoi(argv[++i]);
+            if (EVAL_MIN_EMPTIES < 0 || EVAL_MIN_EMPTIES > 64) {
+                fprintf(stderr, "Error: --eval-min-empties must be 0..64\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dag") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                DAG_PNDN = true;
+            } else if (strcmp(mode, "off") == 0) {
+                DAG_PNDN = false;
+            } else {
+                fprintf(stderr, "Error: --dag must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--dpn-r") == 0 && i + 1 < argc) {
+            DPN_R = atof(argv[++i]);
+            if (DPN_R > 1.0) {
+                fprintf(stderr, "Error: --dpn-r must be in [0, 1]\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--stability") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "on") == 0) {
+                STABILITY_CUTOFF = true;
+            } else if (strcmp(mode, "off") == 0) {
+                STABILITY_CUTOFF = false;
+            } else {
+                fprintf(stderr, "Error: --stability must be on or off\n");
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--exact") == 0) {
+            EXACT_MODE = true;
+        } else if (strcmp(argv[i], "--exact-groups") == 0 && i + 1 < argc) {
+            EXACT_GROUPS = atoi(argv[++i]);
+            if (EXACT_GROUPS < 1 || EXACT_GROUPS > MAX_EXACT_GROUPS) {
+                fprintf(stderr, "Error: --exact-groups must be in [1, %d]\n", MAX_EXACT_GROUPS);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--proof-dump") == 0 && i + 1 < argc) {
+            PROOF_DUMP_FILE = argv[++i];
+        } else if ((strcmp(argv[i], "--at-least") == 0 || strcmp(argv[i], "--at-most") == 0) &&
+                   i + 1 < argc) {
+            QUERY_OP = (strcmp(argv[i], "--at-least") == 0) ? QUERY_AT_LEAST : QUERY_AT_MOST;
+            QUERY_K = atoi(argv[++i]);
+            if (QUERY_K < SCORE_MIN || QUERY_K > SCORE_MAX) {
+                fprintf(stderr, "Error: %s must be in [%d, %d]\n", argv[i - 1], SCORE_MIN, SCORE_MAX);
+                return 1;
+            }
         }
     }
 
@@ -4745,6 +10241,11 @@ int main(int argc, char *argv[]) {
     if (debug_enabled) {
         debug_init(log_file, verbose, track_threads, track_eval, track_tree, real_time, track_ws);
     }
+#if !ENABLE_SEARCH_INSTRUMENTATION
+    if (track_threads || track_tree) {
+        fprintf(stderr, "Warning: built with ENABLE_SEARCH_INSTRUMENTATION=0, -t/-s per-node statistics are not collected\n");
+    }
+#endif
 
     // Setup CSV/JSON output
     if (csv_file) {
@@ -4780,6 +10281,29 @@ int main(int argc, char *argv[]) {
     bool use_evaluation = false;
     if (eval_path && strcmp(eval_path, "none") != 0 && access(eval_path, F_OK) == 0) {
         use_evaluation = load_evaluation_weights(eval_path);
+        if (use_evaluation) {
+            eval_numa_replicate();
+            eval_hash_create(EVAL_HASH_MB);
+        }
+    }
+    if (QUEUE_LAYOUT == QUEUES_HIER) {
+        queue_read_topology();
+    }
+    // 終盤用の順序付けは評価値より少ないノード数で解ける（expS）ので、既定では全域で使う。
+    // 評価値を使う指定があれば評価値で並べ、--endgame-order で評価値が使われない範囲は警告する
+    if (PNDN_INIT->uses_eval) {
+        eval_requested = true;
+    }
+    if (ENDGAME_ORDER_EMPTIES < 0) {
+        ENDGAME_ORDER_EMPTIES = (use_evaluation && eval_requested) ? 0 : DEFAULT_ENDGAME_ORDER_EMPTIES;
+    } else if (use_evaluation && eval_requested && ENDGAME_ORDER_EMPTIES > 0 && ordering_uses_eval()) {
+        fprintf(stderr, "Warning: eval is not called at <= %d empties (--endgame-order)\n",
+                ENDGAME_ORDER_EMPTIES);
+    }
+    // 評価値で pn/dn を初期化する方式は子を作るときに評価値が要るので遅らせられない
+    if (EVAL_LAZY && PNDN_INIT->uses_eval) {
+        fprintf(stderr, "Warning: --eval-lazy has no effect with --pn-init %s\n", PNDN_INIT->name);
+        EVAL_LAZY = false;
     }
 
     uint64_t black, white;
@@ -4793,6 +10317,80 @@ int main(int argc, char *argv[]) {
     uint64_t player = (turn_char == 'B') ? black : white;
     uint64_t opponent = (turn_char == 'B') ? white : black;
 
+    if (EXACT_MODE && QUERY_OP != QUERY_NONE) {
+        fprintf(stderr, "Error: --exact cannot be combined with --at-least / --at-most\n");
+        return 1;
+    }
+
+    if (QUERY_OP != QUERY_NONE) {
+        int best_move = -1;
+        g_benchmark_result.query = true;
+        g_benchmark_result.query_k = QUERY_K;
+        snprintf(g_benchmark_result.query_op, sizeof(g_benchmark_result.query_op), "%s",
+                 QUERY_OP == QUERY_AT_LEAST ? "ge" : "le");
+
+        Result answer = (QUERY_OP == QUERY_AT_LEAST)
+            ? solve_endgame_at_least(player, opponent, num_threads, time_limit,
+                                     &best_move, use_evaluation, QUERY_K)
+            : solve_endgame_at_most(player, opponent, num_threads, time_limit,
+                                    &best_move, use_evaluation, QUERY_K);
+
+        printf("\n--- FINAL RESULT ---\n");
+        printf("Query: score %s %+d ? %s\n", QUERY_OP == QUERY_AT_LEAST ? ">=" : "<=", QUERY_K,
+               answer == RESULT_EXACT_WIN ? "YES" : (answer == RESULT_EXACT_LOSE ? "NO" : "UNKNOWN"));
+        if (answer == RESULT_EXACT_WIN && QUERY_OP == QUERY_AT_LEAST && best_move >= 0 && best_move < 64) {
+            printf("Best move: %c%d\n", 'a' + (best_move % 8), 8 - (best_move / 8));
+        }
+        print_pv_and_proof();
+        printf("══════════════════\n\n");
+
+        free_evaluation_weights();
+        debug_close();
+        return 0;
+    }
+
+    if (EXACT_MODE) {
+        int best_move, lower, upper;
+        Result result = solve_endgame_exact(player, opponent, num_threads, time_limit,
+                                            &best_move, use_evaluation, EXACT_GROUPS,
+                                            &lower, &upper);
+
+        printf("\n--- FINAL RESULT ---\n");
+        printf("Result: ");
+        switch (result) {
+            case RESULT_EXACT_WIN:  printf("WIN\n"); break;
+            case RESULT_EXACT_LOSE: printf("LOSE\n"); break;
+            case RESULT_EXACT_DRAW: printf("DRAW\n"); break;
+            default: printf("UNKNOWN\n");
+        }
+        if (lower == upper) {
+            printf("Score: %+d\n", lower);
+        } else {
+            printf("Score: [%+d, %+d] (not determined)\n", lower, upper);
+        }
+        if (best_move >= 0 && best_move < 64) {
+            printf("Best move: %c%d\n", 'a' + (best_move % 8), 8 - (best_move / 8));
+        }
+        print_pv_and_proof();
+
+        printf("\nThresholds (%d groups, %d rounds):\n",
+               g_benchmark_result.exact_groups, g_benchmark_result.exact_rounds);
+        printf("  %-5s %-6s %-10s %-8s %-14s %s\n", "Round", "Target", "Result", "Threads", "Nodes", "Time");
+        for (int q = 0; q < g_benchmark_result.n_exact_queries; q++) {
+            const ExactQueryStat *st = &g_benchmark_result.exact_queries[q];
+            printf("  %-5d >=%+-4d %-10s %-8d %-14llu %.3fs\n", st->round, st->target,
+                   st->cancelled ? "cancelled" :
+                   (strcmp(st->result, "ge") == 0 ? "yes" :
+                   (strcmp(st->result, "lt") == 0 ? "no" : "unknown")),
+                   st->threads, (unsigned long long)st->nodes, st->time_sec);
+        }
+        printf("══════════════════\n\n");
+
+        free_evaluation_weights();
+        debug_close();
+        return 0;
+    }
+
     int best_move;
     Result result = solve_endgame(
         player,
@@ -4817,6 +10415,7 @@ int main(int argc, char *argv[]) {
                 'a' + (best_move % 8),
                 8 - (best_move / 8));
     }
+    print_pv_and_proof();
     printf("══════════════════\n\n");
 
     // Cleanup
@@ -4826,3 +10425,293 @@ int main(int argc, char *argv[]) {
     return 0;
 }
 #endif // STANDALONE_MAIN
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Evaluation kernel microbenchmark (-DEVAL_BENCH_MAIN)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// 評価カーネルごとの評価数/秒を測る単体ベンチマーク（ソルバー本体とは別の main）:
+//   gcc -O2 -march=native -DEVAL_BENCH_MAIN -o eval_bench othello_endgame_solver_hybrid_check_tthit_fixed.c -lm -lpthread
+//   ./eval_bench [eval.dat] [局面数] [繰り返し回数]
+// 初期局面からのランダムな対局で局面を作り、各カーネルの値がスカラー版と一致するかを確かめてから、
+// 全局面を繰り返し評価する。incremental-* は増分評価の表引き部分（eval_features_score）だけの速さ。
+// batch-* は EVAL_BENCH_BATCH 個ずつ evaluate_positions でまとめて評価する（--eval-batch の経路）。
+#ifdef EVAL_BENCH_MAIN
+#ifdef STANDALONE_MAIN
+#error "EVAL_BENCH_MAIN and STANDALONE_MAIN both define main()"
+#endif
+
+#define EVAL_BENCH_BATCH 10         // まとめ評価の1回の局面数（中盤の平均的な合法手の数）
+
+static double eval_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    const char *eval_path = (argc > 1) ? argv[1] : "eval/eval.dat";
+    int n_positions = (argc > 2) ? atoi(argv[2]) : 100000;
+    int repeats = (argc > 3) ? atoi(argv[3]) : 20;
+    if (n_positions <= 0 || repeats <= 0) {
+        fprintf(stderr, "Usage: %s [eval.dat] [positions] [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    check_cpu_features();
+    if (!load_evaluation_weights(eval_path)) {
+        fprintf(stderr, "Error: cannot load %s\n", eval_path);
+        return 1;
+    }
+
+    // ランダムな対局から、空きマス 4〜59 の局面を集める
+    uint64_t *pl = malloc(n_positions * sizeof(uint64_t));
+    uint64_t *op = malloc(n_positions * sizeof(uint64_t));
+    EvalFeatures *feat = malloc(n_positions * sizeof(EvalFeatures));
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    int n = 0;
+    while (n < n_positions) {
+        uint64_t p = 0x0000000810000000ULL, o = 0x0000001008000000ULL;
+        for (;;) {
+            uint64_t moves = get_moves(p, o);
+            if (moves == 0) {
+                if (get_moves(o, p) == 0) break;
+                uint64_t t = p; p = o; o = t;
+                continue;
+            }
+            rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+            int k = (int)(rng % (uint64_t)popcount(moves));
+            while (k-- > 0) moves &= moves - 1;
+            make_move(&p, &o, first_one(moves));
+            int empties = popcount(~(p | o));
+            if (empties < 4) break;
+            if (n < n_positions && (rng >> 32) % 4 == 0) {
+                pl[n] = p;
+                op[n] = o;
+                eval_features_set(&feat[n], p, o);
+                n++;
+            }
+        }
+    }
+
+    struct {
+        EvalKernel kernel;
+        bool incremental;
+        bool batch;
+        const char *name;
+    } runs[] = {
+        {EVAL_KERNEL_SCALAR,        false, false, "scalar"},
+        {EVAL_KERNEL_AVX2,          false, false, "avx2"},
+        {EVAL_KERNEL_AVX2_GATHER,   false, false, "avx2-gather"},
+        {EVAL_KERNEL_AVX512_GATHER, false, false, "avx512-gather"},
+        {EVAL_KERNEL_AVX2_GATHER,   false, true,  "batch-avx2-gather"},
+        {EVAL_KERNEL_AVX512_GATHER, false, true,  "batch-avx512-gather"},
+        {EVAL_KERNEL_SCALAR,        true,  false, "incremental-scalar"},
+        {EVAL_KERNEL_AVX2_GATHER,   true,  false, "incremental-avx2-gather"},
+        {EVAL_KERNEL_AVX512_GATHER, true,  false, "incremental-avx512-gather"},
+    };
+    int *batch_out = malloc(n_positions * sizeof(int));
+
+    printf("positions: %d, repeats: %d\n", n_positions, repeats);
+    printf("%-28s %14s %10s %10s\n", "kernel", "evals/sec", "vs_scalar", "mismatch");
+    double scalar_rate = 0;
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        if (!eval_kernel_supported(runs[r].kernel)) {
+            printf("%-28s %14s\n", runs[r].name, "n/a");
+            continue;
+        }
+        EVAL_KERNEL = runs[r].kernel;
+
+        int mismatches = 0;
+        if (runs[r].batch) {
+            for (int i = 0; i < n; i += EVAL_BENCH_BATCH) {
+                int m = (n - i < EVAL_BENCH_BATCH) ? n - i : EVAL_BENCH_BATCH;
+                evaluate_positions(&pl[i], &op[i], m, &batch_out[i]);
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            int expected = evaluate_position_scalar(pl[i], op[i]);
+            int got = runs[r].batch ? batch_out[i]
+                    : runs[r].incremental ? eval_features_score(feat[i].f[0], popcount(~(pl[i] | op[i])))
+                                          : evaluate_position(pl[i], op[i]);
+            if (got != expected) mismatches++;
+        }
+
+        volatile int sink = 0;
+        double t0 = eval_bench_now();
+        for (int k = 0; k < repeats; k++) {
+            int acc = 0;
+            if (runs[r].batch) {
+                for (int i = 0; i < n; i += EVAL_BENCH_BATCH) {
+                    int m = (n - i < EVAL_BENCH_BATCH) ? n - i : EVAL_BENCH_BATCH;
+                    evaluate_positions(&pl[i], &op[i], m, &batch_out[i]);
+                    acc += batch_out[i];
+                }
+            } else if (runs[r].incremental) {
+                for (int i = 0; i < n; i++) acc += eval_features_score(feat[i].f[0], popcount(~(pl[i] | op[i])));
+            } else {
+                for (int i = 0; i < n; i++) acc += evaluate_position(pl[i], op[i]);
+            }
+            sink += acc;
+        }
+        double elapsed = eval_bench_now() - t0;
+        (void)sink;
+
+        double rate = (double)n * repeats / elapsed;
+        if (r == 0) scalar_rate = rate;
+        printf("%-28s %14.0f %10.2f %10d\n", runs[r].name, rate, scalar_rate > 0 ? rate / scalar_rate : 0.0, mismatches);
+    }
+
+    free(pl);
+    free(op);
+    free(feat);
+    free(batch_out);
+    free_evaluation_weights();
+    return 0;
+}
+#endif // EVAL_BENCH_MAIN
+
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+// Chunk queue contention microbenchmark (-DQUEUE_BENCH_MAIN)
+// ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━
+//
+// GlobalChunkQueue（1つの mutex のヒープ）と MultiQueue（--queues multiqueue）の
+// push/pop のスループットを、スレッド数を変えて測る単体ベンチマーク（ソルバー本体とは別の main）:
+//   gcc -O2 -march=native -DQUEUE_BENCH_MAIN -o queue_bench othello_endgame_solver_hybrid_check_tthit_fixed.c -lm -lpthread
+//   ./queue_bench [スレッドあたりのpush+pop回数] [c] [スレッド数...]   （既定: 20000 2 128 384 768）
+// 各スレッドは乱数の優先度のチャンクを1つ入れて1つ取り出すのを繰り返す（キューの長さはほぼ一定）。
+// 時間は最初のスレッドが始めてから最後のスレッドが終わるまで。
+#ifdef QUEUE_BENCH_MAIN
+#if defined(STANDALONE_MAIN) || defined(EVAL_BENCH_MAIN)
+#error "QUEUE_BENCH_MAIN and STANDALONE_MAIN/EVAL_BENCH_MAIN both define main()"
+#endif
+
+#define QUEUE_BENCH_PREFILL 4           // 開始前にスレッドあたり入れておくチャンク数
+
+typedef struct {
+    GlobalChunkQueue *gq;               // flat（mq が NULL のとき）
+    ChunkMultiQueue *mq;
+    pthread_barrier_t *start;
+    int ops;
+    uint64_t rng;
+    uint64_t lock_fails;
+    uint64_t empty_pops;                // 取り出せなかった回数（キューは空でない）
+    double start_time;
+    double end_time;
+} QueueBenchThread;
+
+static double queue_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool queue_bench_push(QueueBenchThread *t, Chunk *chunk) {
+    chunk->top_priority = (int)(mq_random(&t->rng) % 1000000);
+    chunk->tasks[0].priority = chunk->top_priority;
+    return t->mq ? chunk_mq_push(t->mq, chunk, &t->rng, &t->lock_fails)
+                 : global_chunk_queue_push(t->gq, chunk);
+}
+
+static void *queue_bench_thread(void *arg) {
+    QueueBenchThread *t = arg;
+    Chunk chunk = {.count = 1};
+    Chunk out;
+
+    pthread_barrier_wait(t->start);
+    t->start_time = queue_bench_now();
+    for (int i = 0; i < t->ops; i++) {
+        queue_bench_push(t, &chunk);
+        bool ok = t->mq ? chunk_mq_pop(t->mq, &out, &t->rng, &t->lock_fails)
+                        : global_chunk_queue_pop(t->gq, &out);
+        if (!ok) t->empty_pops++;
+    }
+    t->end_time = queue_bench_now();
+    return NULL;
+}
+
+// n_threads スレッドで1回測る（mq_c == 0 なら flat）。push+pop の回数/秒を返す
+static double queue_bench_run(int n_threads, int ops, int mq_c, QueueBenchThread *threads) {
+    GlobalChunkQueue *gq = NULL;
+    ChunkMultiQueue *mq = NULL;
+    if (mq_c > 0) {
+        mq = chunk_mq_create(mq_c * n_threads);
+    } else {
+        gq = global_chunk_queue_create();
+    }
+
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, n_threads + 1);
+    pthread_t *tids = malloc(n_threads * sizeof(pthread_t));
+    for (int i = 0; i < n_threads; i++) {
+        threads[i] = (QueueBenchThread){
+            .gq = gq, .mq = mq, .start = &start, .ops = ops,
+            .rng = 0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1),
+        };
+        Chunk chunk = {.count = 1};
+        for (int k = 0; k < QUEUE_BENCH_PREFILL; k++) queue_bench_push(&threads[i], &chunk);
+        threads[i].lock_fails = 0;
+    }
+    for (int i = 0; i < n_threads; i++) {
+        pthread_create(&tids[i], NULL, queue_bench_thread, &threads[i]);
+    }
+
+    pthread_barrier_wait(&start);
+    for (int i = 0; i < n_threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    double t0 = threads[0].start_time, t1 = threads[0].end_time;
+    for (int i = 1; i < n_threads; i++) {
+        if (threads[i].start_time < t0) t0 = threads[i].start_time;
+        if (threads[i].end_time > t1) t1 = threads[i].end_time;
+    }
+    double elapsed = t1 - t0;
+
+    pthread_barrier_destroy(&start);
+    free(tids);
+    chunk_mq_destroy(mq);
+    global_chunk_queue_destroy(gq);
+    return (double)n_threads * ops / elapsed;
+}
+
+int main(int argc, char *argv[]) {
+    int ops = (argc > 1) ? atoi(argv[1]) : 20000;
+    int mq_c = (argc > 2) ? atoi(argv[2]) : DEFAULT_MQ_C;
+    int default_threads[] = {128, 384, 768};
+    int n_counts = (argc > 3) ? argc - 3 : 3;
+    if (ops <= 0 || mq_c < 1) {
+        fprintf(stderr, "Usage: %s [ops/thread] [c] [threads...]\n", argv[0]);
+        return 1;
+    }
+
+    printf("ops/thread: %d (push+pop), c: %d, sub-heap capacity: %d chunks\n", ops, mq_c, MQ_HEAP_CAPACITY);
+    printf("%-8s %-12s %14s %10s %12s %12s\n",
+           "threads", "queue", "ops/sec", "vs_flat", "lock_fail%", "empty_pop%");
+    for (int c = 0; c < n_counts; c++) {
+        int n_threads = (argc > 3) ? atoi(argv[3 + c]) : default_threads[c];
+        if (n_threads <= 0) continue;
+        QueueBenchThread *threads = calloc(n_threads, sizeof(QueueBenchThread));
+
+        double flat_rate = 0;
+        for (int run = 0; run < 2; run++) {
+            bool multiqueue = (run == 1);
+            double rate = queue_bench_run(n_threads, ops, multiqueue ? mq_c : 0, threads);
+            if (!multiqueue) flat_rate = rate;
+
+            uint64_t lock_fails = 0, empty_pops = 0;
+            for (int i = 0; i < n_threads; i++) {
+                lock_fails += threads[i].lock_fails;
+                empty_pops += threads[i].empty_pops;
+            }
+            // lock_fail% は push と pop の呼び出し回数あたり（flat はロックを待つので 0）
+            printf("%-8d %-12s %14.0f %10.2f %12.2f %12.2f\n",
+                   n_threads, multiqueue ? "multiqueue" : "flat", rate,
+                   flat_rate > 0 ? rate / flat_rate : 0.0,
+                   100.0 * lock_fails / (2.0 * n_threads * ops),
+                   100.0 * empty_pops / ((double)n_threads * ops));
+        }
+        free(threads);
+    }
+    return 0;
+}
+#endif // QUEUE_BENCH_MAIN